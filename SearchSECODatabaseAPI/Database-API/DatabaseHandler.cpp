@@ -30,6 +30,13 @@ void DatabaseHandler::setPreparedStatements()
 	selectPrevProject =
 		DatabaseUtility::prepareStatement(connection, "SELECT * FROM projectData.projects WHERE projectID = ? LIMIT 1");
 
+	// Prepare the same two queries without the hashes of the projects, which are by far the largest column.
+	selectProjectMetadata = DatabaseUtility::prepareStatement(
+		connection,
+		"SELECT " PROJECT_METADATA_COLUMNS " FROM projectData.projects WHERE projectID = ? AND versiontime = ?");
+	selectPrevProjectMetadata = DatabaseUtility::prepareStatement(
+		connection, "SELECT " PROJECT_METADATA_COLUMNS " FROM projectData.projects WHERE projectID = ? LIMIT 1");
+
 	// Prepare query used to insert a project into the database.
 	insertProject = DatabaseUtility::prepareStatement(
 		connection, "INSERT INTO projectData.projects (projectID, versiontime, versionhash, license, "
@@ -13,6 +13,9 @@ Utrecht University within the Software Project course.
 #define IP "cassandra"
 #define DBPORT 8002
 #define HASHES_INSERT_MAX 1000
+#define METHODS_PAGE_SIZE 1000
+#define METHODS_PAGE_SIZE_MAX 10000
+#define PROJECT_METADATA_COLUMNS "projectID, versiontime, versionHash, license, name, url, ownerid, parserversion"
 
 using namespace types;
 
@@ -34,35 +37,41 @@ public:
 	/// </summary>
 	/// <param name="project"> The project to be added to the database. </param>
 	/// <returns> A boolean value indicating if adding the project was successful. </returns>
-	virtual bool addProject(ProjectIn project);
+	virtual bool addProject(const ProjectIn &project);
 
 	/// <summary>
 	/// Adds a number of hashes to a project in the database, starting at some index.
 	/// </summary>
 	/// <param name="project"> The project from which the hashes should be added to the database. </param>
 	/// <param name="index"> The starting index of the hashes which should be added to the database. </param>
-	virtual void addHashToProject(ProjectIn project, int index);
+	virtual void addHashToProject(const ProjectIn &project, int index);
 
 	/// <summary>
 	/// Searches for a project in the database and returns it to the user if it exists.
 	/// </summary>
 	/// <param name="projectID"> The projectID of the project to be searched for. </param>
 	/// <param name="version"> The version of the project to be searched for. </param>
+	/// <param name="withHashes">
+	/// Whether the hashes of the project should be retrieved. If not, they are not read from the database at all.
+	/// </param>
 	/// <returns>
 	/// Returns the project corresponding to the input, if it exists.
 	/// If no entry can be found, simply returns an empty project and sets the errno to ERANGE.
 	/// </returns>
-	virtual ProjectOut searchForProject(ProjectID projectID, Version version);
+	virtual ProjectOut searchForProject(ProjectID projectID, Version version, bool withHashes);
 
 	/// <summary>
 	/// Retrieves the previous/latest version of the project present in the database.
 	/// </summary>
 	/// <param name="projectID"> The projectID of the project to be searched for. </param>
+	/// <param name="withHashes">
+	/// Whether the hashes of the project should be retrieved. If not, they are not read from the database at all.
+	/// </param>
 	/// <returns>
 	/// If present, returns the previous/latest version of a project with the same projectID.
 	/// Else, sets the errno to ERANGE and returns an empty project.
 	/// </returns>
-	virtual ProjectOut prevProject(ProjectID projectID);
+	virtual ProjectOut prevProject(ProjectID projectID, bool withHashes);
 
 	/// <summary>
 	/// Adds/updates a method to the tables methods and method_by_author. Takes in a method and a project
@@ -73,8 +82,15 @@ public:
 	/// <param name="prevVersion"> The previous version of the project. </param>
 	/// <param name="parserVersion"> The version of the parser. </param>
 	/// <param name="newProject"> Indication of the project being new or updated based on a previous version. </param>
-	virtual void addMethod(MethodIn method, ProjectIn project, long long prevVersion, long long parserVersion,
-						   bool newProject);
+	virtual void addMethod(const MethodIn &method, const ProjectIn &project, long long prevVersion,
+						   long long parserVersion, bool newProject);
+
+	/// <summary>
+	/// Adds authors to the table authors, so the methods of an upload can refer to them by ID.
+	/// Sets errno to ENETUNREACH if one of them could not be added.
+	/// </summary>
+	/// <param name="authors"> The distinct authors of the methods to be added. </param>
+	virtual void addAuthors(const std::vector<Author> &authors);
 
 	/// <summary>
 	/// Updates the methods in the previous version of the project that are part of an unchanged file.
@@ -84,40 +100,55 @@ public:
 	/// <param name="project"> The added project for the projectID and new version. </param>
 	/// <param name="prevVersion"> The previous version of the project to check whether it is a correct result. </param>
 	/// <returns> A list of hashes that are updated. </returns>
-	virtual std::vector<Hash> updateUnchangedFiles(std::vector<Hash> hashes, std::vector<std::string> files,
-												   ProjectIn project, long long prevVersion);
+	virtual std::vector<Hash> updateUnchangedFiles(const std::vector<Hash> &hashes,
+												   const std::vector<std::string> &files, const ProjectIn &project,
+												   long long prevVersion);
 
 	/// <summary>
 	/// Retrieves all methods with a given hash.
 	/// </summary>
 	/// <param name="hash"> The hash to be checked. </param>
 	/// <returns> All methods with the inputted hash. </returns>
-	virtual std::vector<MethodOut> hashToMethods(std::string hash);
+	virtual std::vector<MethodOut> hashToMethods(Hash hash);
 
 	/// <summary>
 	/// Retrieves an author given its authorID.
 	/// </summary>
 	/// <param name="id"> A string with the ID to be checked. </param>
 	/// <returns> The author corresponding to the given ID. </returns>
-	virtual Author idToAuthor(std::string id);
+	virtual Author idToAuthor(const Hash &id);
 
 	/// <summary>
 	/// Retrieves the methods created by an author given its authorID.
 	/// </summary>
 	/// <param name="authorID"> The ID of the author to retrieve the methods for. </param>
 	/// <returns> A vector with the necessary information of the methods the author has worked on. </returns>
-	virtual std::vector<MethodID> authorToMethods(std::string authorID);
+	virtual std::vector<MethodID> authorToMethods(const Hash &authorID);
+
+	/// <summary>
+	/// Retrieves one page of the methods created by an author, using the paging state of the driver to continue
+	/// where the previous page ended.
+	/// </summary>
+	/// <param name="authorID"> The ID of the author to retrieve the methods for. </param>
+	/// <param name="pageSize"> The maximum number of methods in the page. </param>
+	/// <param name="pagingState">
+	/// The paging state after the previous page, or empty for the first page. If the page is retrieved, it is set to
+	/// the paging state after this page, or emptied if this was the last page.
+	/// </param>
+	/// <returns> A vector with the necessary information of the methods in the page. </returns>
+	virtual std::vector<MethodID> authorToMethodsPage(const Hash &authorID, int pageSize, std::string &pagingState);
 
 private:
 	/// <summary>
 	/// Add a method to the method_by_author table.
 	/// </summary>
-	void addMethodByAuthor(CassUuid authorID, MethodIn method, ProjectIn project);
+	void addMethodByAuthor(CassUuid authorID, const MethodIn &method, const ProjectIn &project);
 
 	/// <summary>
 	/// Parses a row into a project. Takes a row as input and outputs a project.
+	/// The hashes are only parsed if they were selected.
 	/// </summary>
-	ProjectOut getProject(const CassRow *row);
+	ProjectOut getProject(const CassRow *row, bool withHashes);
 
 	/// <summary>
 	/// Parses a row into a method. Takes a row as input and outputs a method.
@@ -135,7 +166,7 @@ private:
 	/// <param name="method"> The method to be inputted into the database. </param>
 	/// <param name="project"> The project in which the method is located. </param>
 	/// <param name="parserVersion"> The version of the parser. </param>
-	void addNewMethod(MethodIn method, ProjectIn project, long long parserVersion);
+	void addNewMethod(const MethodIn &method, const ProjectIn &project, long long parserVersion);
 
 	/// <summary>
 	/// A function that is used to update methods that were already in the database.
@@ -144,7 +175,7 @@ private:
 	/// <param name="method"> The method to be updated. </param>
 	/// <param name="project"> The project in which the method is located. </param>
 	/// <param name="startVersion"> The startVersionTime of the method to be updated. </param>
-	void updateMethod(MethodIn method, ProjectIn project, long long startVersion);
+	void updateMethod(const MethodIn &method, const ProjectIn &project, long long startVersion);
 
 	/// <summary>
 	/// Handles the result obtained by performing the select method query.
@@ -155,7 +186,7 @@ private:
 	/// <param name="prevVersion"> The previous version of the project. </param>
 	/// <param name="parserVersion"> The version of the parser. </param>
 	/// <param name="newProject"> Indication if the project is new or not. </param>
-	void handleSelectMethodQueryResult(CassFuture *queryFuture, MethodIn method, ProjectIn project,
+	void handleSelectMethodQueryResult(CassFuture *queryFuture, const MethodIn &method, const ProjectIn &project,
 									   long long prevVersion, long long parserVersion, bool &newProject);
 
 	/// <summary>
@@ -165,7 +196,7 @@ private:
 	/// <param name="project"> The updated version of a project that has to be added. </param>
 	/// <param name="prevVersion"> The previous version of the project. </param>
 	/// <returns> Returns the hashes corresponding to unchanged methods. </returns>
-	std::vector<Hash> handleSelectUnchangedMethodsResult(CassFuture *queryFuture, ProjectIn project,
+	std::vector<Hash> handleSelectUnchangedMethodsResult(CassFuture *queryFuture, const ProjectIn &project,
 														 long long prevVersion);
 
 	/// <summary>
@@ -175,15 +206,8 @@ private:
 	/// <param name="files"> The files to be checked for to select unchanged methods. </param>
 	/// <param name="project"> The updated version of a project. </param>
 	/// <returns> An executed query. </returns>
-	CassFuture *executeSelectUnchangedMethodsQuery(std::vector<Hash> hashes, std::vector<std::string> files,
-												   ProjectIn project);
-	/// <summary>
-	/// Creates a new author and adds it to the database.
-	/// </summary>
-	/// <param name="author"> Author to be added to the database (if it does not exist already). </param>
-	/// <returns> The corresponding UUID. </returns>
-	CassUuid createAuthorIfNotExists(Author author);
-
+	CassFuture *executeSelectUnchangedMethodsQuery(const std::vector<Hash> &hashes,
+												   const std::vector<std::string> &files, const ProjectIn &project);
 	/// <summary>
 	/// Create the prepared statements to be executed later.
 	/// </summary>
@@ -200,6 +224,8 @@ private:
 	const CassPrepared *selectMethods;
 	const CassPrepared *selectProject;
 	const CassPrepared *selectPrevProject;
+	const CassPrepared *selectProjectMetadata;
+	const CassPrepared *selectPrevProjectMetadata;
 	const CassPrepared *insertProject;
 	const CassPrepared *addHashesToProject;
 	const CassPrepared *insertMethod;
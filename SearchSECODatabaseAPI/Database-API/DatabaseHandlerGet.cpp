@@ -12,10 +12,10 @@ Utrecht University within the Software Project course.
 #include <string>
 #include <unistd.h>
 
-ProjectOut DatabaseHandler::searchForProject(ProjectID projectID, Version version)
+ProjectOut DatabaseHandler::searchForProject(ProjectID projectID, Version version, bool withHashes)
 {
 	errno = 0;
-	CassStatement *query = cass_prepared_bind(selectProject);
+	CassStatement *query = cass_prepared_bind(withHashes ? selectProject : selectProjectMetadata);
 
 	// Bind the variables in the statement.
 	cass_statement_bind_int64_by_name(query, "projectID", projectID);
@@ -29,7 +29,7 @@ ProjectOut DatabaseHandler::searchForProject(ProjectID projectID, Version versio
 		if (cass_result_row_count(result) >= 1)
 		{
 			const CassRow *row = cass_result_first_row(result);
-			project = getProject(row);
+			project = getProject(row, withHashes);
 		}
 		else
 		{
@@ -55,15 +55,14 @@ ProjectOut DatabaseHandler::searchForProject(ProjectID projectID, Version versio
 	return project;
 }
 
-std::vector<MethodOut> DatabaseHandler::hashToMethods(std::string hash)
+std::vector<MethodOut> DatabaseHandler::hashToMethods(Hash hash)
 {
 	errno = 0;
 	CassStatement *query = cass_prepared_bind(selectMethods);
 	cass_statement_set_consistency(query, CASS_CONSISTENCY_LOCAL_ONE);
 
 	// To bind the hash as a UUID in the query, we have to convert it to a UUID first.
-	CassUuid uuid;
-	cass_uuid_from_string(Utility::hashToUUIDString(hash).c_str(), &uuid);
+	CassUuid uuid = DatabaseUtility::hashToUuid(hash);
 	cass_statement_bind_uuid_by_name(query, "method_hash", uuid);
 
 	CassFuture *resultFuture = cass_session_execute(connection, query);
@@ -101,9 +100,9 @@ std::vector<MethodOut> DatabaseHandler::hashToMethods(std::string hash)
 	return methods;
 }
 
-ProjectOut DatabaseHandler::prevProject(ProjectID projectID)
+ProjectOut DatabaseHandler::prevProject(ProjectID projectID, bool withHashes)
 {
-	CassStatement *query = cass_prepared_bind(selectPrevProject);
+	CassStatement *query = cass_prepared_bind(withHashes ? selectPrevProject : selectPrevProjectMetadata);
 	cass_statement_bind_int64_by_name(query, "projectID", projectID);
 
 	CassFuture *resultFuture = cass_session_execute(connection, query);
@@ -117,7 +116,7 @@ ProjectOut DatabaseHandler::prevProject(ProjectID projectID)
 		if (cass_result_row_count(result) >= 1)
 		{
 			const CassRow *row = cass_result_first_row(result);
-			project = getProject(row);
+			project = getProject(row, withHashes);
 		}
 
 		cass_result_free(result);
@@ -138,15 +137,13 @@ ProjectOut DatabaseHandler::prevProject(ProjectID projectID)
 	return project;
 }
 
-std::vector<MethodID> DatabaseHandler::authorToMethods(std::string authorID)
+std::vector<MethodID> DatabaseHandler::authorToMethods(const Hash &authorID)
 {
 	errno = 0;
 	CassStatement *query = cass_prepared_bind(selectMethodByAuthor);
 	cass_statement_set_consistency(query, CASS_CONSISTENCY_LOCAL_ONE);
 
-	CassUuid uuid;
-	cass_uuid_from_string(authorID.c_str(), &uuid);
-	cass_statement_bind_uuid_by_name(query, "authorid", uuid);
+	cass_statement_bind_uuid_by_name(query, "authorid", DatabaseUtility::hashToUuid(authorID));
 
 	CassFuture *resultFuture = cass_session_execute(connection, query);
 
@@ -183,30 +180,50 @@ std::vector<MethodID> DatabaseHandler::authorToMethods(std::string authorID)
 	return methods;
 }
 
-Author DatabaseHandler::idToAuthor(std::string id)
+std::vector<MethodID> DatabaseHandler::authorToMethodsPage(const Hash &authorID, int pageSize,
+															std::string &pagingState)
 {
 	errno = 0;
-	CassStatement *query = cass_prepared_bind(selectAuthorByID);
+	CassStatement *query = cass_prepared_bind(selectMethodByAuthor);
 	cass_statement_set_consistency(query, CASS_CONSISTENCY_LOCAL_ONE);
+	cass_statement_set_paging_size(query, pageSize);
+	if (!pagingState.empty())
+	{
+		cass_statement_set_paging_state_token(query, pagingState.data(), pagingState.size());
+	}
 
-	CassUuid uuid;
-	cass_uuid_from_string(id.c_str(), &uuid);
-	cass_statement_bind_uuid_by_name(query, "authorid", uuid);
+	cass_statement_bind_uuid_by_name(query, "authorid", DatabaseUtility::hashToUuid(authorID));
 
 	CassFuture *resultFuture = cass_session_execute(connection, query);
 
-	Author author("", "");
+	std::vector<MethodID> methods;
 
 	if (cass_future_error_code(resultFuture) == CASS_OK)
 	{
 		const CassResult *result = cass_future_get_result(resultFuture);
+		CassIterator *iterator = cass_iterator_from_result(result);
 
-		if (cass_result_row_count(result) >= 1)
+		// Add matches to result list.
+		while (cass_iterator_next(iterator))
 		{
-			const CassRow *row = cass_result_first_row(result);
-			author = Author(DatabaseUtility::getString(row, "name"), DatabaseUtility::getString(row, "mail"));
+			const CassRow *row = cass_iterator_get_row(iterator);
+			methods.push_back(getMethodID(row));
 		}
 
+		// The paging state is only changed once the page is retrieved, so a retry asks for the same page.
+		const char *token = nullptr;
+		size_t tokenLength = 0;
+		if (cass_result_has_more_pages(result) &&
+			cass_result_paging_state_token(result, &token, &tokenLength) == CASS_OK && token != nullptr)
+		{
+			pagingState.assign(token, tokenLength);
+		}
+		else
+		{
+			pagingState.clear();
+		}
+
+		cass_iterator_free(iterator);
 		cass_result_free(result);
 	}
 	else
@@ -215,36 +232,57 @@ Author DatabaseHandler::idToAuthor(std::string id)
 		const char *message;
 		size_t messageLength;
 		cass_future_error_message(resultFuture, &message, &messageLength);
-		fprintf(stderr, "Unable to retrieve the author: '%.*s'\n", (int)messageLength, message);
+		fprintf(stderr, "Unable to obtain a page of the methods by the author: '%.*s'\n", (int)messageLength, message);
 		errno = ENETUNREACH;
 	}
 
 	cass_statement_free(query);
 	cass_future_free(resultFuture);
 
-	return author;
+	return methods;
 }
 
-CassUuid DatabaseHandler::createAuthorIfNotExists(Author author)
+Author DatabaseHandler::idToAuthor(const Hash &id)
 {
-	CassUuid authorID;
-	cass_uuid_from_string(Utility::hashToUUIDString(author.id).c_str(), &authorID);
+	errno = 0;
+	CassStatement *query = cass_prepared_bind(selectAuthorByID);
+	cass_statement_set_consistency(query, CASS_CONSISTENCY_LOCAL_ONE);
 
-	CassStatement *query = cass_prepared_bind(insertAuthorByID);
+	cass_statement_bind_uuid_by_name(query, "authorid", DatabaseUtility::hashToUuid(id));
 
-	// Bind the variables in the statement.
-	cass_statement_bind_uuid_by_name(query, "authorID", authorID);
-	cass_statement_bind_string_by_name(query, "name", author.name.c_str());
-	cass_statement_bind_string_by_name(query, "mail", author.mail.c_str());
+	CassFuture *resultFuture = cass_session_execute(connection, query);
 
-	cass_session_execute(connection, query);
+	Author author("", "");
+
+	if (cass_future_error_code(resultFuture) == CASS_OK)
+	{
+		const CassResult *result = cass_future_get_result(resultFuture);
+
+		if (cass_result_row_count(result) >= 1)
+		{
+			const CassRow *row = cass_result_first_row(result);
+			author = Author(DatabaseUtility::getString(row, "name"), DatabaseUtility::getString(row, "mail"));
+		}
+
+		cass_result_free(result);
+	}
+	else
+	{
+		// An error occurred which is handled below.
+		const char *message;
+		size_t messageLength;
+		cass_future_error_message(resultFuture, &message, &messageLength);
+		fprintf(stderr, "Unable to retrieve the author: '%.*s'\n", (int)messageLength, message);
+		errno = ENETUNREACH;
+	}
 
 	cass_statement_free(query);
+	cass_future_free(resultFuture);
 
-	return authorID;
+	return author;
 }
 
-ProjectOut DatabaseHandler::getProject(const CassRow *row)
+ProjectOut DatabaseHandler::getProject(const CassRow *row, bool withHashes)
 {
 	ProjectOut project;
 
@@ -258,6 +296,11 @@ ProjectOut DatabaseHandler::getProject(const CassRow *row)
 	project.ownerID = DatabaseUtility::getUUID(row, "ownerid");
 	project.parserVersion = DatabaseUtility::getInt64(row, "parserversion");
 
+	if (!withHashes)
+	{
+		return project;
+	}
+
 	const CassValue *set = cass_row_get_column_by_name(row, "hashes");
 	CassIterator *iterator = cass_iterator_from_collection(set);
 
@@ -266,12 +309,10 @@ ProjectOut DatabaseHandler::getProject(const CassRow *row)
 		// Retrieve the hashes one by one.
 		while (cass_iterator_next(iterator))
 		{
-			char hash[CASS_UUID_STRING_LENGTH];
 			CassUuid uuid;
 			const CassValue *id = cass_iterator_get_value(iterator);
 			cass_value_get_uuid(id, &uuid);
-			cass_uuid_string(uuid, hash);
-			project.hashes.push_back(Utility::uuidStringToHash(hash));
+			project.hashes.push_back(DatabaseUtility::uuidToHash(uuid));
 		}
 	}
 
@@ -285,7 +326,7 @@ MethodOut DatabaseHandler::getMethod(const CassRow *row)
 	MethodOut method;
 
 	// Retrieve the values of the variables in the row.
-	method.hash = Utility::uuidStringToHash(DatabaseUtility::getUUID(row, "method_hash"));
+	method.hash = DatabaseUtility::getHash(row, "method_hash");
 	method.methodName = DatabaseUtility::getString(row, "name");
 	method.fileLocation = DatabaseUtility::getString(row, "file");
 	method.lineNumber = DatabaseUtility::getInt32(row, "lineNumber");
@@ -298,7 +339,7 @@ MethodOut DatabaseHandler::getMethod(const CassRow *row)
 	method.vulnCode = DatabaseUtility::getString(row, "vulncode");
 	
 	//fetch license of project from method.projectID
-	ProjectOut project = DatabaseHandler::searchForProject(method.projectID,method.endVersion);
+	ProjectOut project = DatabaseHandler::searchForProject(method.projectID, method.endVersion, false);
 	method.license = project.license;
 
 	
@@ -328,7 +369,7 @@ MethodID DatabaseHandler::getMethodID(const CassRow *row)
 	MethodID method;
 
 	// Retrieve the values of the variables in the row.
-	method.hash = Utility::uuidStringToHash(DatabaseUtility::getUUID(row, "hash"));
+	method.hash = DatabaseUtility::getHash(row, "hash");
 	method.projectID = DatabaseUtility::getInt64(row, "projectid");
 	method.startVersion = DatabaseUtility::getInt64(row, "startversiontime");
 	method.fileLocation = DatabaseUtility::getString(row, "file");
@@ -12,7 +12,7 @@ Utrecht University within the Software Project course.
 #include <string>
 #include <unistd.h>
 
-bool DatabaseHandler::addProject(ProjectIn project)
+bool DatabaseHandler::addProject(const ProjectIn &project)
 {
 	errno = 0;
 	CassStatement *query = cass_prepared_bind(insertProject);
@@ -24,7 +24,7 @@ bool DatabaseHandler::addProject(ProjectIn project)
 	cass_statement_bind_string_by_name(query, "license", project.license.c_str());
 	cass_statement_bind_string_by_name(query, "name", project.name.c_str());
 	cass_statement_bind_string_by_name(query, "url", project.url.c_str());
-	cass_statement_bind_uuid_by_name(query, "ownerid", createAuthorIfNotExists(project.owner));
+	cass_statement_bind_uuid_by_name(query, "ownerid", DatabaseUtility::hashToUuid(Hash(project.owner.id)));
 	cass_statement_bind_int64_by_name(query, "parserversion", project.parserVersion);
 
 	int size = project.hashes.size();
@@ -34,8 +34,7 @@ bool DatabaseHandler::addProject(ProjectIn project)
 	// Add the hashes, but no more than HASHES_INSERT_MAX
 	for (int i = 0; i < std::min(HASHES_INSERT_MAX, size); i++)
 	{
-		CassUuid hash;
-		cass_uuid_from_string(Utility::hashToUUIDString(project.hashes[i]).c_str(), &hash);
+		CassUuid hash = DatabaseUtility::hashToUuid(project.hashes[i]);
 		cass_collection_append_uuid(hashes, hash);
 	}
 
@@ -69,7 +68,7 @@ bool DatabaseHandler::addProject(ProjectIn project)
 	return true;
 }
 
-void DatabaseHandler::addHashToProject(ProjectIn project, int index)
+void DatabaseHandler::addHashToProject(const ProjectIn &project, int index)
 {
 	errno = 0;
 	CassStatement *query = cass_prepared_bind(addHashesToProject);
@@ -82,8 +81,7 @@ void DatabaseHandler::addHashToProject(ProjectIn project, int index)
 	CassCollection *hashes = cass_collection_new(CASS_COLLECTION_TYPE_SET, size);
 	for (int i = index; i < std::min(index + HASHES_INSERT_MAX, size); i++)
 	{
-		CassUuid hash;
-		cass_uuid_from_string(Utility::hashToUUIDString(project.hashes[i]).c_str(), &hash);
+		CassUuid hash = DatabaseUtility::hashToUuid(project.hashes[i]);
 		cass_collection_append_uuid(hashes, hash);
 	}
 	cass_statement_bind_collection_by_name(query, "hashes", hashes);
@@ -114,8 +112,39 @@ void DatabaseHandler::addHashToProject(ProjectIn project, int index)
 	}
 }
 
-void DatabaseHandler::addMethod(MethodIn method, ProjectIn project, long long prevVersion, long long parserVersion,
-								bool newProject)
+void DatabaseHandler::addAuthors(const std::vector<Author> &authors)
+{
+	errno = 0;
+	std::vector<CassFuture *> futures;
+	for (const Author &author : authors)
+	{
+		CassStatement *query = cass_prepared_bind(insertAuthorByID);
+
+		// Bind the variables in the statement.
+		cass_statement_bind_uuid_by_name(query, "authorID", DatabaseUtility::hashToUuid(Hash(author.id)));
+		cass_statement_bind_string_by_name(query, "name", author.name.c_str());
+		cass_statement_bind_string_by_name(query, "mail", author.mail.c_str());
+
+		futures.push_back(cass_session_execute(connection, query));
+		cass_statement_free(query);
+	}
+
+	for (CassFuture *queryFuture : futures)
+	{
+		if (cass_future_error_code(queryFuture) != CASS_OK)
+		{
+			const char *message;
+			size_t messageLength;
+			cass_future_error_message(queryFuture, &message, &messageLength);
+			fprintf(stderr, "Unable to add author: '%.*s'\n", (int)messageLength, message);
+			errno = ENETUNREACH;
+		}
+		cass_future_free(queryFuture);
+	}
+}
+
+void DatabaseHandler::addMethod(const MethodIn &method, const ProjectIn &project, long long prevVersion,
+								long long parserVersion, bool newProject)
 {
 	errno = 0;
 
@@ -125,11 +154,8 @@ void DatabaseHandler::addMethod(MethodIn method, ProjectIn project, long long pr
 		CassStatement *query = cass_prepared_bind(selectMethod);
 		cass_statement_set_consistency(query, CASS_CONSISTENCY_LOCAL_ONE);
 
-		std::string hashUUID = Utility::hashToUUIDString(method.hash);
-
 		// Bind the variables in the statement.
-		CassUuid uuid;
-		cass_uuid_from_string(hashUUID.c_str(), &uuid);
+		CassUuid uuid = DatabaseUtility::hashToUuid(method.hash);
 		cass_statement_bind_uuid_by_name(query, "method_hash", uuid);
 		cass_statement_bind_int64_by_name(query, "projectID", project.projectID);
 		cass_statement_bind_string_by_name(query, "file", method.fileLocation.c_str());
@@ -171,8 +197,9 @@ void DatabaseHandler::addMethod(MethodIn method, ProjectIn project, long long pr
 	}
 }
 
-void DatabaseHandler::handleSelectMethodQueryResult(CassFuture *queryFuture, MethodIn method, ProjectIn project,
-													long long prevVersion, long long parserVersion, bool &newMethod)
+void DatabaseHandler::handleSelectMethodQueryResult(CassFuture *queryFuture, const MethodIn &method,
+													const ProjectIn &project, long long prevVersion,
+													long long parserVersion, bool &newMethod)
 {
 	const CassResult *result = cass_future_get_result(queryFuture);
 
@@ -197,7 +224,7 @@ void DatabaseHandler::handleSelectMethodQueryResult(CassFuture *queryFuture, Met
 	cass_result_free(result);
 }
 
-void DatabaseHandler::addNewMethod(MethodIn method, ProjectIn project, long long parserVersion)
+void DatabaseHandler::addNewMethod(const MethodIn &method, const ProjectIn &project, long long parserVersion)
 {
 	errno = 0;
 	CassStatement *query;
@@ -211,8 +238,7 @@ void DatabaseHandler::addNewMethod(MethodIn method, ProjectIn project, long long
 	}
 
 	// Bind the variables in the statement.
-	CassUuid uuid;
-	cass_uuid_from_string(Utility::hashToUUIDString(method.hash).c_str(), &uuid);
+	CassUuid uuid = DatabaseUtility::hashToUuid(method.hash);
 	cass_statement_bind_uuid_by_name(query, "method_hash", uuid);
 	cass_statement_bind_int64_by_name(query, "projectID", project.projectID);
 	cass_statement_bind_int64_by_name(query, "startversiontime", project.version);
@@ -234,7 +260,7 @@ void DatabaseHandler::addNewMethod(MethodIn method, ProjectIn project, long long
 	// For each author of the method, add an entry to the table method_by_author.
 	for (int i = 0; i < size; i++)
 	{
-		CassUuid authorID = createAuthorIfNotExists(method.authors[i]);
+		CassUuid authorID = DatabaseUtility::hashToUuid(Hash(method.authors[i].id));
 		cass_collection_append_uuid(authors, authorID);
 		addMethodByAuthor(authorID, method, project);
 	}
@@ -262,15 +288,14 @@ void DatabaseHandler::addNewMethod(MethodIn method, ProjectIn project, long long
 	cass_future_free(queryFuture);
 }
 
-void DatabaseHandler::updateMethod(MethodIn method, ProjectIn project, long long startVersion)
+void DatabaseHandler::updateMethod(const MethodIn &method, const ProjectIn &project, long long startVersion)
 {
 	errno = 0;
 
 	CassStatement *query = cass_prepared_bind(updateMethods);
 
 	// Bind the variables in the statement.
-	CassUuid uuid;
-	cass_uuid_from_string(Utility::hashToUUIDString(method.hash).c_str(), &uuid);
+	CassUuid uuid = DatabaseUtility::hashToUuid(method.hash);
 	cass_statement_bind_uuid_by_name(query, "method_hash", uuid);
 	cass_statement_bind_int64_by_name(query, "projectid", project.projectID);
 	cass_statement_bind_string_by_name(query, "file", method.fileLocation.c_str());
@@ -286,7 +311,7 @@ void DatabaseHandler::updateMethod(MethodIn method, ProjectIn project, long long
 
 	for (int i = 0; i < size; i++)
 	{
-		CassUuid authorID = createAuthorIfNotExists(method.authors[i]);
+		CassUuid authorID = DatabaseUtility::hashToUuid(Hash(method.authors[i].id));
 		cass_collection_append_uuid(authors, authorID);
 		addMethodByAuthor(authorID, method, project);
 	}
@@ -314,8 +339,9 @@ void DatabaseHandler::updateMethod(MethodIn method, ProjectIn project, long long
 	cass_future_free(queryFuture);
 }
 
-std::vector<Hash> DatabaseHandler::updateUnchangedFiles(std::vector<Hash> hashes, std::vector<std::string> files,
-														ProjectIn project, long long prevVersion)
+std::vector<Hash> DatabaseHandler::updateUnchangedFiles(const std::vector<Hash> &hashes,
+														const std::vector<std::string> &files, const ProjectIn &project,
+														long long prevVersion)
 {
 	errno = 0;
 	CassFuture *queryFuture = executeSelectUnchangedMethodsQuery(hashes, files, project);
@@ -341,8 +367,9 @@ std::vector<Hash> DatabaseHandler::updateUnchangedFiles(std::vector<Hash> hashes
 	return resultHashes;
 }
 
-CassFuture *DatabaseHandler::executeSelectUnchangedMethodsQuery(std::vector<Hash> hashes,
-																std::vector<std::string> files, ProjectIn project)
+CassFuture *DatabaseHandler::executeSelectUnchangedMethodsQuery(const std::vector<Hash> &hashes,
+																const std::vector<std::string> &files,
+																const ProjectIn &project)
 {
 	CassStatement *query = cass_prepared_bind(selectUnchangedMethods);
 	cass_statement_set_consistency(query, CASS_CONSISTENCY_LOCAL_ONE);
@@ -351,8 +378,7 @@ CassFuture *DatabaseHandler::executeSelectUnchangedMethodsQuery(std::vector<Hash
 	CassCollection *hashesCollection = cass_collection_new(CASS_COLLECTION_TYPE_LIST, hashes.size());
 	for (int i = 0; i < hashes.size(); i++)
 	{
-		CassUuid hash;
-		cass_uuid_from_string(Utility::hashToUUIDString(hashes[i]).c_str(), &hash);
+		CassUuid hash = DatabaseUtility::hashToUuid(hashes[i]);
 		cass_collection_append_uuid(hashesCollection, hash);
 	}
 
@@ -376,7 +402,7 @@ CassFuture *DatabaseHandler::executeSelectUnchangedMethodsQuery(std::vector<Hash
 	return queryFuture;
 }
 
-std::vector<Hash> DatabaseHandler::handleSelectUnchangedMethodsResult(CassFuture *queryFuture, ProjectIn project,
+std::vector<Hash> DatabaseHandler::handleSelectUnchangedMethodsResult(CassFuture *queryFuture, const ProjectIn &project,
 																	  long long prevVersion)
 {
 	std::vector<Hash> hashes;
@@ -395,7 +421,7 @@ std::vector<Hash> DatabaseHandler::handleSelectUnchangedMethodsResult(CassFuture
 		{
 			long long startVersion = DatabaseUtility::getInt64(row, "startversiontime");
 			MethodIn method;
-			method.hash = Utility::uuidStringToHash(DatabaseUtility::getUUID(row, "method_hash"));
+			method.hash = DatabaseUtility::getHash(row, "method_hash");
 			method.fileLocation = DatabaseUtility::getString(row, "file");
 			method.lineNumber = DatabaseUtility::getInt32(row, "lineNumber");
 			method.methodName = DatabaseUtility::getString(row, "name");
@@ -410,7 +436,7 @@ std::vector<Hash> DatabaseHandler::handleSelectUnchangedMethodsResult(CassFuture
 	return hashes;
 }
 
-void DatabaseHandler::addMethodByAuthor(CassUuid authorID, MethodIn method, ProjectIn project)
+void DatabaseHandler::addMethodByAuthor(CassUuid authorID, const MethodIn &method, const ProjectIn &project)
 {
 	errno = 0;
 	CassStatement *query = cass_prepared_bind(insertMethodByAuthor);
@@ -418,8 +444,7 @@ void DatabaseHandler::addMethodByAuthor(CassUuid authorID, MethodIn method, Proj
 	// Bind the variables in the statement.
 	cass_statement_bind_uuid_by_name(query, "authorID", authorID);
 
-	CassUuid uuid;
-	cass_uuid_from_string(Utility::hashToUUIDString(method.hash).c_str(), &uuid);
+	CassUuid uuid = DatabaseUtility::hashToUuid(method.hash);
 	cass_statement_bind_uuid_by_name(query, "hash", uuid);
 	cass_statement_bind_int64_by_name(query, "projectID", project.projectID);
 	cass_statement_bind_string_by_name(query, "file", method.fileLocation.c_str());
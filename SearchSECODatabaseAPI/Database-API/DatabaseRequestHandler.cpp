@@ -13,7 +13,6 @@ Utrecht University within the Software Project course.
 #include <algorithm>
 #include <sstream>
 #include <ctime>
-#include <regex>
 #include <thread>
 #include <future>
 #include <utility>
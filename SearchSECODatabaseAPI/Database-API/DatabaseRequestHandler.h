@@ -7,20 +7,26 @@ Utrecht University within the Software Project course.
 #pragma once
 #include "Definitions.h"
 #include "DatabaseHandler.h"
+#include "MethodCache.h"
+#include "MethodTable.h"
+#include "NegativeCache.h"
+#include "SingleFlight.h"
 #include "Statistics.h"
+#include "UploadInterner.h"
 
+#include <memory_resource>
 #include <mutex>
 #include <tuple>
 #include <queue>
+#include <string_view>
 #include <unistd.h>
 
 
 #define PROJECT_DATA_SIZE 9
 #define METHOD_DATA_MIN_SIZE 5
-#define HEX_CHARS "0123456789abcdef"
-#define UUID_REGEX "[0-9a-fA-F]{8}\\-[0-9a-fA-F]{4}\\-[0-9a-fA-F]{4}\\-[0-9a-fA-F]{4}\\-[0-9a-fA-F]{12}"
 #define HASHES_MAX_SIZE 1000
 #define FILES_MAX_SIZE 500
+#define CONTINUATION_CHECKSUM_LENGTH 8 // Hex characters of the checksum at the end of a continuation token.
 
 /// <summary>
 /// Handles requests towards database.
@@ -44,7 +50,7 @@ public:
 	/// containing prevVersion and the unchanged files, can be left empty.
 	/// </param>
 	/// <returns> Response towards user after processing the request. </returns>
-	std::string handleUploadRequest(std::string request, std::string client);
+	std::string handleUploadRequest(const std::string &request, const std::string &client);
 
 	/// <summary>
 	/// Handles requests wanting to obtain methods with certain hashes.
@@ -59,7 +65,7 @@ public:
 	///  method_name?file?lineNumber?parserVersion?vulnCode?authorTotal?authorID_1?...?authorID_N".
 	/// Separated methods are separated by '\n'.
 	/// </returns>
-	std::string handleCheckRequest(std::string request);
+	std::string handleCheckRequest(const std::string &request);
 
 	/// <summary>
 	/// Handles requests wanting to obtain methods with certain hashes.
@@ -71,7 +77,7 @@ public:
 	///  method_name?file?lineNumber?parserVersion?vulnCode?authorTotal?authorID_1?...?authorID_N".
 	/// Separated methods are separated by '\n'.
 	/// </returns>
-	std::string handleCheckRequest(std::vector<Hash> hashes);
+	std::string handleCheckRequest(const std::vector<Hash> &hashes);
 
 	/// <summary>
 	/// Handles requests wanting to first check for matches with existing methods in other projects,
@@ -90,7 +96,7 @@ public:
 	///  method_name?file?lineNumber?parserVersion?vulnCode?authorTotal?authorID_1?...?authorID_N".
 	/// Separated methods are separated by '\n'.
 	/// </returns>
-	std::string handleCheckUploadRequest(std::string request, std::string client);
+	std::string handleCheckUploadRequest(const std::string &request, const std::string &client);
 
 	/// <summary>
 	/// Handles requests wanting to obtain project data from the database given their projectID and version.
@@ -104,7 +110,7 @@ public:
 	/// "projectID?version?versionHash?license?project_name?url?owner_id?parserVersion".
 	/// Separated projects are separated by '\n'.
 	/// </returns>
-	std::string handleExtractProjectsRequest(std::string request);
+	std::string handleExtractProjectsRequest(const std::string &request);
 
 	/// <summary>
 	/// Handles requests wanting to obtain project data from a the database from a previous version given their
@@ -119,7 +125,7 @@ public:
 	/// "projectID?version?versionHash?license?project_name?url?owner_id?parserVersion".
 	/// Separated projects are separated by '\n'.
 	/// </returns>
-	std::string handlePrevProjectsRequest(std::string request);
+	std::string handlePrevProjectsRequest(const std::string &request);
 
 	/// <summary>
 	/// Handles a requests for retrieving the authors by the given IDs.
@@ -133,7 +139,7 @@ public:
 	/// "name?mail?id".
 	/// The authors are separated by '\n'.
 	/// </returns>
-	std::string handleGetAuthorRequest(std::string request);
+	std::string handleGetAuthorRequest(const std::string &request);
 
 	/// <summary>
 	/// Handles requests wanting to obtain methods with certain authors.
@@ -147,7 +153,26 @@ public:
 	/// "authorID?hash?projectID?version".
 	/// Separated entries are separated by '\n'.
 	/// </returns>
-	std::string handleGetMethodsByAuthorRequest(std::string request);
+	std::string handleGetMethodsByAuthorRequest(const std::string &request);
+
+	/// <summary>
+	/// Handles requests wanting to obtain the methods of a single author one page at a time, so the methods of
+	/// prolific authors can be streamed instead of being retrieved at once.
+	/// </summary>
+	/// <param name="request">
+	/// The request made by the user, having the following format:
+	/// "authorID?pageSize?continuationToken".
+	/// The page size and continuation token are optional. Without a page size, METHODS_PAGE_SIZE is used, and
+	/// without a continuation token the first page is retrieved. A continuation token which was not given out for
+	/// the author is rejected before the database is queried.
+	/// </param>
+	/// <returns>
+	/// The continuation token for the next page, which is empty if this was the last page, followed by
+	/// '\n' and the method keys in the page. An entry is presented as follows:
+	/// "authorID?hash?projectID?version".
+	/// Separated entries are separated by '\n'.
+	/// </returns>
+	std::string handleGetMethodsByAuthorPageRequest(const std::string &request);
 
 	/// <summary>
 	/// Retrieves the extension from the passed file name.
@@ -165,7 +190,7 @@ private:
 	/// "projectID?version?versionHash?license?project_name?url?author_name?author_mail?parserVersion".
 	/// </param>
 	/// <returns> The project containing all data as provided within request. </returns>
-	ProjectIn requestToProject(std::string request);
+	ProjectIn requestToProject(const std::string &request);
 
 	/// <summary>
 	/// Converts a data entry to a MethodIn (defined in Types.h).
@@ -175,8 +200,11 @@ private:
 	/// "method_hash?method_name?file?lineNumber?authorTotal?
 	///  author1_name?author1_mail?...?authorN_name?authorN_mail".
 	/// </param>
+	/// <param name="methodData"> Buffer the fields are split into, reused between methods. </param>
+	/// <param name="interner"> Keeps the authors and files of the upload the method is in. </param>
 	/// <returns> A method containing all data as provided in input. </returns>
-	MethodIn dataEntryToMethod(std::string dataEntry);
+	MethodIn dataEntryToMethod(std::string_view dataEntry, std::pmr::vector<std::string_view> &methodData,
+							   UploadInterner &interner);
 
 	/// <summary>
 	/// Retrieves the hashes within a request.
@@ -188,25 +216,7 @@ private:
 	///  method1_author1_name?method1_author1_mail?<other authors>'\n'<method2_data>'\n'...'\n'<methodN_data>".
 	/// </param>
 	/// <returns> The hashes of the methods given in the requests in a vector. </returns>
-	std::vector<Hash> requestToHashes(std::string request);
-
-	/// <summary>
-	/// Checks if a hash is valid.
-	/// </summary>
-	/// <param name="hash"> The hash to be checked. </param>
-	/// <returns> Boolean indicating the validity of the given hash. </returns>
-	bool isValidHash(Hash hash);
-
-	/// <summary>
-	/// Converts methods to a string by placing special delimiters between fields and between entries.
-	/// </summary>
-	/// <param name="methods"> The methods to be converted to a string. </param>
-	/// <param name="dataDelimiter"> Delimiter to separate different fields in a method. </param>
-	/// <param name="methodDelimiter"> Delimiter to separate different methods. </param>
-	/// <returns>
-	/// A string consisting of all provided methods by means of separation of data elements and methods.
-	/// </returns>
-	std::string methodsToString(std::vector<MethodOut> methods, char dataDelimiter, char methodDelimiter);
+	std::vector<Hash> requestToHashes(const std::string &request);
 
 	/// <summary>
 	/// Converts projects to a string by placing special delimiters between fields and between entries.
@@ -224,7 +234,7 @@ private:
 	/// </summary>
 	/// <param name="hashes"> A vector of hashes. </param>
 	/// <returns> All methods in the database with a hash equal to one in 'hashes'. </returns>
-	std::vector<MethodOut> getMethods(std::vector<Hash> hashes);
+	MethodTable getMethods(const std::vector<Hash> &hashes);
 
 	/// <summary>
 	/// Retrieves the projects corresponding to the projectKeys given as input (in a queue) using the database.
@@ -247,8 +257,8 @@ private:
 	/// </summary>
 	/// <param name="hashes"> The queue with hashes that have to be checked. </param>
 	/// <param name="queueLock"> The lock for the queue. </param>
-	/// <returns> The methods found by a single thread inside a vector. </returns>
-	std::vector<MethodOut> singleHashToMethodsThread(std::queue<Hash> &hashes, std::mutex &queueLock);
+	/// <returns> The methods found by a single thread. </returns>
+	MethodTable singleHashToMethodsThread(std::queue<Hash> &hashes, std::mutex &queueLock);
 
 	/// <summary> Handles a single thread of checking hashes with the database. </summary>
 	/// <param name="projectKeyQueue">
@@ -278,8 +288,8 @@ private:
 	/// <param name="unchangedFiles">
 	/// The files that did not change compared to the previous version of the project.
 	/// </param>
-	void handleUploadThreads(ProjectIn project, std::queue<MethodIn> methodQueue, bool newProject,
-							 ProjectOut prevProject, std::vector<File> unchangedFiles);
+	void handleUploadThreads(const ProjectIn &project, std::queue<MethodIn> &methodQueue, bool newProject,
+							 const ProjectOut &prevProject, const std::vector<File> &unchangedFiles);
 
 	/// <summary>
 	/// Handles a single thread of uploading methods to the database.
@@ -290,7 +300,7 @@ private:
 	/// <param name="prevVersion"> The previous version of the project. </param>
 	/// <param name="parserVersion"> The version of the parser. </param>
 	/// <param name="newProject"> Indication of the project being new or not. </param>
-	void singleUploadThread(std::queue<MethodIn> &methods, std::mutex &queueLock, ProjectIn project,
+	void singleUploadThread(std::queue<MethodIn> &methods, std::mutex &queueLock, const ProjectIn &project,
 							long long prevVersion, long long parserVersion, bool newProject);
 
 	/// <summary>
@@ -301,8 +311,8 @@ private:
 	/// <param name="unchangedFiles">
 	/// The files that did not change in comparison with the previous version of the project.
 	/// </param>
-	void handleUpdateUnchangedFilesThreads(ProjectIn project, ProjectOut prevProject, 
-										   std::vector<File> unchangedFiles);
+	void handleUpdateUnchangedFilesThreads(const ProjectIn &project, const ProjectOut &prevProject, 
+										   const std::vector<File> &unchangedFiles);
 
 	/// <summary>
 	/// Handles a single thread of updating methods in unchanged files.
@@ -316,7 +326,7 @@ private:
 	/// <returns> The hashes in the queue 'hashFiles' that are in fact part of the unchanged files. </returns>
 	std::vector<Hash>
 	singleUpdateUnchangedFilesThread(std::queue<std::pair<std::vector<Hash>, std::vector<File>>> &hashFiles,
-									 std::mutex &queueLock, ProjectIn project, long long prevVersion);
+									 std::mutex &queueLock, const ProjectIn &project, long long prevVersion);
 
 	/// <summary>
 	/// Parses a list of authors with IDs to a string to be returned.
@@ -326,14 +336,14 @@ private:
 	/// A string of the format:
 	/// name_1?mail_1?id_1'\n'name_2?mail_2?id_2'\n'...
 	/// </returns>
-	std::string authorsToString(std::vector<std::pair<Author, AuthorID>> authors);
+	std::string authorsToString(std::vector<std::pair<Author, Hash>> authors);
 
 	/// <summary>
 	/// Retrieves the authors corresponding to the IDs given as input using the database.
 	/// </summary>
 	/// <param name="authorIDs"> A vector of authorIDs. </param>
 	/// <returns> A vector consisting of pairs of authors and their corresponding ID. </returns>
-	std::vector<std::pair<Author, AuthorID>> getAuthors(std::vector<AuthorID> authorIDs);
+	std::vector<std::pair<Author, Hash>> getAuthors(const std::vector<Hash> &authorIDs);
 
 	/// <summary>
 	/// Handles a single thread of retrieving authors from the database.
@@ -341,15 +351,14 @@ private:
 	/// <param name="authorIDs"> The queue with author ids that have to be checked. </param>
 	/// <param name="queueLock"> The lock for the queue with authorIDs. </param>
 	/// <returns> A vector consisting of pairs with an author and the corresponding ID. </returns>
-	std::vector<std::pair<Author, AuthorID>> singleIDToAuthorThread(std::queue<AuthorID> &authorIDs,
-																	std::mutex &queueLock);
+	std::vector<std::pair<Author, Hash>> singleIDToAuthorThread(std::queue<Hash> &authorIDs, std::mutex &queueLock);
 
 	/// <summary>
 	/// Retrieves the methods worked on by one of the authors for which the id is given.
 	/// </summary>
 	/// <param name="authorIDs"> A vector of authorIDs. </param
 	/// <returns> All methods in the database that one of the give authors has worked on. </returns>
-	std::vector<std::pair<MethodID, AuthorID>> getMethodsByAuthor(std::vector<AuthorID> authorIDs);
+	std::vector<std::pair<MethodID, Hash>> getMethodsByAuthor(const std::vector<Hash> &authorIDs);
 
 	/// <summary>
 	/// Handles a single thread of retrieving methods by given authors.
@@ -357,8 +366,8 @@ private:
 	/// <param name="authorIDs"> The queue with IDs of authors that have to be checked. </param>
 	/// <param name="queueLock"> The lock for the queue with authorIDs. </param>
 	/// <returns> A vector consisting of pairs of methodIDs and authorIDs. </returns>
-	std::vector<std::pair<MethodID, AuthorID>> singleAuthorToMethodsThread(std::queue<AuthorID> &authorIDs,
-																		   std::mutex &queueLock);
+	std::vector<std::pair<MethodID, Hash>> singleAuthorToMethodsThread(std::queue<Hash> &authorIDs,
+																	   std::mutex &queueLock);
 
 	/// <summary>
 	/// Parses a list of methods with authorIDs to a string to be returned.
@@ -368,7 +377,21 @@ private:
 	/// A string of the format:
 	/// authorID_1?hash_1?projectID_1?version_1'\n'authorID_2?hash_2?projectID_2?version_2'\n'...
 	/// <returns>
-	std::string methodIDsToString(std::vector<std::pair<MethodID, AuthorID>> methods);
+	std::string methodIDsToString(std::vector<std::pair<MethodID, Hash>> methods);
+
+	/// <summary>
+	/// Converts the paging state of the driver to a continuation token: the paging state followed by a checksum
+	/// of it and the author, encoded as hex so it cannot contain delimiters.
+	/// </summary>
+	/// <returns> The empty string if there is no next page. </returns>
+	static std::string toContinuationToken(const Hash &authorID, const std::string &pagingState);
+
+	/// <summary>
+	/// Converts a continuation token back to the paging state of the driver.
+	/// </summary>
+	/// <param name="pagingState"> The paging state, only changed if the token is valid. </param>
+	/// <returns> False if the token was not given out for the author. </returns>
+	static bool parseContinuationToken(const Hash &authorID, std::string_view token, std::string &pagingState);
 
 	/// <summary>
 	/// Calls connect in the DatabaseHandler, if connect fails, it retries as many times as the MAX_RETRIES.
@@ -385,7 +408,7 @@ private:
 	/// If it succeeds, it returns true. If it still fails on the last retry, it returns false.
 	/// </summary>
 	/// <param name="project"> The corresponding project to be added. </param>
-	bool tryUploadProjectWithRetry(ProjectIn project);
+	bool tryUploadProjectWithRetry(const ProjectIn &project);
 
 	/// <summary>
 	/// Tries to add method to the database, if it fails it retries as many times as MAX_RETRIES.
@@ -398,8 +421,15 @@ private:
 	/// <param name="parserVersion"> the version of the parser. </param>
 	/// <param name="newProject"> Indication of the project being new or not. </param>
 	/// <returns> An empty tuple. </returns>
-	std::tuple<> addMethodWithRetry(MethodIn method, ProjectIn project, long long prevVersion, long long parserVersion,
-									bool newProject);
+	std::tuple<> addMethodWithRetry(const MethodIn &method, const ProjectIn &project, long long prevVersion,
+									long long parserVersion, bool newProject);
+
+	/// <summary>
+	/// Adds the authors of an upload to the database, if it fails it retries as many times as the MAX_RETRIES.
+	/// </summary>
+	/// <param name="authors"> The distinct authors of the upload. </param>
+	/// <returns> An empty tuple. </returns>
+	std::tuple<> addAuthorsWithRetry(const std::vector<Author> &authors);
 
 	/// <summary>
 	/// Tries to obtain the previous/latest version of the relevant project.
@@ -422,13 +452,15 @@ private:
 	/// to the project afterwards. If it fails to establish the hashes, puts the errno on ENETUNREACH
 	/// and returns empty vector.
 	/// </returns>
-	std::vector<Hash> updateUnchangedFilesWithRetry(std::pair<std::vector<Hash>, std::vector<File>> hashFile,
-													ProjectIn project, long long prevVersion);
+	std::vector<Hash> updateUnchangedFilesWithRetry(const std::pair<std::vector<Hash>, std::vector<File>> &hashFile,
+													const ProjectIn &project, long long prevVersion);
 
 	/// <summary>
 	/// Tries to get all methods with a given hash from the database, if it fails it retries as many times as
 	/// MAX_RETRIES. If it succeeds, it returns the methods found in the database.
 	/// If it fails, it puts the errno on ENETUNREACH and returns an empty vector.
+	/// Concurrent lookups of the same hash, by this or other requests, share a single lookup.
+	/// The methods of often requested hashes are kept in the method cache.
 	/// </summary>
 	/// <param name="hash"> The corresponding hash to be searched for. </param>
 	/// <returns> The methods corresponding to the hash provided. </returns>
@@ -449,14 +481,21 @@ private:
 	/// MAX_RETRIES. If it succeeds, it returns the author. If it fails, it returns an empty author and
 	/// puts errno on ENETUNREACH.
 	/// </summary>
-	Author idToAuthorWithRetry(AuthorID id);
+	Author idToAuthorWithRetry(Hash id);
 
 	/// <summary>
 	/// Tries to get methods from the database given an authorID, if it fails it retries like above.
 	/// If it succeeds, it returns the methods.
 	/// If it fails, it returns an empty vector and puts errno on ENETUNREACH.
 	/// </summary>
-	std::vector<MethodID> authorToMethodsWithRetry(AuthorID authorID);
+	std::vector<MethodID> authorToMethodsWithRetry(Hash authorID);
+
+	/// <summary>
+	/// Tries to get a page of methods from the database given an authorID, if it fails it retries like above.
+	/// If it succeeds, it returns the methods and updates the paging state.
+	/// If it fails, it returns an empty vector and puts errno on ENETUNREACH.
+	/// </summary>
+	std::vector<MethodID> authorToMethodsPageWithRetry(const Hash &authorID, int pageSize, std::string &pagingState);
 
 	/// <summary>
 	/// Splits a list of arbitrary type into multiple chunks of size at most equal to the chunkSize.
@@ -516,4 +555,7 @@ private:
 
 	DatabaseHandler *database;
 	Statistics *stats;
+	SingleFlight<Hash, std::vector<MethodOut>> hashLookups;
+	MethodCache methodCache;
+	NegativeCache negativeCache;
 };
@@ -11,17 +11,16 @@ Utrecht University within the Software Project course.
 
 #include <future>
 #include <thread>
-#include <regex>
 
-std::string DatabaseRequestHandler::authorsToString(std::vector<std::pair<Author, AuthorID>> authors)
+std::string DatabaseRequestHandler::authorsToString(std::vector<std::pair<Author, Hash>> authors)
 {
 	std::vector<char> chars = {};
 	while (!authors.empty())
 	{
-		std::pair<Author, AuthorID> lastAuthorID = authors.back();
+		std::pair<Author, Hash> lastAuthorID = authors.back();
 		std::string name = lastAuthorID.first.name;
 		std::string mail = lastAuthorID.first.mail;
-		AuthorID id = lastAuthorID.second;
+		AuthorID id = lastAuthorID.second.toUuidString();
 
 		// We initialize dataElements, which consists of the hash, projectID, version, name, fileLocation, lineNumber,
 		// authorTotal and all the authorIDs.
@@ -47,21 +46,21 @@ std::string DatabaseRequestHandler::authorsToString(std::vector<std::pair<Author
 	return result;
 }
 
-std::string DatabaseRequestHandler::handleGetAuthorRequest(std::string request)
+std::string DatabaseRequestHandler::handleGetAuthorRequest(const std::string &request)
 {
-	std::vector<AuthorID> authorIDs = Utility::splitStringOn(request, ENTRY_DELIMITER_CHAR);
-	std::regex re(UUID_REGEX);
+	std::vector<std::string> data = Utility::splitStringOn(request, ENTRY_DELIMITER_CHAR);
+	std::vector<Hash> authorIDs(data.size());
 
-	for (int i = 0; i < authorIDs.size(); i++)
+	for (int i = 0; i < data.size(); i++)
 	{
-		if (!regex_match(authorIDs[i], re))
+		if (!Hash::parseUuid(data[i], authorIDs[i]))
 		{
-			return HTTPStatusCodes::clientError("Error parsing author id: " + authorIDs[i]);
+			return HTTPStatusCodes::clientError("Error parsing author id: " + data[i]);
 		}
 	}
 
 	// Request the specified hashes.
-	std::vector<std::pair<Author, AuthorID>> authors = getAuthors(authorIDs);
+	std::vector<std::pair<Author, Hash>> authors = getAuthors(authorIDs);
 	if (errno != 0)
 	{
 		return HTTPStatusCodes::serverError("Unable to get authors from database.");
@@ -73,11 +72,11 @@ std::string DatabaseRequestHandler::handleGetAuthorRequest(std::string request)
 	return HTTPStatusCodes::success(authorsToString(authors));
 }
 
-std::vector<std::pair<Author, AuthorID>> DatabaseRequestHandler::getAuthors(std::vector<AuthorID> authorIDs)
+std::vector<std::pair<Author, Hash>> DatabaseRequestHandler::getAuthors(const std::vector<Hash> &authorIDs)
 {
-	std::vector<std::future<std::vector<std::pair<Author, AuthorID>>>> results;
+	std::vector<std::future<std::vector<std::pair<Author, Hash>>>> results;
 	std::vector<std::thread> threads;
-	std::queue<AuthorID> authorIDQueue;
+	std::queue<Hash> authorIDQueue;
 	std::mutex queueLock;
 	for (int i = 0; i < authorIDs.size(); i++)
 	{
@@ -85,7 +84,7 @@ std::vector<std::pair<Author, AuthorID>> DatabaseRequestHandler::getAuthors(std:
 	}
 	for (int i = 0; i < MAX_THREADS; i++)
 	{
-		std::packaged_task<std::vector<std::pair<Author, AuthorID>>()> task(
+		std::packaged_task<std::vector<std::pair<Author, Hash>>()> task(
 			bind(&DatabaseRequestHandler::singleIDToAuthorThread, this, ref(authorIDQueue), ref(queueLock)));
 		if (errno != 0)
 		{
@@ -99,10 +98,10 @@ std::vector<std::pair<Author, AuthorID>> DatabaseRequestHandler::getAuthors(std:
 	{
 		threads[i].join();
 	}
-	std::vector<std::pair<Author, AuthorID>> authors;
+	std::vector<std::pair<Author, Hash>> authors;
 	for (int i = 0; i < results.size(); i++)
 	{
-		std::vector<std::pair<Author, AuthorID>> newAuthors = results[i].get();
+		std::vector<std::pair<Author, Hash>> newAuthors = results[i].get();
 
 		for (int j = 0; j < newAuthors.size(); j++)
 		{
@@ -112,10 +111,10 @@ std::vector<std::pair<Author, AuthorID>> DatabaseRequestHandler::getAuthors(std:
 	return authors;
 }
 
-std::vector<std::pair<Author, AuthorID>> DatabaseRequestHandler::singleIDToAuthorThread(std::queue<AuthorID> &authorIDs,
-																						std::mutex &queueLock)
+std::vector<std::pair<Author, Hash>> DatabaseRequestHandler::singleIDToAuthorThread(std::queue<Hash> &authorIDs,
+																					std::mutex &queueLock)
 {
-	std::vector<std::pair<Author, AuthorID>> authors;
+	std::vector<std::pair<Author, Hash>> authors;
 	while (true)
 	{
 		queueLock.lock();
@@ -124,7 +123,7 @@ std::vector<std::pair<Author, AuthorID>> DatabaseRequestHandler::singleIDToAutho
 			queueLock.unlock();
 			return authors;
 		}
-		AuthorID id = authorIDs.front();
+		Hash id = authorIDs.front();
 		authorIDs.pop();
 		queueLock.unlock();
 		Author newAuthor = idToAuthorWithRetry(id);
@@ -135,12 +134,12 @@ std::vector<std::pair<Author, AuthorID>> DatabaseRequestHandler::singleIDToAutho
 		}
 		if (newAuthor.name != "" && newAuthor.mail != "")
 		{
-			authors.push_back(make_pair(newAuthor, id));
+			authors.push_back(std::make_pair(newAuthor, id));
 		}
 	}
 }
 
-Author DatabaseRequestHandler::idToAuthorWithRetry(AuthorID id)
+Author DatabaseRequestHandler::idToAuthorWithRetry(Hash id)
 {
 	std::function<Author()> function = [id, this]() {
 		Author author;
@@ -8,12 +8,12 @@ Utrecht University within the Software Project course.
 #include "DatabaseRequestHandler.h"
 #include "HTTPStatus.h"
 #include "Utility.h"
+#include "md5/md5.h"
 
 #include <future>
 #include <thread>
-#include <regex>
 
-std::vector<Hash> DatabaseRequestHandler::requestToHashes(std::string request)
+std::vector<Hash> DatabaseRequestHandler::requestToHashes(const std::string &request)
 {
 	errno = 0;
 	std::vector<std::string> data = Utility::splitStringOn(request, ENTRY_DELIMITER_CHAR);
@@ -21,8 +21,8 @@ std::vector<Hash> DatabaseRequestHandler::requestToHashes(std::string request)
 	for (int i = 3; i < data.size(); i++)
 	{
 		// Data before first delimiter.
-		Hash hash = data[i].substr(0, data[i].find(FIELD_DELIMITER_CHAR));
-		if (isValidHash(hash))
+		Hash hash;
+		if (Hash::parse(data[i].data(), std::min(data[i].find(FIELD_DELIMITER_CHAR), data[i].size()), hash))
 		{
 			hashes.push_back(hash);
 		}
@@ -36,14 +36,9 @@ std::vector<Hash> DatabaseRequestHandler::requestToHashes(std::string request)
 	return hashes;
 }
 
-bool DatabaseRequestHandler::isValidHash(Hash hash)
-{
-	// Inspired by: https://stackoverflow.com/questions/19737727/c-check-if-string-is-a-valid-md5-hex-hash.
-	return hash.size() == 32 && hash.find_first_not_of(HEX_CHARS) == -1;
-}
-
-void DatabaseRequestHandler::singleUploadThread(std::queue<MethodIn> &methods, std::mutex &queueLock, ProjectIn project,
-												long long prevVersion, long long parserVersion, bool newProject)
+void DatabaseRequestHandler::singleUploadThread(std::queue<MethodIn> &methods, std::mutex &queueLock,
+												const ProjectIn &project, long long prevVersion,
+												long long parserVersion, bool newProject)
 {
 	while (true)
 	{
@@ -53,7 +48,7 @@ void DatabaseRequestHandler::singleUploadThread(std::queue<MethodIn> &methods, s
 			queueLock.unlock();
 			return;
 		}
-		MethodIn method = methods.front();
+		MethodIn method = std::move(methods.front());
 		methods.pop();
 		queueLock.unlock();
 		addMethodWithRetry(method, project, prevVersion, parserVersion, newProject);
@@ -64,10 +59,13 @@ void DatabaseRequestHandler::singleUploadThread(std::queue<MethodIn> &methods, s
 	}
 }
 
-MethodIn DatabaseRequestHandler::dataEntryToMethod(std::string dataEntry)
+MethodIn DatabaseRequestHandler::dataEntryToMethod(std::string_view dataEntry,
+												  std::pmr::vector<std::string_view> &methodData,
+												  UploadInterner &interner)
 {
 	errno = 0;
-	std::vector<std::string> methodData = Utility::splitStringOn(dataEntry, FIELD_DELIMITER_CHAR);
+	methodData.clear();
+	Utility::splitStringOn(dataEntry, FIELD_DELIMITER_CHAR, methodData);
 
 	if (methodData.size() < METHOD_DATA_MIN_SIZE)
 	{
@@ -77,24 +75,22 @@ MethodIn DatabaseRequestHandler::dataEntryToMethod(std::string dataEntry)
 	}
 
 	MethodIn method;
-	if (!isValidHash(methodData[0]))
+	if (!Hash::parse(methodData[0].data(), methodData[0].size(), method.hash))
 	{
 		// Invalid method hash.
 		errno = EILSEQ;
 		return MethodIn();
 	}
-	method.hash = methodData[0];
 	method.methodName = methodData[1];
 	method.fileLocation = methodData[2];
-	method.lineNumber = Utility::safeStoi(methodData[3]);
+	method.lineNumber = Utility::safeStoi(std::string(methodData[3]));
 	if (errno != 0)
 	{
 		// Non-integer line number.
 		return MethodIn();
 	}	
 
-	std::vector<Author> authors;
-	int numberOfAuthors = Utility::safeStoi(methodData[4]);
+	int numberOfAuthors = Utility::safeStoi(std::string(methodData[4]));
 	if (errno != 0)
 	{
 		// Non-integer number of authors.
@@ -108,18 +104,18 @@ MethodIn DatabaseRequestHandler::dataEntryToMethod(std::string dataEntry)
 		return MethodIn();
 	}
 
+	method.authors.reserve(std::max(numberOfAuthors, 0));
 	for (int i = 0; i < numberOfAuthors; i++)
 	{
-		Author author(methodData[5 + 2 * i], methodData[6 + 2 * i]);
-		authors.push_back(author);
+		method.authors.push_back(interner.addAuthor(methodData[5 + 2 * i], methodData[6 + 2 * i]));
 	}
-	method.authors = authors;
 
 	if (methodData.size() > METHOD_DATA_MIN_SIZE + 2 * numberOfAuthors)
 	{
 		method.vulnCode = methodData[METHOD_DATA_MIN_SIZE + 2 * numberOfAuthors];
 	}
 
+	interner.countFile(methodData[2]);
 	return method;
 }
 
@@ -129,32 +125,33 @@ std::string DatabaseRequestHandler::getExtension(std::string file)
 	return file.substr(loc, file.size());
 }
 
-std::string DatabaseRequestHandler::handleCheckRequest(std::string request)
+std::string DatabaseRequestHandler::handleCheckRequest(const std::string &request)
 {
-	std::vector<Hash> hashes = Utility::splitStringOn(request, ENTRY_DELIMITER_CHAR);
-	return handleCheckRequest(hashes);
-}
+	std::vector<std::string> data = Utility::splitStringOn(request, ENTRY_DELIMITER_CHAR);
+	std::vector<Hash> hashes(data.size());
 
-std::string DatabaseRequestHandler::handleCheckRequest(std::vector<Hash> hashes)
-{
-	// Check if all requested hashes are invalid.
-	for (int i = 0; i < hashes.size(); i++)
+	// Check if all requested hashes are valid.
+	for (int i = 0; i < data.size(); i++)
 	{
-		if (!isValidHash(hashes[i]))
+		if (!Hash::parse(data[i], hashes[i]))
 		{
 			return HTTPStatusCodes::clientError("Invalid hash presented.");
 		}
 	}
+	return handleCheckRequest(hashes);
+}
 
+std::string DatabaseRequestHandler::handleCheckRequest(const std::vector<Hash> &hashes)
+{
 	// Request the specified hashes.
-	std::vector<MethodOut> methods = getMethods(hashes);
+	MethodTable methods = getMethods(hashes);
 	if (errno != 0)
 	{
 		return HTTPStatusCodes::serverError("Unable to get methods from database.");
 	}
 
 	// Return retrieved data.
-	std::string methodsStringFormat = methodsToString(methods, FIELD_DELIMITER_CHAR, ENTRY_DELIMITER_CHAR);
+	std::string methodsStringFormat = methods.toString(FIELD_DELIMITER_CHAR, ENTRY_DELIMITER_CHAR);
 	if (!(methodsStringFormat == ""))
 	{
 		return HTTPStatusCodes::success(methodsStringFormat);
@@ -165,9 +162,9 @@ std::string DatabaseRequestHandler::handleCheckRequest(std::vector<Hash> hashes)
 	}
 }
 
-std::vector<MethodOut> DatabaseRequestHandler::getMethods(std::vector<Hash> hashes)
+MethodTable DatabaseRequestHandler::getMethods(const std::vector<Hash> &hashes)
 {
-	std::vector<std::future<std::vector<MethodOut>>> results;
+	std::vector<std::future<MethodTable>> results;
 	std::vector<std::thread> threads;
 	std::queue<Hash> hashQueue;
 	std::mutex queueLock;
@@ -177,12 +174,12 @@ std::vector<MethodOut> DatabaseRequestHandler::getMethods(std::vector<Hash> hash
 	}
 	for (int i = 0; i < MAX_THREADS; i++)
 	{
-		std::packaged_task<std::vector<MethodOut>()> task(
+		std::packaged_task<MethodTable()> task(
 			bind(&DatabaseRequestHandler::singleHashToMethodsThread, this, ref(hashQueue), ref(queueLock)));
 		if (errno != 0)
 		{
 			errno = ENETUNREACH;
-			return {};
+			return MethodTable();
 		}
 		results.push_back(task.get_future());
 		threads.push_back(std::thread(move(task)));
@@ -191,23 +188,28 @@ std::vector<MethodOut> DatabaseRequestHandler::getMethods(std::vector<Hash> hash
 	{
 		threads[i].join();
 	}
-	std::vector<MethodOut> methods = {};
+	// Room for the methods of all threads is reserved first, so merging their tables does not grow it repeatedly.
+	std::vector<MethodTable> tables;
+	size_t amount = 0;
+	size_t bytes = 0;
 	for (int i = 0; i < results.size(); i++)
 	{
-		std::vector<MethodOut> newMethods = results[i].get();
-
-		for (int j = 0; j < newMethods.size(); j++)
-		{
-			methods.push_back(newMethods[j]);
-		}
+		tables.push_back(results[i].get());
+		amount += tables.back().size();
+		bytes += tables.back().textSize();
+	}
+	MethodTable methods;
+	methods.reserve(amount, bytes);
+	for (const MethodTable &table : tables)
+	{
+		methods.append(table);
 	}
 	return methods;
 }
 
-std::vector<MethodOut> DatabaseRequestHandler::singleHashToMethodsThread(std::queue<Hash> &hashes,
-																		 std::mutex &queueLock)
+MethodTable DatabaseRequestHandler::singleHashToMethodsThread(std::queue<Hash> &hashes, std::mutex &queueLock)
 {
-	std::vector<MethodOut> methods;
+	MethodTable methods;
 	while (true)
 	{
 		queueLock.lock();
@@ -223,66 +225,30 @@ std::vector<MethodOut> DatabaseRequestHandler::singleHashToMethodsThread(std::qu
 		if (errno != 0)
 		{
 			errno = ENETUNREACH;
-			return {};
+			return MethodTable();
 		}
 		for (int j = 0; j < newMethods.size(); j++)
 		{
-			methods.push_back(newMethods[j]);
+			methods.append(newMethods[j]);
 		}
 	}
 }
 
-std::string DatabaseRequestHandler::methodsToString(std::vector<MethodOut> methods, char dataDelimiter,
-													char methodDelimiter)
+std::string DatabaseRequestHandler::handleGetMethodsByAuthorRequest(const std::string &request)
 {
-	std::vector<char> chars = {};
-	while (!methods.empty())
-	{
-		MethodOut lastMethod = methods.back();
-		Hash hash = lastMethod.hash;
-		std::string projectID = std::to_string(lastMethod.projectID);
-		std::string startVersion = std::to_string(lastMethod.startVersion);
-		Hash startVersionHash = lastMethod.startVersionHash;
-		std::string endVersion = std::to_string(lastMethod.endVersion);
-		Hash endVersionHash = lastMethod.endVersionHash;
-		std::string name = lastMethod.methodName;
-		File fileLocation = lastMethod.fileLocation;
-		std::string lineNumber = std::to_string(lastMethod.lineNumber);
-		std::vector<AuthorID> authorIDs = lastMethod.authorIDs;
-		std::string authorTotal = std::to_string(authorIDs.size());
-		std::string parserVersion = std::to_string(lastMethod.parserVersion);
-		std::string vulnCode = lastMethod.vulnCode;
-		std::string license = lastMethod.license;
-		// We initialize dataElements, which consists of the hash, projectID, version, name, fileLocation, lineNumber,
-		// authorTotal and all the authorIDs.
-		std::vector<std::string> dataElements = {hash,		 projectID,		 startVersion, startVersionHash,
-												 endVersion, endVersionHash, name,		   fileLocation,
-												 lineNumber, parserVersion,	 vulnCode,	   license,		authorTotal};
-		dataElements.insert(std::end(dataElements), std::begin(authorIDs), std::end(authorIDs));
-
-		// Append 'chars' by the special dataElements separated by special characters.
-		Utility::appendBy(chars, dataElements, dataDelimiter, methodDelimiter);
-		methods.pop_back();
-	}
-	std::string result(chars.begin(), chars.end()); // Converts the vector of chars to a string.
-	return result;
-}
-
-std::string DatabaseRequestHandler::handleGetMethodsByAuthorRequest(std::string request)
-{
-	std::vector<AuthorID> authorIDs = Utility::splitStringOn(request, ENTRY_DELIMITER_CHAR);
-	std::regex re(UUID_REGEX);
+	std::vector<std::string> data = Utility::splitStringOn(request, ENTRY_DELIMITER_CHAR);
+	std::vector<Hash> authorIDs(data.size());
 
-	for (int i = 0; i < authorIDs.size(); i++)
+	for (int i = 0; i < data.size(); i++)
 	{
-		if (!regex_match(authorIDs[i], re))
+		if (!Hash::parseUuid(data[i], authorIDs[i]))
 		{
-			return HTTPStatusCodes::clientError("Error parsing author id: " + authorIDs[i]);
+			return HTTPStatusCodes::clientError("Error parsing author id: " + data[i]);
 		}
 	}
 
 	// Request the specified hashes.
-	std::vector<std::pair<MethodID, AuthorID>> methods = getMethodsByAuthor(authorIDs);
+	std::vector<std::pair<MethodID, Hash>> methods = getMethodsByAuthor(authorIDs);
 	if (errno != 0)
 	{
 		return HTTPStatusCodes::serverError("Unable to get methods from database.");
@@ -300,11 +266,96 @@ std::string DatabaseRequestHandler::handleGetMethodsByAuthorRequest(std::string
 	}
 }
 
-std::vector<std::pair<MethodID, AuthorID>> DatabaseRequestHandler::getMethodsByAuthor(std::vector<AuthorID> authorIDs)
+std::string DatabaseRequestHandler::handleGetMethodsByAuthorPageRequest(const std::string &request)
+{
+	errno = 0;
+	std::vector<std::string> data = Utility::splitStringOn(request, FIELD_DELIMITER_CHAR);
+	if (data.empty() || data.size() > 3)
+	{
+		errno = EILSEQ;
+		return HTTPStatusCodes::clientError(
+			"The request failed. It should consist of an author id, optionally followed by a page size and a "
+			"continuation token.");
+	}
+	Hash authorID;
+	if (!Hash::parseUuid(data[0], authorID))
+	{
+		errno = EILSEQ;
+		return HTTPStatusCodes::clientError("Error parsing author id: " + data[0]);
+	}
+
+	int pageSize = METHODS_PAGE_SIZE;
+	if (data.size() > 1 && data[1] != "")
+	{
+		pageSize = Utility::safeStoi(data[1]);
+		if (errno != 0 || pageSize <= 0 || pageSize > METHODS_PAGE_SIZE_MAX)
+		{
+			errno = EILSEQ;
+			return HTTPStatusCodes::clientError("The page size should be an integer between 1 and " +
+												std::to_string(METHODS_PAGE_SIZE_MAX) + ".");
+		}
+	}
+
+	std::string pagingState;
+	if (data.size() > 2 && data[2] != "" && !parseContinuationToken(authorID, data[2], pagingState))
+	{
+		errno = EILSEQ;
+		return HTTPStatusCodes::clientError("Error parsing continuation token: " + data[2]);
+	}
+
+	std::vector<MethodID> methods = authorToMethodsPageWithRetry(authorID, pageSize, pagingState);
+	if (errno != 0)
+	{
+		return HTTPStatusCodes::serverError("Unable to get methods from database.");
+	}
+
+	// The entries are converted starting at the back, so they are added in reverse to keep the order of the page.
+	std::vector<std::pair<MethodID, Hash>> entries;
+	entries.reserve(methods.size());
+	for (int i = methods.size() - 1; i >= 0; i--)
+	{
+		entries.push_back(std::make_pair(methods[i], authorID));
+	}
+	return HTTPStatusCodes::success(toContinuationToken(authorID, pagingState) + ENTRY_DELIMITER_CHAR +
+									methodIDsToString(std::move(entries)));
+}
+
+std::string DatabaseRequestHandler::toContinuationToken(const Hash &authorID, const std::string &pagingState)
+{
+	if (pagingState.empty())
+	{
+		return "";
+	}
+	return Hash::bytesToHex(pagingState) +
+		   md5(authorID.toString() + pagingState).substr(0, CONTINUATION_CHECKSUM_LENGTH);
+}
+
+bool DatabaseRequestHandler::parseContinuationToken(const Hash &authorID, std::string_view token,
+													std::string &pagingState)
+{
+	std::string bytes;
+	if (token.size() <= CONTINUATION_CHECKSUM_LENGTH ||
+		!Hash::hexToBytes(token.substr(0, token.size() - CONTINUATION_CHECKSUM_LENGTH), bytes))
+	{
+		return false;
+	}
+
+	// The checksum is compared in lowercase, like it is given out.
+	std::string checksum;
+	if (!Hash::hexToBytes(token.substr(token.size() - CONTINUATION_CHECKSUM_LENGTH), checksum) ||
+		Hash::bytesToHex(checksum) != md5(authorID.toString() + bytes).substr(0, CONTINUATION_CHECKSUM_LENGTH))
+	{
+		return false;
+	}
+	pagingState = std::move(bytes);
+	return true;
+}
+
+std::vector<std::pair<MethodID, Hash>> DatabaseRequestHandler::getMethodsByAuthor(const std::vector<Hash> &authorIDs)
 {
-	std::vector<std::future<std::vector<std::pair<MethodID, AuthorID>>>> results;
+	std::vector<std::future<std::vector<std::pair<MethodID, Hash>>>> results;
 	std::vector<std::thread> threads;
-	std::queue<AuthorID> idQueue;
+	std::queue<Hash> idQueue;
 	std::mutex queueLock;
 	for (int i = 0; i < authorIDs.size(); i++)
 	{
@@ -312,7 +363,7 @@ std::vector<std::pair<MethodID, AuthorID>> DatabaseRequestHandler::getMethodsByA
 	}
 	for (int i = 0; i < MAX_THREADS; i++)
 	{
-		std::packaged_task<std::vector<std::pair<MethodID, AuthorID>>()> task(
+		std::packaged_task<std::vector<std::pair<MethodID, Hash>>()> task(
 			bind(&DatabaseRequestHandler::singleAuthorToMethodsThread, this, ref(idQueue), ref(queueLock)));
 		if (errno != 0)
 		{
@@ -326,10 +377,10 @@ std::vector<std::pair<MethodID, AuthorID>> DatabaseRequestHandler::getMethodsByA
 	{
 		threads[i].join();
 	}
-	std::vector<std::pair<MethodID, AuthorID>> methods = {};
+	std::vector<std::pair<MethodID, Hash>> methods = {};
 	for (int i = 0; i < results.size(); i++)
 	{
-		std::vector<std::pair<MethodID, AuthorID>> newMethods = results[i].get();
+		std::vector<std::pair<MethodID, Hash>> newMethods = results[i].get();
 
 		for (int j = 0; j < newMethods.size(); j++)
 		{
@@ -339,10 +390,10 @@ std::vector<std::pair<MethodID, AuthorID>> DatabaseRequestHandler::getMethodsByA
 	return methods;
 }
 
-std::vector<std::pair<MethodID, AuthorID>>
-DatabaseRequestHandler::singleAuthorToMethodsThread(std::queue<AuthorID> &authorIDs, std::mutex &queueLock)
+std::vector<std::pair<MethodID, Hash>>
+DatabaseRequestHandler::singleAuthorToMethodsThread(std::queue<Hash> &authorIDs, std::mutex &queueLock)
 {
-	std::vector<std::pair<MethodID, AuthorID>> methods;
+	std::vector<std::pair<MethodID, Hash>> methods;
 	while (true)
 	{
 		queueLock.lock();
@@ -351,7 +402,7 @@ DatabaseRequestHandler::singleAuthorToMethodsThread(std::queue<AuthorID> &author
 			queueLock.unlock();
 			return methods;
 		}
-		AuthorID authorID = authorIDs.front();
+		Hash authorID = authorIDs.front();
 		authorIDs.pop();
 		queueLock.unlock();
 		std::vector<MethodID> newMethods = authorToMethodsWithRetry(authorID);
@@ -362,21 +413,21 @@ DatabaseRequestHandler::singleAuthorToMethodsThread(std::queue<AuthorID> &author
 		}
 		for (int j = 0; j < newMethods.size(); j++)
 		{
-			methods.push_back(make_pair(newMethods[j], authorID));
+			methods.push_back(std::make_pair(newMethods[j], authorID));
 		}
 	}
 }
 
-std::string DatabaseRequestHandler::methodIDsToString(std::vector<std::pair<MethodID, AuthorID>> methods)
+std::string DatabaseRequestHandler::methodIDsToString(std::vector<std::pair<MethodID, Hash>> methods)
 {
 	std::vector<char> chars = {};
 	while (!methods.empty())
 	{
-		std::pair<MethodID, AuthorID> lastMethod = methods.back();
-		Hash hash = lastMethod.first.hash;
+		std::pair<MethodID, Hash> lastMethod = methods.back();
+		std::string hash = lastMethod.first.hash.toString();
 		std::string projectID = std::to_string(lastMethod.first.projectID);
 		std::string startVersion = std::to_string(lastMethod.first.startVersion);
-		AuthorID authorID = lastMethod.second;
+		AuthorID authorID = lastMethod.second.toUuidString();
 
 		// We initialize dataElements, which consists of the authorID, hash, projectID and startVersion.
 		std::vector<std::string> dataElements = {authorID, hash, projectID, startVersion};
@@ -401,26 +452,102 @@ std::string DatabaseRequestHandler::methodIDsToString(std::vector<std::pair<Meth
 	return result;
 }
 
-std::tuple<> DatabaseRequestHandler::addMethodWithRetry(MethodIn method, ProjectIn project, long long prevVersion,
-														long long parserVersion, bool newProject)
+std::tuple<> DatabaseRequestHandler::addMethodWithRetry(const MethodIn &method, const ProjectIn &project,
+														long long prevVersion, long long parserVersion, bool newProject)
 {
-	std::function<std::tuple<>()> function = [method, project, prevVersion, parserVersion, newProject, this]() {
+	std::function<std::tuple<>()> function = [&method, &project, prevVersion, parserVersion, newProject, this]() {
 		this->database->addMethod(method, project, prevVersion, parserVersion, newProject);
 		return std::make_tuple();
 	};
+	std::tuple<> result = Utility::queryWithRetry<std::tuple<>>(function);
+	int error = errno;
+	methodCache.invalidate(method.hash);
+	negativeCache.invalidate(method.hash);
+	errno = error;
+	return result;
+}
+
+std::tuple<> DatabaseRequestHandler::addAuthorsWithRetry(const std::vector<Author> &authors)
+{
+	std::function<std::tuple<>()> function = [&authors, this]() {
+		this->database->addAuthors(authors);
+		return std::make_tuple();
+	};
 	return Utility::queryWithRetry<std::tuple<>>(function);
 }
 
 std::vector<MethodOut> DatabaseRequestHandler::hashToMethodsWithRetry(Hash hash)
 {
-	std::function<std::vector<MethodOut>()> function = [hash, this]() { return this->database->hashToMethods(hash); };
-	return Utility::queryWithRetry<std::vector<MethodOut>>(function);
+	std::vector<MethodOut> methods;
+	bool unknown = negativeCache.contains(hash);
+	if (stats != nullptr)
+	{
+		stats->negativeCacheCounter->Add({{"Node", stats->myIP}, {"Result", unknown ? "hit" : "miss"}}).Increment();
+	}
+	if (unknown)
+	{
+		errno = 0;
+		return methods;
+	}
+
+	bool hit = methodCache.get(hash, methods);
+	if (stats != nullptr)
+	{
+		stats->methodCacheCounter->Add({{"Node", stats->myIP}, {"Result", hit ? "hit" : "miss"}}).Increment();
+	}
+	if (hit)
+	{
+		errno = 0;
+		return methods;
+	}
+
+	long long lookupStart = Utility::getCurrentTimeMilliSeconds();
+	std::function<std::vector<MethodOut>()> lookup = [hash, this]() {
+		std::function<std::vector<MethodOut>()> function = [hash, this]() {
+			return this->database->hashToMethods(hash);
+		};
+		return Utility::queryWithRetry<std::vector<MethodOut>>(function);
+	};
+	bool shared;
+	methods = hashLookups.call(hash, lookup, shared);
+	if (shared && stats != nullptr)
+	{
+		stats->coalescedLookupCounter->Add({{"Node", stats->myIP}}).Increment();
+	}
+	// Only the caller which did the lookup knows when it started, callers sharing its result started later.
+	if (errno != 0 || shared)
+	{
+		return methods;
+	}
+	if (methods.empty())
+	{
+		negativeCache.put(hash, lookupStart);
+		if (stats != nullptr)
+		{
+			stats->negativeCacheSize->Add({{"Node", stats->myIP}}).Set(negativeCache.size());
+			stats->negativeCacheBytes->Add({{"Node", stats->myIP}}).Set(negativeCache.bytes());
+		}
+	}
+	else
+	{
+		methodCache.put(hash, methods, lookupStart);
+	}
+	return methods;
 }
 
-std::vector<MethodID> DatabaseRequestHandler::authorToMethodsWithRetry(AuthorID authorID)
+std::vector<MethodID> DatabaseRequestHandler::authorToMethodsWithRetry(Hash authorID)
 {
 	std::function<std::vector<MethodID>()> function = [authorID, this]() {
 		return this->database->authorToMethods(authorID);
 	};
 	return Utility::queryWithRetry<std::vector<MethodID>>(function);
 }
+
+std::vector<MethodID> DatabaseRequestHandler::authorToMethodsPageWithRetry(const Hash &authorID, int pageSize,
+																		   std::string &pagingState)
+{
+	std::function<std::vector<MethodID>()> function = [&authorID, pageSize, &pagingState, this]() {
+		return this->database->authorToMethodsPage(authorID, pageSize, pagingState);
+	};
+	return Utility::queryWithRetry<std::vector<MethodID>>(function);
+}
@@ -5,15 +5,16 @@ Utrecht University within the Software Project course.
 */
 
 #include "Definitions.h"
+#include "CountingResource.h"
 #include "DatabaseRequestHandler.h"
 #include "HTTPStatus.h"
 #include "Utility.h"
 
+#include <algorithm>
 #include <future>
 #include <thread>
-#include <regex>
 
-std::string DatabaseRequestHandler::handleCheckUploadRequest(std::string request, std::string client)
+std::string DatabaseRequestHandler::handleCheckUploadRequest(const std::string &request, const std::string &client)
 {
 	std::vector<Hash> hashes = requestToHashes(request);
 	if (errno != 0)
@@ -55,11 +56,18 @@ std::string DatabaseRequestHandler::handleCheckUploadRequest(std::string request
 	}
 }
 
-std::string DatabaseRequestHandler::handleUploadRequest(std::string request, std::string client)
+std::string DatabaseRequestHandler::handleUploadRequest(const std::string &request, const std::string &client)
 {
-	std::vector<std::string> dataEntries = Utility::splitStringOn(request, ENTRY_DELIMITER_CHAR);
+	// The lines and fields of the request are only needed while parsing, so they are views into the request kept in
+	// an arena, which is released at once when the request is done.
+	CountingResource heap;
+	std::pmr::monotonic_buffer_resource arena(&heap);
+	std::pmr::vector<std::string_view> dataEntries(&arena);
+	dataEntries.reserve(std::count(request.begin(), request.end(), ENTRY_DELIMITER_CHAR) + 1);
+	Utility::splitStringOn(request, ENTRY_DELIMITER_CHAR, dataEntries);
+
 	// Check if project is valid.
-	ProjectIn project = requestToProject(dataEntries[0]);
+	ProjectIn project = requestToProject(std::string(dataEntries[0]));
 	if (errno != 0)
 	{
 		// Project could not be parsed.
@@ -71,7 +79,7 @@ std::string DatabaseRequestHandler::handleUploadRequest(std::string request, std
 	bool newProject = true;
 	if (dataEntries[1] != "")
 	{
-		long long prevVersion = Utility::safeStoll(dataEntries[1]);
+		long long prevVersion = Utility::safeStoll(std::string(dataEntries[1]));
 		if (errno != 0)
 		{
 			// Previous version could not be parsed.
@@ -79,8 +87,8 @@ std::string DatabaseRequestHandler::handleUploadRequest(std::string request, std
 		}
 		
 		newProject = false;
-		unchangedFiles = Utility::splitStringOn(dataEntries[2], FIELD_DELIMITER_CHAR);
-		prevProject = database->searchForProject(project.projectID, prevVersion);
+		unchangedFiles = Utility::splitStringOn(std::string(dataEntries[2]), FIELD_DELIMITER_CHAR);
+		prevProject = database->searchForProject(project.projectID, prevVersion, true);
 		if (errno == ERANGE)
 		{
 			return HTTPStatusCodes::serverError("The database does not contain the provided version of the project.");
@@ -92,13 +100,16 @@ std::string DatabaseRequestHandler::handleUploadRequest(std::string request, std
 		}
 	}
 
-	std::queue<MethodIn> methodQueue;
-
-	std::map<std::string, int> extensionOccurences;
+	// Methods of an upload share few authors and files, so their IDs and extensions are only computed once.
+	UploadInterner interner;
+	std::vector<MethodIn> methods;
+	methods.reserve(dataEntries.size());
 
+	std::pmr::vector<std::string_view> methodData(&arena);
+	project.hashes.reserve(dataEntries.size());
 	for (int i = 3; i < dataEntries.size(); i++)
 	{
-		MethodIn method = dataEntryToMethod(dataEntries[i]);
+		MethodIn method = dataEntryToMethod(dataEntries[i], methodData, interner);
 		if (errno != 0)
 		{
 			return HTTPStatusCodes::clientError("Error parsing method " + std::to_string(i-2) + ".");
@@ -109,12 +120,31 @@ std::string DatabaseRequestHandler::handleUploadRequest(std::string request, std
 			stats->vulnCounter->Add({{"Node", stats->myIP}, {"Client", client}}).Increment();
 			stats->addRecentVulnerability(method.vulnCode);
 		}
-		
-		++extensionOccurences[getExtension(method.fileLocation)];
-		methodQueue.push(method);
+
 		project.hashes.push_back(method.hash);
+		methods.push_back(std::move(method));
+	}
+
+	// The IDs of the authors are computed in one batch, instead of one by one while parsing.
+	interner.hashAuthors();
+	interner.setAuthorIDs(methods);
+	std::queue<MethodIn> methodQueue;
+	for (MethodIn &method : methods)
+	{
+		methodQueue.push(std::move(method));
+	}
+
+	if (stats != nullptr)
+	{
+		stats->uploadArenaCounter->Add({{"Node", stats->myIP}, {"Unit", "allocations"}}).Increment(heap.getAllocations());
+		stats->uploadArenaCounter->Add({{"Node", stats->myIP}, {"Unit", "bytes"}}).Increment(heap.getBytes());
 	}
 
+	std::map<std::string, int> extensionOccurences;
+	for (const std::pair<const std::string_view, int> &file : interner.getFiles())
+	{
+		extensionOccurences[getExtension(std::string(file.first))] += file.second;
+	}
 	for (std::pair<std::string, int> extension : extensionOccurences)
 	{
 		stats->methodCounter->Add({{"Node", stats->myIP}, {"Client", client}, {"Extension", extension.first}}).Increment(extension.second);
@@ -126,6 +156,14 @@ std::string DatabaseRequestHandler::handleUploadRequest(std::string request, std
 		return HTTPStatusCodes::serverError("Failed to add project to database.");
 	}
 
+	std::vector<Author> authors = interner.getAuthors();
+	authors.push_back(project.owner);
+	addAuthorsWithRetry(authors);
+	if (errno != 0)
+	{
+		return HTTPStatusCodes::serverError("Failed to add authors to database.");
+	}
+
 	handleUploadThreads(project, methodQueue, newProject, prevProject, unchangedFiles);
 	if (errno != 0)
 	{
@@ -134,8 +172,9 @@ std::string DatabaseRequestHandler::handleUploadRequest(std::string request, std
 	return HTTPStatusCodes::success("Your project has been successfully added to the database.");
 }
 
-void DatabaseRequestHandler::handleUploadThreads(ProjectIn project, std::queue<MethodIn> methodQueue, bool newProject,
-												 ProjectOut prevProject, std::vector<std::string> unchangedFiles)
+void DatabaseRequestHandler::handleUploadThreads(const ProjectIn &project, std::queue<MethodIn> &methodQueue,
+												 bool newProject, const ProjectOut &prevProject,
+												 const std::vector<std::string> &unchangedFiles)
 {
 	std::mutex queueLock;
 	std::vector<std::thread> threads;
@@ -144,13 +183,13 @@ void DatabaseRequestHandler::handleUploadThreads(ProjectIn project, std::queue<M
 		if (newProject)
 		{
 			threads.push_back(std::thread(&DatabaseRequestHandler::singleUploadThread, this, ref(methodQueue),
-										  ref(queueLock), project, -1, project.parserVersion, newProject));
+										  ref(queueLock), std::cref(project), -1, project.parserVersion, newProject));
 		}
 		else
 		{
 			threads.push_back(std::thread(&DatabaseRequestHandler::singleUploadThread, this, ref(methodQueue),
-										  ref(queueLock), project, prevProject.version, project.parserVersion,
-										  newProject));
+										  ref(queueLock), std::cref(project), prevProject.version,
+										  project.parserVersion, newProject));
 		}
 		if (errno != 0)
 		{
@@ -169,8 +208,8 @@ void DatabaseRequestHandler::handleUploadThreads(ProjectIn project, std::queue<M
 	}
 }
 
-void DatabaseRequestHandler::handleUpdateUnchangedFilesThreads(ProjectIn project, ProjectOut prevProject,
-															   std::vector<std::string> unchangedFiles)
+void DatabaseRequestHandler::handleUpdateUnchangedFilesThreads(const ProjectIn &project, const ProjectOut &prevProject,
+															   const std::vector<std::string> &unchangedFiles)
 {
 	std::queue<std::pair<std::vector<Hash>, std::vector<std::string>>> hashFileQueue;
 	std::vector<std::vector<Hash>> hashesList = toChunks(prevProject.hashes, HASHES_MAX_SIZE);
@@ -184,7 +223,7 @@ void DatabaseRequestHandler::handleUpdateUnchangedFilesThreads(ProjectIn project
 	for (int i = 0; i < MAX_THREADS; i++)
 	{
 		std::packaged_task<std::vector<Hash>()> task(bind(&DatabaseRequestHandler::singleUpdateUnchangedFilesThread,
-														  this, ref(hashFileQueue), ref(queueLock), project,
+														  this, ref(hashFileQueue), ref(queueLock), std::cref(project),
 														  prevProject.version));
 		if (errno != 0)
 		{
@@ -210,13 +249,17 @@ void DatabaseRequestHandler::handleUpdateUnchangedFilesThreads(ProjectIn project
 		}
 	}
 
-	project.hashes = unchangedHashes;
-	database->addHashToProject(project, 0);
+	// Only the key of the project is needed to add the hashes of the unchanged methods to it.
+	ProjectIn unchangedProject;
+	unchangedProject.projectID = project.projectID;
+	unchangedProject.version = project.version;
+	unchangedProject.hashes = std::move(unchangedHashes);
+	database->addHashToProject(unchangedProject, 0);
 }
 
 std::vector<Hash> DatabaseRequestHandler::singleUpdateUnchangedFilesThread(
 	std::queue<std::pair<std::vector<Hash>, std::vector<std::string>>> &hashFiles, std::mutex &queueLock,
-	ProjectIn project, long long prevVersion)
+	const ProjectIn &project, long long prevVersion)
 {
 	std::vector<Hash> hashes;
 	while (true)
@@ -227,7 +270,7 @@ std::vector<Hash> DatabaseRequestHandler::singleUpdateUnchangedFilesThread(
 			queueLock.unlock();
 			return hashes;
 		}
-		std::pair<std::vector<Hash>, std::vector<std::string>> hashFile = hashFiles.front();
+		std::pair<std::vector<Hash>, std::vector<std::string>> hashFile = std::move(hashFiles.front());
 		hashFiles.pop();
 		queueLock.unlock();
 		std::vector<Hash> unchangedHashes = updateUnchangedFilesWithRetry(hashFile, project, prevVersion);
@@ -244,18 +287,23 @@ std::vector<Hash> DatabaseRequestHandler::singleUpdateUnchangedFilesThread(
 }
 
 std::vector<Hash>
-DatabaseRequestHandler::updateUnchangedFilesWithRetry(std::pair<std::vector<Hash>, std::vector<File>> hashFile,
-													  ProjectIn project, long long prevVersion)
+DatabaseRequestHandler::updateUnchangedFilesWithRetry(const std::pair<std::vector<Hash>, std::vector<File>> &hashFile,
+													  const ProjectIn &project, long long prevVersion)
 {
-	std::vector<Hash> hash = hashFile.first;
-	std::vector<File> file = hashFile.second;
-	std::function<std::vector<Hash>()> function = [hash, file, project, prevVersion, this]() {
-		return this->database->updateUnchangedFiles(hash, file, project, prevVersion);
+	std::function<std::vector<Hash>()> function = [&hashFile, &project, prevVersion, this]() {
+		return this->database->updateUnchangedFiles(hashFile.first, hashFile.second, project, prevVersion);
 	};
-	return Utility::queryWithRetry<std::vector<Hash>>(function);
+	std::vector<Hash> updatedHashes = Utility::queryWithRetry<std::vector<Hash>>(function);
+	int error = errno;
+	for (Hash updatedHash : updatedHashes)
+	{
+		methodCache.invalidate(updatedHash);
+	}
+	errno = error;
+	return updatedHashes;
 }
 
-ProjectIn DatabaseRequestHandler::requestToProject(std::string request)
+ProjectIn DatabaseRequestHandler::requestToProject(const std::string &request)
 {
 	errno = 0;
 	// We retrieve the project information (projectData).
@@ -361,7 +409,7 @@ std::vector<ProjectOut> DatabaseRequestHandler::getPrevProjects(std::queue<Proje
 	return projects;
 }
 
-std::string DatabaseRequestHandler::handleExtractProjectsRequest(std::string request)
+std::string DatabaseRequestHandler::handleExtractProjectsRequest(const std::string &request)
 {
 	errno = 0;
 	std::vector<std::string> projectsData = Utility::splitStringOn(request, ENTRY_DELIMITER_CHAR);
@@ -401,7 +449,7 @@ std::string DatabaseRequestHandler::handleExtractProjectsRequest(std::string req
 	return HTTPStatusCodes::success(projectsToString(projects, FIELD_DELIMITER_CHAR, ENTRY_DELIMITER_CHAR));
 }
 
-std::string DatabaseRequestHandler::handlePrevProjectsRequest(std::string request)
+std::string DatabaseRequestHandler::handlePrevProjectsRequest(const std::string &request)
 {
 	errno = 0;
 	std::vector<std::string> projectsData = Utility::splitStringOn(request, ENTRY_DELIMITER_CHAR);
@@ -523,21 +571,25 @@ std::string DatabaseRequestHandler::projectsToString(std::vector<ProjectOut> pro
 	}
 }
 
-bool DatabaseRequestHandler::tryUploadProjectWithRetry(ProjectIn project)
+bool DatabaseRequestHandler::tryUploadProjectWithRetry(const ProjectIn &project)
 {
-	std::function<bool()> function = [project, this]() { return this->database->addProject(project); };
+	std::function<bool()> function = [&project, this]() { return this->database->addProject(project); };
 	return Utility::queryWithRetry<bool>(function);
 }
 
 ProjectOut DatabaseRequestHandler::searchForProjectWithRetry(ProjectID projectID, Version version)
 {
-	std::function<ProjectOut()> function = 
-		[projectID, version, this]() { return this->database->searchForProject(projectID, version); };
+	// Only the metadata is returned, so the hashes of the project, which can be many, are not read.
+	std::function<ProjectOut()> function = [projectID, version, this]() {
+		return this->database->searchForProject(projectID, version, false);
+	};
 	return Utility::queryWithRetry<ProjectOut>(function);
 }
 
 ProjectOut DatabaseRequestHandler::getPrevProjectWithRetry(ProjectID projectID)
 {
-	std::function<ProjectOut()> function = [projectID, this]() { return this->database->prevProject(projectID); };
+	std::function<ProjectOut()> function = [projectID, this]() {
+		return this->database->prevProject(projectID, false);
+	};
 	return Utility::queryWithRetry<ProjectOut>(function);
 }
\ No newline at end of file
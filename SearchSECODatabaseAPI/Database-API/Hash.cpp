@@ -0,0 +1,263 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "Hash.h"
+
+#include <array>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace types;
+
+#ifdef __SSE2__
+/// <summary>
+/// Converts 16 hex characters to 8 bytes, in the low byte of each 16-bit lane.
+/// </summary>
+/// <returns> False if one of the characters is not a lowercase hex character. </returns>
+static bool decodeHex(__m128i characters, __m128i &result)
+{
+	// Bytes below zero wrap around, so one unsigned comparison checks both bounds.
+	__m128i digits = _mm_sub_epi8(characters, _mm_set1_epi8('0'));
+	__m128i letters = _mm_sub_epi8(characters, _mm_set1_epi8('a'));
+	__m128i isDigit = _mm_cmpeq_epi8(_mm_max_epu8(digits, _mm_set1_epi8(9)), _mm_set1_epi8(9));
+	__m128i isLetter = _mm_cmpeq_epi8(_mm_max_epu8(letters, _mm_set1_epi8(5)), _mm_set1_epi8(5));
+	if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xFFFF)
+	{
+		return false;
+	}
+	__m128i values = _mm_or_si128(_mm_and_si128(isDigit, digits),
+								  _mm_and_si128(isLetter, _mm_add_epi8(letters, _mm_set1_epi8(10))));
+
+	// The even characters are the high halves of the bytes.
+	__m128i high = _mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x00FF)), 4);
+	__m128i low = _mm_srli_epi16(values, 8);
+	result = _mm_or_si128(high, low);
+	return true;
+}
+
+/// <summary>
+/// Converts 16 values between 0 and 15 to their hex characters.
+/// </summary>
+static __m128i encodeHex(__m128i values)
+{
+	__m128i isLetter = _mm_cmpgt_epi8(values, _mm_set1_epi8(9));
+	__m128i characters = _mm_add_epi8(values, _mm_set1_epi8('0'));
+	return _mm_add_epi8(characters, _mm_and_si128(isLetter, _mm_set1_epi8('a' - '0' - 10)));
+}
+#else
+/// <summary>
+/// Returns the value of a lowercase hex character, or -1 if it is not one.
+/// </summary>
+static int hexValue(char character)
+{
+	if (character >= '0' && character <= '9')
+	{
+		return character - '0';
+	}
+	if (character >= 'a' && character <= 'f')
+	{
+		return character - 'a' + 10;
+	}
+	return -1;
+}
+#endif
+
+/// <summary>
+/// The value of every character as a hex digit of either case, or 0xFF if it is not one.
+/// </summary>
+static constexpr std::array<uint8_t, 256> hexValues = []() {
+	std::array<uint8_t, 256> values = {};
+	for (int i = 0; i < 256; i++)
+	{
+		values[i] = 0xFF;
+	}
+	for (int i = 0; i < 10; i++)
+	{
+		values['0' + i] = i;
+	}
+	for (int i = 0; i < 6; i++)
+	{
+		values['a' + i] = 10 + i;
+		values['A' + i] = 10 + i;
+	}
+	return values;
+}();
+
+/// <summary>
+/// The position in a UUID of the first hex character of each byte, skipping the dashes.
+/// </summary>
+static constexpr uint8_t uuidPositions[HASH_BYTES] = {0, 2, 4, 6, 9, 11, 14, 16, 19, 21, 24, 26, 28, 30, 32, 34};
+
+Hash::Hash() : bytes{}
+{
+}
+
+Hash::Hash(const char *hex) : bytes{}
+{
+	size_t length = std::strlen(hex);
+	if (length == UUID_LENGTH)
+	{
+		parseUuid(hex, length, *this);
+	}
+	else
+	{
+		parse(hex, length, *this);
+	}
+}
+
+Hash::Hash(const std::string &hex) : bytes{}
+{
+	parse(hex, *this);
+}
+
+bool Hash::parse(const char *hex, size_t length, Hash &hash)
+{
+	if (length != HASH_HEX_LENGTH)
+	{
+		return false;
+	}
+#ifdef __SSE2__
+	__m128i first, second;
+	if (!decodeHex(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hex)), first) ||
+		!decodeHex(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hex + 16)), second))
+	{
+		return false;
+	}
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(hash.bytes), _mm_packus_epi16(first, second));
+#else
+	uint8_t bytes[HASH_BYTES];
+	for (int i = 0; i < HASH_BYTES; i++)
+	{
+		int high = hexValue(hex[2 * i]);
+		int low = hexValue(hex[2 * i + 1]);
+		if (high < 0 || low < 0)
+		{
+			return false;
+		}
+		bytes[i] = high << 4 | low;
+	}
+	std::memcpy(hash.bytes, bytes, HASH_BYTES);
+#endif
+	return true;
+}
+
+bool Hash::parse(const std::string &hex, Hash &hash)
+{
+	return parse(hex.data(), hex.size(), hash);
+}
+
+bool Hash::parseUuid(const char *uuid, size_t length, Hash &hash)
+{
+	if (length != UUID_LENGTH)
+	{
+		return false;
+	}
+
+	// All characters are looked up without branching, only the combined result is checked. Valid hex characters
+	// have values below 16, so any invalid character sets one of the high bits.
+	uint8_t bytes[HASH_BYTES];
+	uint8_t invalid = 0;
+	for (int i = 0; i < HASH_BYTES; i++)
+	{
+		uint8_t high = hexValues[(uint8_t)uuid[uuidPositions[i]]];
+		uint8_t low = hexValues[(uint8_t)uuid[uuidPositions[i] + 1]];
+		invalid |= high | low;
+		bytes[i] = high << 4 | low;
+	}
+	bool dashes = (uuid[8] == '-') & (uuid[13] == '-') & (uuid[18] == '-') & (uuid[23] == '-');
+	if (!dashes || (invalid & 0xF0) != 0)
+	{
+		return false;
+	}
+	std::memcpy(hash.bytes, bytes, HASH_BYTES);
+	return true;
+}
+
+bool Hash::parseUuid(const std::string &uuid, Hash &hash)
+{
+	return parseUuid(uuid.data(), uuid.size(), hash);
+}
+
+std::string Hash::bytesToHex(std::string_view bytes)
+{
+	const char *characters = "0123456789abcdef";
+	std::string hex(2 * bytes.size(), '0');
+	for (size_t i = 0; i < bytes.size(); i++)
+	{
+		uint8_t byte = bytes[i];
+		hex[2 * i] = characters[byte >> 4];
+		hex[2 * i + 1] = characters[byte & 0x0F];
+	}
+	return hex;
+}
+
+bool Hash::hexToBytes(std::string_view hex, std::string &bytes)
+{
+	if (hex.size() % 2 != 0)
+	{
+		return false;
+	}
+	std::string result(hex.size() / 2, '\0');
+	uint8_t invalid = 0;
+	for (size_t i = 0; i < result.size(); i++)
+	{
+		uint8_t high = hexValues[(uint8_t)hex[2 * i]];
+		uint8_t low = hexValues[(uint8_t)hex[2 * i + 1]];
+		invalid |= high | low;
+		result[i] = high << 4 | low;
+	}
+	if ((invalid & 0xF0) != 0)
+	{
+		return false;
+	}
+	bytes = std::move(result);
+	return true;
+}
+
+void Hash::toHex(char *out) const
+{
+#ifdef __SSE2__
+	__m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes));
+	__m128i high = _mm_and_si128(_mm_srli_epi16(values, 4), _mm_set1_epi8(0x0F));
+	__m128i low = _mm_and_si128(values, _mm_set1_epi8(0x0F));
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(out), encodeHex(_mm_unpacklo_epi8(high, low)));
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), encodeHex(_mm_unpackhi_epi8(high, low)));
+#else
+	const char *characters = "0123456789abcdef";
+	for (int i = 0; i < HASH_BYTES; i++)
+	{
+		out[2 * i] = characters[bytes[i] >> 4];
+		out[2 * i + 1] = characters[bytes[i] & 0x0F];
+	}
+#endif
+}
+
+std::string Hash::toString() const
+{
+	std::string hex(HASH_HEX_LENGTH, '0');
+	toHex(&hex[0]);
+	return hex;
+}
+
+std::string Hash::toUuidString() const
+{
+	char hex[HASH_HEX_LENGTH];
+	toHex(hex);
+	std::string uuid(UUID_LENGTH, '-');
+	for (int i = 0; i < HASH_BYTES; i++)
+	{
+		uuid[uuidPositions[i]] = hex[2 * i];
+		uuid[uuidPositions[i] + 1] = hex[2 * i + 1];
+	}
+	return uuid;
+}
+
+std::ostream &types::operator<<(std::ostream &stream, const Hash &hash)
+{
+	return stream << hash.toString();
+}
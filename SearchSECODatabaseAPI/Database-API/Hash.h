@@ -0,0 +1,120 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#define HASH_BYTES 16
+#define HASH_HEX_LENGTH 32
+#define UUID_LENGTH 36
+
+namespace types
+{
+	/// <summary>
+	/// An MD5 hash stored as its 16 bytes, so it can be copied and compared without allocating.
+	/// In requests and responses it is written as 32 lowercase hex characters.
+	/// </summary>
+	class Hash
+	{
+	  public:
+		/// <summary>
+		/// Constructs the hash of which all bytes are zero.
+		/// </summary>
+		Hash();
+
+		/// <summary>
+		/// Constructs a hash from its hex or UUID form. Should only be used for strings which are known to be valid,
+		/// any other string results in the zero hash. Use parse or parseUuid for input of users.
+		/// </summary>
+		Hash(const char *hex);
+
+		explicit Hash(const std::string &hex);
+
+		/// <summary>
+		/// Converts 32 lowercase hex characters to a hash.
+		/// </summary>
+		/// <returns> False if the characters do not form a valid hash, in which case hash is not changed. </returns>
+		static bool parse(const char *hex, size_t length, Hash &hash);
+
+		static bool parse(const std::string &hex, Hash &hash);
+
+		/// <summary>
+		/// Converts a UUID of the form xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx, with hex characters of either case, to
+		/// the hash with the same hex characters. This is how IDs of authors are written in requests and responses.
+		/// </summary>
+		/// <returns> False if the characters do not form a valid UUID, in which case hash is not changed. </returns>
+		static bool parseUuid(const char *uuid, size_t length, Hash &hash);
+
+		static bool parseUuid(const std::string &uuid, Hash &hash);
+
+		/// <summary>
+		/// Encodes arbitrary bytes as lowercase hex characters, so they can be sent between the delimiters of a
+		/// request.
+		/// </summary>
+		/// <returns> A string twice as long as the input, consisting of hex characters. </returns>
+		static std::string bytesToHex(std::string_view bytes);
+
+		/// <summary>
+		/// Decodes a string of hex characters, of either case, back to the bytes they represent.
+		/// </summary>
+		/// <param name="bytes"> The decoded bytes, only changed if the decoding succeeds. </param>
+		/// <returns> False if the input has an odd length or contains a character that is not a hex character. </returns>
+		static bool hexToBytes(std::string_view hex, std::string &bytes);
+
+		/// <summary>
+		/// Writes the HASH_HEX_LENGTH hex characters of the hash to out, without a terminating null character.
+		/// </summary>
+		void toHex(char *out) const;
+
+		/// <summary>
+		/// Returns the hex form of the hash.
+		/// </summary>
+		std::string toString() const;
+
+		/// <summary>
+		/// Returns the UUID form of the hash, with lowercase hex characters.
+		/// </summary>
+		std::string toUuidString() const;
+
+		bool operator==(const Hash &other) const
+		{
+			return std::memcmp(bytes, other.bytes, HASH_BYTES) == 0;
+		}
+
+		bool operator!=(const Hash &other) const
+		{
+			return !(*this == other);
+		}
+
+		bool operator<(const Hash &other) const
+		{
+			return std::memcmp(bytes, other.bytes, HASH_BYTES) < 0;
+		}
+
+		uint8_t bytes[HASH_BYTES];
+	};
+
+	std::ostream &operator<<(std::ostream &stream, const Hash &hash);
+} // namespace types
+
+namespace std
+{
+	template <> struct hash<types::Hash>
+	{
+		size_t operator()(const types::Hash &hash) const noexcept
+		{
+			// The bytes of an MD5 hash are already uniformly distributed.
+			uint64_t value;
+			std::memcpy(&value, hash.bytes, sizeof(value));
+			return value;
+		}
+	};
+} // namespace std
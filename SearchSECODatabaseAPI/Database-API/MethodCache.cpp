@@ -0,0 +1,239 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "MethodCache.h"
+#include "Utility.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+/// <summary>
+/// Appends a number to the compact form.
+/// </summary>
+template <class T> static void appendNumber(std::string &data, T number)
+{
+	data.append(reinterpret_cast<const char *>(&number), sizeof(T));
+}
+
+/// <summary>
+/// Appends a string to the compact form, preceded by its length.
+/// </summary>
+static void appendString(std::string &data, const std::string &value)
+{
+	appendNumber<uint32_t>(data, value.size());
+	data.append(value);
+}
+
+/// <summary>
+/// Reads a number from the compact form at the given position, and moves the position past it.
+/// </summary>
+template <class T> static T readNumber(const std::string &data, size_t &position)
+{
+	T number;
+	std::memcpy(&number, data.data() + position, sizeof(T));
+	position += sizeof(T);
+	return number;
+}
+
+/// <summary>
+/// Reads a string from the compact form at the given position, and moves the position past it.
+/// </summary>
+static std::string readString(const std::string &data, size_t &position)
+{
+	uint32_t length = readNumber<uint32_t>(data, position);
+	std::string value = data.substr(position, length);
+	position += length;
+	return value;
+}
+
+MethodCache::MethodCache(size_t maxBytes, long long ttl)
+	: maxBytes(maxBytes), ttl(ttl), sketch(METHOD_CACHE_SKETCH_WIDTH * METHOD_CACHE_SKETCH_DEPTH, 0)
+{
+}
+
+bool MethodCache::get(Hash hash, std::vector<MethodOut> &methods)
+{
+	std::unique_lock<std::mutex> lock(mtx);
+	recordAccess(hash);
+	auto it = entries.find(hash);
+	if (it == entries.end())
+	{
+		return false;
+	}
+	if (it->second.expires < Utility::getCurrentTimeMilliSeconds())
+	{
+		remove(it);
+		return false;
+	}
+	recency.splice(recency.begin(), recency, it->second.position);
+	std::string data = it->second.methods;
+	lock.unlock();
+
+	methods = deserialize(data);
+	return true;
+}
+
+void MethodCache::put(Hash hash, const std::vector<MethodOut> &methods, long long lookupStart)
+{
+	std::string data = serialize(methods);
+	size_t size = data.size() + sizeof(Hash) + METHOD_CACHE_ENTRY_OVERHEAD;
+
+	// A single result should not push out many others.
+	if (size > maxBytes / 8)
+	{
+		return;
+	}
+
+	long long currentTime = Utility::getCurrentTimeMilliSeconds();
+	std::lock_guard<std::mutex> lock(mtx);
+	auto invalidation = invalidations.find(hash);
+	if (currentTime - lookupStart >= ttl ||
+		(invalidation != invalidations.end() && invalidation->second >= lookupStart))
+	{
+		return;
+	}
+	auto existing = entries.find(hash);
+	if (existing != entries.end())
+	{
+		remove(existing);
+	}
+
+	// Only make room for the hash if it is requested more often than the hashes it pushes out.
+	int hashFrequency = frequency(hash);
+	while (bytes + size > maxBytes)
+	{
+		auto victim = entries.find(recency.back());
+		if (victim->second.expires >= currentTime && frequency(victim->first) >= hashFrequency)
+		{
+			return;
+		}
+		remove(victim);
+	}
+
+	recency.push_front(hash);
+	entries[hash] = {data, currentTime + ttl, recency.begin()};
+	bytes += size;
+}
+
+void MethodCache::invalidate(Hash hash)
+{
+	long long currentTime = Utility::getCurrentTimeMilliSeconds();
+	std::lock_guard<std::mutex> lock(mtx);
+	auto it = entries.find(hash);
+	if (it != entries.end())
+	{
+		remove(it);
+	}
+
+	// Lookups which started more than ttl ago are not added anyway, so older invalidations can be forgotten.
+	if (invalidations.size() >= METHOD_CACHE_MAX_INVALIDATIONS)
+	{
+		for (auto old = invalidations.begin(); old != invalidations.end();)
+		{
+			old = currentTime - old->second >= ttl ? invalidations.erase(old) : std::next(old);
+		}
+	}
+	invalidations[hash] = currentTime;
+}
+
+std::string MethodCache::serialize(const std::vector<MethodOut> &methods)
+{
+	std::string data;
+	appendNumber<uint32_t>(data, methods.size());
+	for (const MethodOut &method : methods)
+	{
+		appendNumber<Hash>(data, method.hash);
+		appendNumber<ProjectID>(data, method.projectID);
+		appendString(data, method.fileLocation);
+		appendNumber<Version>(data, method.startVersion);
+		appendString(data, method.startVersionHash);
+		appendNumber<Version>(data, method.endVersion);
+		appendString(data, method.endVersionHash);
+		appendString(data, method.methodName);
+		appendNumber<int>(data, method.lineNumber);
+		appendString(data, method.vulnCode);
+		appendNumber<uint32_t>(data, method.authorIDs.size());
+		for (const AuthorID &author : method.authorIDs)
+		{
+			appendString(data, author);
+		}
+		appendNumber<long long>(data, method.parserVersion);
+		appendString(data, method.license);
+	}
+	return data;
+}
+
+std::vector<MethodOut> MethodCache::deserialize(const std::string &data)
+{
+	size_t position = 0;
+	uint32_t amount = readNumber<uint32_t>(data, position);
+	std::vector<MethodOut> methods(amount);
+	for (MethodOut &method : methods)
+	{
+		method.hash = readNumber<Hash>(data, position);
+		method.projectID = readNumber<ProjectID>(data, position);
+		method.fileLocation = readString(data, position);
+		method.startVersion = readNumber<Version>(data, position);
+		method.startVersionHash = readString(data, position);
+		method.endVersion = readNumber<Version>(data, position);
+		method.endVersionHash = readString(data, position);
+		method.methodName = readString(data, position);
+		method.lineNumber = readNumber<int>(data, position);
+		method.vulnCode = readString(data, position);
+		uint32_t authors = readNumber<uint32_t>(data, position);
+		for (uint32_t i = 0; i < authors; i++)
+		{
+			method.authorIDs.push_back(readString(data, position));
+		}
+		method.parserVersion = readNumber<long long>(data, position);
+		method.license = readString(data, position);
+	}
+	return methods;
+}
+
+void MethodCache::recordAccess(const Hash &hash)
+{
+	size_t first = std::hash<Hash>()(hash);
+	size_t second = (first >> 32) | (first << 32) | 1;
+	for (int i = 0; i < METHOD_CACHE_SKETCH_DEPTH; i++)
+	{
+		uint8_t &counter = sketch[i * METHOD_CACHE_SKETCH_WIDTH + (first + i * second) % METHOD_CACHE_SKETCH_WIDTH];
+		if (counter < UINT8_MAX)
+		{
+			counter++;
+		}
+	}
+
+	if (++sketchSamples >= METHOD_CACHE_SKETCH_RESET)
+	{
+		for (uint8_t &counter : sketch)
+		{
+			counter /= 2;
+		}
+		sketchSamples /= 2;
+	}
+}
+
+int MethodCache::frequency(const Hash &hash)
+{
+	size_t first = std::hash<Hash>()(hash);
+	size_t second = (first >> 32) | (first << 32) | 1;
+	int minimum = UINT8_MAX;
+	for (int i = 0; i < METHOD_CACHE_SKETCH_DEPTH; i++)
+	{
+		minimum = std::min(
+			minimum, (int)sketch[i * METHOD_CACHE_SKETCH_WIDTH + (first + i * second) % METHOD_CACHE_SKETCH_WIDTH]);
+	}
+	return minimum;
+}
+
+void MethodCache::remove(std::unordered_map<Hash, Entry>::iterator it)
+{
+	bytes -= it->second.methods.size() + sizeof(Hash) + METHOD_CACHE_ENTRY_OVERHEAD;
+	recency.erase(it->second.position);
+	entries.erase(it);
+}
@@ -0,0 +1,109 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#pragma once
+#include "Types.h"
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define METHOD_CACHE_MAX_BYTES 67108864 // 64 MiB.
+#define METHOD_CACHE_TTL 60000 // Milliseconds a result is kept, as other nodes do not invalidate our cache.
+#define METHOD_CACHE_ENTRY_OVERHEAD 96 // Estimate of the bytes used by an entry besides its data.
+#define METHOD_CACHE_SKETCH_WIDTH 65536
+#define METHOD_CACHE_SKETCH_DEPTH 4
+#define METHOD_CACHE_SKETCH_RESET 655360 // Lookups after which all counters of the sketch are halved.
+#define METHOD_CACHE_MAX_INVALIDATIONS 100000
+
+using namespace types;
+
+/// <summary>
+/// Keeps the methods of often requested hashes in memory, in a compact serialized form.
+/// When the cache is full, a hash is only added if it is requested more often than the least recently used hash,
+/// as estimated by a count-min sketch over all lookups (TinyLFU).
+/// </summary>
+class MethodCache
+{
+public:
+	/// <summary>
+	/// Constructor method.
+	/// </summary>
+	/// <param name="maxBytes"> The amount of memory the cache may use. </param>
+	/// <param name="ttl"> The milliseconds after which a result is no longer used. </param>
+	MethodCache(size_t maxBytes = METHOD_CACHE_MAX_BYTES, long long ttl = METHOD_CACHE_TTL);
+
+	/// <summary>
+	/// Looks up the methods of a hash, and counts the lookup for the admission of the hash.
+	/// </summary>
+	/// <returns> True if the hash was found, in which case methods is set. </returns>
+	bool get(Hash hash, std::vector<MethodOut> &methods);
+
+	/// <summary>
+	/// Adds the methods of a hash as retrieved from the database.
+	/// </summary>
+	/// <param name="lookupStart">
+	/// The time the methods were retrieved at. They are not added if the hash was invalidated since.
+	/// </param>
+	void put(Hash hash, const std::vector<MethodOut> &methods, long long lookupStart);
+
+	/// <summary>
+	/// Removes a hash of which the methods have changed.
+	/// </summary>
+	void invalidate(Hash hash);
+
+	/// <summary>
+	/// Converts methods to their compact form.
+	/// </summary>
+	static std::string serialize(const std::vector<MethodOut> &methods);
+
+	/// <summary>
+	/// Converts methods in their compact form back.
+	/// </summary>
+	static std::vector<MethodOut> deserialize(const std::string &data);
+
+private:
+	struct Entry
+	{
+		std::string methods;
+		long long expires;
+		std::list<Hash>::iterator position;
+	};
+
+	/// <summary>
+	/// Counts a lookup of the hash in the sketch. Should be called while holding mtx.
+	/// </summary>
+	void recordAccess(const Hash &hash);
+
+	/// <summary>
+	/// Estimates how often the hash has been looked up recently. Should be called while holding mtx.
+	/// </summary>
+	int frequency(const Hash &hash);
+
+	/// <summary>
+	/// Removes an entry. Should be called while holding mtx.
+	/// </summary>
+	void remove(std::unordered_map<Hash, Entry>::iterator it);
+
+	size_t maxBytes;
+	long long ttl;
+	size_t bytes = 0;
+
+	std::unordered_map<Hash, Entry> entries;
+	// The hashes from most to least recently used.
+	std::list<Hash> recency;
+
+	// Counters of the count-min sketch, halved after METHOD_CACHE_SKETCH_RESET lookups so old lookups fade out.
+	std::vector<uint8_t> sketch;
+	int sketchSamples = 0;
+
+	// The times at which hashes were invalidated, kept for at least ttl.
+	std::unordered_map<Hash, long long> invalidations;
+	std::mutex mtx;
+};
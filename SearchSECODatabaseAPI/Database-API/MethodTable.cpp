@@ -0,0 +1,189 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "MethodTable.h"
+
+#include <charconv>
+
+#define NUMBER_MAX_LENGTH 20
+
+/// <summary>
+/// Appends a number in decimal form to out, without creating a temporary string.
+/// </summary>
+template <class T> static void appendNumber(std::string &out, T number)
+{
+	char buffer[NUMBER_MAX_LENGTH];
+	char *end = std::to_chars(buffer, buffer + NUMBER_MAX_LENGTH, number).ptr;
+	out.append(buffer, end - buffer);
+}
+
+void MethodTable::reserve(size_t methods, size_t bytes)
+{
+	hashes.reserve(methods);
+	projectIDs.reserve(methods);
+	startVersions.reserve(methods);
+	endVersions.reserve(methods);
+	lineNumbers.reserve(methods);
+	parserVersions.reserve(methods);
+	texts.reserve(methods);
+	authorStarts.reserve(methods);
+	authorCounts.reserve(methods);
+	arena.reserve(bytes);
+}
+
+void MethodTable::append(const MethodOut &method)
+{
+	hashes.push_back(method.hash);
+	projectIDs.push_back(method.projectID);
+	startVersions.push_back(method.startVersion);
+	endVersions.push_back(method.endVersion);
+	lineNumbers.push_back(method.lineNumber);
+	parserVersions.push_back(method.parserVersion);
+
+	std::array<Text, eTextFields> text;
+	text[eStartVersionHash] = addText(method.startVersionHash);
+	text[eEndVersionHash] = addText(method.endVersionHash);
+	text[eMethodName] = addText(method.methodName);
+	text[eFileLocation] = addText(method.fileLocation);
+	text[eVulnCode] = addText(method.vulnCode);
+	text[eLicense] = addText(method.license);
+	texts.push_back(text);
+
+	authorStarts.push_back(authors.size());
+	authorCounts.push_back(method.authorIDs.size());
+	for (const AuthorID &author : method.authorIDs)
+	{
+		authors.push_back(addText(author));
+	}
+}
+
+void MethodTable::append(const MethodTable &other)
+{
+	size_t firstMethod = size();
+	size_t firstAuthor = authors.size();
+	size_t arenaOffset = arena.size();
+
+	hashes.insert(hashes.end(), other.hashes.begin(), other.hashes.end());
+	projectIDs.insert(projectIDs.end(), other.projectIDs.begin(), other.projectIDs.end());
+	startVersions.insert(startVersions.end(), other.startVersions.begin(), other.startVersions.end());
+	endVersions.insert(endVersions.end(), other.endVersions.begin(), other.endVersions.end());
+	lineNumbers.insert(lineNumbers.end(), other.lineNumbers.begin(), other.lineNumbers.end());
+	parserVersions.insert(parserVersions.end(), other.parserVersions.begin(), other.parserVersions.end());
+	texts.insert(texts.end(), other.texts.begin(), other.texts.end());
+	authorStarts.insert(authorStarts.end(), other.authorStarts.begin(), other.authorStarts.end());
+	authorCounts.insert(authorCounts.end(), other.authorCounts.begin(), other.authorCounts.end());
+	authors.insert(authors.end(), other.authors.begin(), other.authors.end());
+	arena.append(other.arena);
+
+	// The copied positions are relative to the other table.
+	for (size_t i = firstMethod; i < size(); i++)
+	{
+		for (Text &text : texts[i])
+		{
+			text.offset += arenaOffset;
+		}
+		authorStarts[i] += firstAuthor;
+	}
+	for (size_t i = firstAuthor; i < authors.size(); i++)
+	{
+		authors[i].offset += arenaOffset;
+	}
+}
+
+size_t MethodTable::size() const
+{
+	return hashes.size();
+}
+
+size_t MethodTable::textSize() const
+{
+	return arena.size();
+}
+
+MethodOut MethodTable::get(size_t index) const
+{
+	MethodOut method;
+	method.hash = hashes[index];
+	method.projectID = projectIDs[index];
+	method.fileLocation = getText(texts[index][eFileLocation]);
+	method.startVersion = startVersions[index];
+	method.startVersionHash = getText(texts[index][eStartVersionHash]);
+	method.endVersion = endVersions[index];
+	method.endVersionHash = getText(texts[index][eEndVersionHash]);
+	method.methodName = getText(texts[index][eMethodName]);
+	method.lineNumber = lineNumbers[index];
+	method.vulnCode = getText(texts[index][eVulnCode]);
+	for (uint32_t i = 0; i < authorCounts[index]; i++)
+	{
+		method.authorIDs.push_back(getText(authors[authorStarts[index] + i]));
+	}
+	method.parserVersion = parserVersions[index];
+	method.license = getText(texts[index][eLicense]);
+	return method;
+}
+
+std::string MethodTable::toString(char dataDelimiter, char methodDelimiter) const
+{
+	// Besides its text, a method needs a hash, six numbers and fourteen delimiters, and a delimiter per author.
+	std::string out;
+	out.reserve(arena.size() + size() * (HASH_HEX_LENGTH + 6 * NUMBER_MAX_LENGTH + 14) + authors.size());
+
+	for (size_t i = size(); i-- > 0;)
+	{
+		const std::array<Text, eTextFields> &text = texts[i];
+		size_t hashStart = out.size();
+		out.resize(hashStart + HASH_HEX_LENGTH);
+		hashes[i].toHex(&out[hashStart]);
+		out.push_back(dataDelimiter);
+		appendNumber(out, projectIDs[i]);
+		out.push_back(dataDelimiter);
+		appendNumber(out, startVersions[i]);
+		out.push_back(dataDelimiter);
+		appendText(out, text[eStartVersionHash]);
+		out.push_back(dataDelimiter);
+		appendNumber(out, endVersions[i]);
+		out.push_back(dataDelimiter);
+		appendText(out, text[eEndVersionHash]);
+		out.push_back(dataDelimiter);
+		appendText(out, text[eMethodName]);
+		out.push_back(dataDelimiter);
+		appendText(out, text[eFileLocation]);
+		out.push_back(dataDelimiter);
+		appendNumber(out, lineNumbers[i]);
+		out.push_back(dataDelimiter);
+		appendNumber(out, parserVersions[i]);
+		out.push_back(dataDelimiter);
+		appendText(out, text[eVulnCode]);
+		out.push_back(dataDelimiter);
+		appendText(out, text[eLicense]);
+		out.push_back(dataDelimiter);
+		appendNumber(out, authorCounts[i]);
+		for (uint32_t j = 0; j < authorCounts[i]; j++)
+		{
+			out.push_back(dataDelimiter);
+			appendText(out, authors[authorStarts[i] + j]);
+		}
+		out.push_back(methodDelimiter);
+	}
+	return out;
+}
+
+MethodTable::Text MethodTable::addText(const std::string &value)
+{
+	Text text = {arena.size(), (uint32_t)value.size()};
+	arena.append(value);
+	return text;
+}
+
+std::string MethodTable::getText(Text text) const
+{
+	return arena.substr(text.offset, text.length);
+}
+
+void MethodTable::appendText(std::string &out, Text text) const
+{
+	out.append(arena, text.offset, text.length);
+}
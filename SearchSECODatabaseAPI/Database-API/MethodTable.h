@@ -0,0 +1,114 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#pragma once
+#include "Types.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace types;
+
+/// <summary>
+/// Methods stored by column: the fixed-width fields in contiguous arrays, and all strings of all methods in a single
+/// arena. Appending methods or other tables only grows a few vectors, instead of allocating every string separately.
+/// </summary>
+class MethodTable
+{
+public:
+	/// <summary>
+	/// Reserves room for the given amount of methods and bytes of text.
+	/// </summary>
+	void reserve(size_t methods, size_t bytes);
+
+	/// <summary>
+	/// Adds a method to the end of the table.
+	/// </summary>
+	void append(const MethodOut &method);
+
+	/// <summary>
+	/// Adds all methods of another table to the end of this table.
+	/// </summary>
+	void append(const MethodTable &other);
+
+	/// <summary>
+	/// Returns the amount of methods in the table.
+	/// </summary>
+	size_t size() const;
+
+	/// <summary>
+	/// Returns the amount of bytes of text of all methods in the table.
+	/// </summary>
+	size_t textSize() const;
+
+	/// <summary>
+	/// Returns the method at the given index.
+	/// </summary>
+	MethodOut get(size_t index) const;
+
+	/// <summary>
+	/// Converts the methods to a string, from the last to the first method.
+	/// </summary>
+	/// <param name="dataDelimiter"> Delimiter to separate different fields in a method. </param>
+	/// <param name="methodDelimiter"> Delimiter placed after every method. </param>
+	/// <returns>
+	/// The methods in the following format, or the empty string if there are none:
+	/// "method_hash?projectID?startVersion?startVersionHash?endVersion?endVersionHash?
+	///  method_name?file?lineNumber?parserVersion?vulnCode?license?authorTotal?authorID_1?...?authorID_N".
+	/// </returns>
+	std::string toString(char dataDelimiter, char methodDelimiter) const;
+
+private:
+	// The position of a string in the arena.
+	struct Text
+	{
+		size_t offset;
+		uint32_t length;
+	};
+
+	enum ETextField
+	{
+		eStartVersionHash,
+		eEndVersionHash,
+		eMethodName,
+		eFileLocation,
+		eVulnCode,
+		eLicense,
+		eTextFields
+	};
+
+	/// <summary>
+	/// Copies a string to the end of the arena.
+	/// </summary>
+	Text addText(const std::string &value);
+
+	/// <summary>
+	/// Returns a string stored in the arena.
+	/// </summary>
+	std::string getText(Text text) const;
+
+	/// <summary>
+	/// Appends a string stored in the arena to out.
+	/// </summary>
+	void appendText(std::string &out, Text text) const;
+
+	std::vector<Hash> hashes;
+	std::vector<ProjectID> projectIDs;
+	std::vector<Version> startVersions;
+	std::vector<Version> endVersions;
+	std::vector<int> lineNumbers;
+	std::vector<long long> parserVersions;
+	std::vector<std::array<Text, eTextFields>> texts;
+
+	// The authors of a method are authorCounts[i] consecutive entries of authors, starting at authorStarts[i].
+	std::vector<size_t> authorStarts;
+	std::vector<uint32_t> authorCounts;
+	std::vector<Text> authors;
+
+	std::string arena;
+};
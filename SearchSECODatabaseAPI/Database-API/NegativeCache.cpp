@@ -0,0 +1,138 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "NegativeCache.h"
+#include "Utility.h"
+
+#include <functional>
+
+#define EMPTY_SLOT 0
+#define REMOVED_SLOT 1
+
+NegativeCache::NegativeCache(size_t slots) : slots(slots)
+{
+	generations[0] = std::vector<uint64_t>(slots, EMPTY_SLOT);
+	generations[1] = std::vector<uint64_t>(slots, EMPTY_SLOT);
+	generationStart = Utility::getCurrentTimeMilliSeconds();
+}
+
+bool NegativeCache::contains(Hash hash)
+{
+	uint64_t print = fingerprint(hash);
+	std::lock_guard<std::mutex> lock(mtx);
+	rotate(Utility::getCurrentTimeMilliSeconds());
+	return find(0, print) != -1 || find(1, print) != -1;
+}
+
+void NegativeCache::put(Hash hash, long long lookupStart)
+{
+	uint64_t print = fingerprint(hash);
+	long long currentTime = Utility::getCurrentTimeMilliSeconds();
+	std::lock_guard<std::mutex> lock(mtx);
+	auto invalidation = invalidations.find(print);
+	if (currentTime - lookupStart >= NEGATIVE_CACHE_MAX_LOOKUP_TIME ||
+		(invalidation != invalidations.end() && invalidation->second >= lookupStart))
+	{
+		return;
+	}
+	rotate(currentTime);
+	if (find(current, print) != -1)
+	{
+		return;
+	}
+
+	// Use the first empty or removed slot after the home slot.
+	std::vector<uint64_t> &table = generations[current];
+	for (size_t i = print & (slots - 1);; i = (i + 1) & (slots - 1))
+	{
+		if (table[i] == EMPTY_SLOT || table[i] == REMOVED_SLOT)
+		{
+			if (table[i] == REMOVED_SLOT)
+			{
+				removed[current]--;
+			}
+			else
+			{
+				used[current]++;
+			}
+			table[i] = print;
+			return;
+		}
+	}
+}
+
+void NegativeCache::invalidate(Hash hash)
+{
+	uint64_t print = fingerprint(hash);
+	long long currentTime = Utility::getCurrentTimeMilliSeconds();
+	std::lock_guard<std::mutex> lock(mtx);
+	for (int generation = 0; generation < 2; generation++)
+	{
+		long long slot = find(generation, print);
+		if (slot != -1)
+		{
+			generations[generation][slot] = REMOVED_SLOT;
+			removed[generation]++;
+		}
+	}
+
+	// Lookups which took longer are not added anyway, so older invalidations can be forgotten.
+	if (invalidations.size() >= NEGATIVE_CACHE_MAX_INVALIDATIONS)
+	{
+		for (auto old = invalidations.begin(); old != invalidations.end();)
+		{
+			old = currentTime - old->second >= NEGATIVE_CACHE_MAX_LOOKUP_TIME ? invalidations.erase(old)
+																			   : std::next(old);
+		}
+	}
+	invalidations[print] = currentTime;
+}
+
+int NegativeCache::size()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return used[0] + used[1] - removed[0] - removed[1];
+}
+
+size_t NegativeCache::bytes()
+{
+	return 2 * slots * sizeof(uint64_t);
+}
+
+uint64_t NegativeCache::fingerprint(Hash hash)
+{
+	uint64_t print = std::hash<Hash>()(hash);
+	return print <= REMOVED_SLOT ? print + 2 : print;
+}
+
+long long NegativeCache::find(int generation, uint64_t print)
+{
+	std::vector<uint64_t> &table = generations[generation];
+	for (size_t i = print & (slots - 1);; i = (i + 1) & (slots - 1))
+	{
+		if (table[i] == print)
+		{
+			return i;
+		}
+		if (table[i] == EMPTY_SLOT)
+		{
+			return -1;
+		}
+	}
+}
+
+void NegativeCache::rotate(long long currentTime)
+{
+	if (used[current] < slots / 2 && currentTime - generationStart < NEGATIVE_CACHE_GENERATION_TIME)
+	{
+		return;
+	}
+	current = 1 - current;
+	std::fill(generations[current].begin(), generations[current].end(), EMPTY_SLOT);
+	used[current] = 0;
+	removed[current] = 0;
+	generationStart = currentTime;
+}
@@ -0,0 +1,96 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#pragma once
+#include "Types.h"
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#define NEGATIVE_CACHE_SLOTS 1048576 // Fingerprints per generation, 8 MiB.
+#define NEGATIVE_CACHE_GENERATION_TIME 30000 // Milliseconds per generation, half of METHOD_CACHE_TTL.
+#define NEGATIVE_CACHE_MAX_LOOKUP_TIME 10000 // Results of lookups which took longer are not added.
+#define NEGATIVE_CACHE_MAX_INVALIDATIONS 100000
+
+using namespace types;
+
+/// <summary>
+/// Remembers hashes which recently had no methods in the database, as 64-bit fingerprints in two generations of
+/// open addressing tables. A new generation is started when the current one is half full or
+/// NEGATIVE_CACHE_GENERATION_TIME has passed, dropping the oldest, so a hash is remembered for at most twice that
+/// time. Hashes are removed as soon as methods are added for them by this node. Methods added by other nodes are
+/// not noticed, so this bounds how long a check on this node can miss them to METHOD_CACHE_TTL, like the MethodCache.
+/// </summary>
+class NegativeCache
+{
+public:
+	/// <summary>
+	/// Constructor method.
+	/// </summary>
+	/// <param name="slots"> The amount of fingerprints a generation can hold, should be a power of two. </param>
+	NegativeCache(size_t slots = NEGATIVE_CACHE_SLOTS);
+
+	/// <summary>
+	/// Returns true if the hash is known to have no methods.
+	/// </summary>
+	bool contains(Hash hash);
+
+	/// <summary>
+	/// Remembers that the hash has no methods.
+	/// </summary>
+	/// <param name="lookupStart">
+	/// The time the hash was looked up at. It is not added if methods were added for it since.
+	/// </param>
+	void put(Hash hash, long long lookupStart);
+
+	/// <summary>
+	/// Forgets a hash for which methods have been added.
+	/// </summary>
+	void invalidate(Hash hash);
+
+	/// <summary>
+	/// Returns the amount of hashes remembered.
+	/// </summary>
+	int size();
+
+	/// <summary>
+	/// Returns the amount of memory used by the fingerprints.
+	/// </summary>
+	size_t bytes();
+
+private:
+	/// <summary>
+	/// Returns the fingerprint of a hash, which is never one of the markers for empty or removed slots.
+	/// </summary>
+	static uint64_t fingerprint(Hash hash);
+
+	/// <summary>
+	/// Returns the slot of the fingerprint in the given generation, or -1 if it is not in it.
+	/// Should be called while holding mtx.
+	/// </summary>
+	long long find(int generation, uint64_t print);
+
+	/// <summary>
+	/// Starts a new generation if the current one is full or old. Should be called while holding mtx.
+	/// </summary>
+	void rotate(long long currentTime);
+
+	size_t slots;
+
+	// The fingerprints of the current and the previous generation.
+	std::vector<uint64_t> generations[2];
+	// The slots in use, including those of removed fingerprints which still count towards a generation being full.
+	int used[2] = {0, 0};
+	int removed[2] = {0, 0};
+	int current = 0;
+	long long generationStart;
+
+	// The times at which hashes got methods, kept for NEGATIVE_CACHE_MAX_LOOKUP_TIME.
+	std::unordered_map<uint64_t, long long> invalidations;
+	std::mutex mtx;
+};
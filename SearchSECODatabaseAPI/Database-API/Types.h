@@ -8,6 +8,7 @@ Utrecht University within the Software Project course.
 #include <ctime>
 #include <vector>
 
+#include "Hash.h"
 #include "md5/md5.h"
 
 namespace types
@@ -15,7 +16,6 @@ namespace types
 
 	typedef std::string AuthorID;
 	typedef long long ProjectID;
-	typedef std::string Hash;
 	typedef std::string File;
 	typedef time_t Version;
 
@@ -0,0 +1,73 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "UploadInterner.h"
+
+#include <cstring>
+
+const Author &UploadInterner::addAuthor(std::string_view name, std::string_view mail)
+{
+	auto it = authorIndices.find({name, mail});
+	if (it == authorIndices.end())
+	{
+		// The ID is computed later by hashAuthors, for all authors at once.
+		Author author;
+		author.name = name;
+		author.mail = mail;
+		it = authorIndices.emplace(std::make_pair(name, mail), authors.size()).first;
+		authors.push_back(std::move(author));
+	}
+	occurrences.push_back(it->second);
+	return authors[it->second];
+}
+
+void UploadInterner::hashAuthors()
+{
+	// The ID of an author is the MD5 hash of its name and mail separated by a space, like in the Author constructor.
+	std::vector<std::string> inputs;
+	inputs.reserve(authors.size());
+	for (const Author &author : authors)
+	{
+		inputs.push_back(author.name + " " + author.mail);
+	}
+	std::vector<std::string_view> views(inputs.begin(), inputs.end());
+	std::vector<unsigned char> digests(authors.size() * HASH_BYTES);
+	md5Batch(views.data(), views.size(), (unsigned char(*)[HASH_BYTES])digests.data());
+
+	for (size_t i = 0; i < authors.size(); i++)
+	{
+		Hash digest;
+		std::memcpy(digest.bytes, &digests[i * HASH_BYTES], HASH_BYTES);
+		authors[i].id = digest.toString();
+	}
+}
+
+void UploadInterner::setAuthorIDs(std::vector<MethodIn> &methods) const
+{
+	size_t occurrence = 0;
+	for (MethodIn &method : methods)
+	{
+		for (Author &author : method.authors)
+		{
+			author.id = authors[occurrences[occurrence++]].id;
+		}
+	}
+}
+
+void UploadInterner::countFile(std::string_view file)
+{
+	files[file]++;
+}
+
+const std::vector<Author> &UploadInterner::getAuthors() const
+{
+	return authors;
+}
+
+const std::unordered_map<std::string_view, int> &UploadInterner::getFiles() const
+{
+	return files;
+}
@@ -0,0 +1,63 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#pragma once
+#include "Types.h"
+
+#include <map>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace types;
+
+/// <summary>
+/// Keeps the distinct authors and files of an upload, which are shared by many of its methods, so each of them is
+/// only processed once. The names, mails and files given should outlive the interner, like the request they are in.
+/// </summary>
+class UploadInterner
+{
+public:
+	/// <summary>
+	/// Adds an occurrence of the author with the given name and mail in a method.
+	/// </summary>
+	/// <returns> The author, of which the ID is left empty until hashAuthors is called. </returns>
+	const Author &addAuthor(std::string_view name, std::string_view mail);
+
+	/// <summary>
+	/// Computes the IDs of all distinct authors added, at once.
+	/// </summary>
+	void hashAuthors();
+
+	/// <summary>
+	/// Sets the IDs of the authors of methods, after hashAuthors is called.
+	/// </summary>
+	/// <param name="methods"> The methods the authors were added for, in the same order. </param>
+	void setAuthorIDs(std::vector<MethodIn> &methods) const;
+
+	/// <summary>
+	/// Counts an occurrence of a file.
+	/// </summary>
+	void countFile(std::string_view file);
+
+	/// <summary>
+	/// Returns the distinct authors which occurred.
+	/// </summary>
+	const std::vector<Author> &getAuthors() const;
+
+	/// <summary>
+	/// Returns the distinct files which occurred, with how often they occurred.
+	/// </summary>
+	const std::unordered_map<std::string_view, int> &getFiles() const;
+
+private:
+	std::map<std::pair<std::string_view, std::string_view>, size_t> authorIndices;
+	std::vector<Author> authors;
+	// The index of the author of each occurrence, in the order they were added.
+	std::vector<size_t> occurrences;
+	std::unordered_map<std::string_view, int> files;
+};
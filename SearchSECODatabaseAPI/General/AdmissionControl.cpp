@@ -0,0 +1,142 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "AdmissionControl.h"
+#include "Definitions.h"
+#include "Utility.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+AdmissionControl::AdmissionControl(std::string file) : file(file), lastRead(0)
+{
+	readLimits();
+}
+
+EAdmission AdmissionControl::admit(std::string client, std::string requestType, long long &retryAfter, bool charge)
+{
+	// Only one thread reads the configuration again.
+	long long currentTime = Utility::getCurrentTimeMilliSeconds();
+	long long previousRead = lastRead;
+	if (currentTime - previousRead >= ADMISSION_RELOAD_INTERVAL &&
+		lastRead.compare_exchange_strong(previousRead, currentTime))
+	{
+		readLimits();
+	}
+
+	std::lock_guard<std::mutex> lock(mtx);
+	if (inFlight >= maxInFlight)
+	{
+		retryAfter = OVERLOAD_RETRY_AFTER;
+		return eOverloaded;
+	}
+	if (!charge)
+	{
+		inFlight++;
+		return eAdmitted;
+	}
+
+	Limit limit = getLimit(requestType);
+	std::string key = client + FIELD_DELIMITER_CHAR + requestType;
+	auto it = buckets.find(key);
+	if (it == buckets.end())
+	{
+		if (buckets.size() >= ADMISSION_MAX_BUCKETS)
+		{
+			buckets.erase(bucketsByUse.back());
+			bucketsByUse.pop_back();
+		}
+		bucketsByUse.push_front(key);
+		it = buckets.insert({key, {limit.burst, currentTime, bucketsByUse.begin()}}).first;
+	}
+	else
+	{
+		bucketsByUse.splice(bucketsByUse.begin(), bucketsByUse, it->second.lastUse);
+	}
+
+	// Add the tokens gained since the last request.
+	TokenBucket &bucket = it->second;
+	bucket.tokens = std::min(limit.burst, bucket.tokens + (currentTime - bucket.lastRefill) * limit.rate / 1000);
+	bucket.lastRefill = currentTime;
+	if (bucket.tokens < 1)
+	{
+		// A request type without rate can only be done again after the limits have changed.
+		retryAfter = limit.rate > 0 ? (long long)std::ceil((1 - bucket.tokens) * 1000 / limit.rate)
+									: ADMISSION_RELOAD_INTERVAL;
+		return eRateLimited;
+	}
+	bucket.tokens--;
+	inFlight++;
+	return eAdmitted;
+}
+
+void AdmissionControl::release()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	inFlight--;
+}
+
+void AdmissionControl::readLimits()
+{
+	std::map<std::string, Limit> newLimits;
+	int newMaxInFlight = DEFAULT_MAX_IN_FLIGHT;
+
+	std::ifstream fileHandler;
+	fileHandler.open(file);
+	std::string line;
+	while (fileHandler.is_open() && std::getline(fileHandler, line))
+	{
+		std::vector<std::string> lineSplitted = Utility::splitStringOn(line, '=');
+		if (lineSplitted.size() < 2)
+		{
+			continue;
+		}
+		if (lineSplitted[0] == "RATE_LIMIT")
+		{
+			std::vector<std::string> limit = Utility::splitStringOn(lineSplitted[1], ',');
+			if (limit.size() < 3)
+			{
+				continue;
+			}
+			int rate = Utility::safeStoi(limit[1]);
+			int burst = Utility::safeStoi(limit[2]);
+			if (errno == 0 && rate >= 0 && burst >= 1)
+			{
+				newLimits[limit[0]] = {(double)rate, (double)burst};
+			}
+		}
+		else if (lineSplitted[0] == "MAX_IN_FLIGHT")
+		{
+			int amount = Utility::safeStoi(lineSplitted[1]);
+			if (errno == 0 && amount > 0)
+			{
+				newMaxInFlight = amount;
+			}
+		}
+	}
+	errno = 0;
+
+	std::lock_guard<std::mutex> lock(mtx);
+	limits = newLimits;
+	maxInFlight = newMaxInFlight;
+	lastRead = Utility::getCurrentTimeMilliSeconds();
+}
+
+AdmissionControl::Limit AdmissionControl::getLimit(std::string requestType)
+{
+	auto it = limits.find(requestType);
+	if (it == limits.end())
+	{
+		it = limits.find("*");
+	}
+	if (it == limits.end())
+	{
+		return {DEFAULT_RATE_LIMIT, DEFAULT_BURST};
+	}
+	return it->second;
+}
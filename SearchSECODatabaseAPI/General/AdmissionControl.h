@@ -0,0 +1,126 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#pragma once
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#define DEFAULT_RATE_LIMIT 200 // Requests per second a client may do of a single request type.
+#define DEFAULT_BURST 400 // Requests a client may do of a single request type at once.
+#define DEFAULT_MAX_IN_FLIGHT 256 // Requests this node handles at the same time, over all clients.
+#define OVERLOAD_RETRY_AFTER 1000 // Milliseconds a client is told to wait when the node is overloaded.
+#define ADMISSION_RELOAD_INTERVAL 10000 // Milliseconds between reading the limits from the configuration again.
+#define ADMISSION_MAX_BUCKETS 10000 // Amount of buckets kept before the longest idle ones are forgotten.
+
+/// <summary>
+/// The possible outcomes of asking to handle a request.
+/// </summary>
+enum EAdmission
+{
+	eAdmitted,
+	eRateLimited,
+	eOverloaded
+};
+
+/// <summary>
+/// Decides whether a request is handled or rejected right away, using a token bucket for every combination of
+/// client and request type and a limit on the amount of requests handled at the same time.
+/// The limits are read from the configuration file, lines of the form "RATE_LIMIT=type,rate,burst" set the limit
+/// of a request type ("*" for all types without their own limit) and "MAX_IN_FLIGHT=amount" sets the limit on
+/// requests at the same time. Changes to the file are picked up within ADMISSION_RELOAD_INTERVAL.
+/// </summary>
+class AdmissionControl
+{
+public:
+	/// <summary>
+	/// Constructor method.
+	/// </summary>
+	/// <param name="file"> The configuration file to read the limits from. </param>
+	AdmissionControl(std::string file = ".env");
+
+	/// <summary>
+	/// Asks to handle a request. If it is admitted, release should be called once it has been handled,
+	/// which an AdmittedRequest does when it goes out of scope.
+	/// </summary>
+	/// <param name="retryAfter"> Set to the milliseconds the client should wait if the request is rejected. </param>
+	/// <param name="charge">
+	/// If false, the request is not taken from the budget of the client, as it was already by the node passing it on.
+	/// It still counts towards the requests handled at the same time.
+	/// </param>
+	EAdmission admit(std::string client, std::string requestType, long long &retryAfter, bool charge = true);
+
+	/// <summary>
+	/// Indicates an admitted request has been handled.
+	/// </summary>
+	void release();
+
+	/// <summary>
+	/// Reads the limits from the configuration file. Limits not in the file get their default value.
+	/// </summary>
+	void readLimits();
+
+private:
+	/// <summary>
+	/// The budget of a client for a single request type, and its place in the list of buckets by last use.
+	/// </summary>
+	struct TokenBucket
+	{
+		double tokens;
+		long long lastRefill;
+		std::list<std::string>::iterator lastUse;
+	};
+
+	/// <summary>
+	/// The rate and burst of the tokens of a request type.
+	/// </summary>
+	struct Limit
+	{
+		double rate;
+		double burst;
+	};
+
+	/// <summary>
+	/// Returns the limit of the given request type. Should be called while holding mtx.
+	/// </summary>
+	Limit getLimit(std::string requestType);
+
+	std::string file;
+	std::atomic<long long> lastRead;
+
+	std::map<std::string, Limit> limits;
+	std::unordered_map<std::string, TokenBucket> buckets;
+
+	// The keys of the buckets, the most recently used first. Once there are ADMISSION_MAX_BUCKETS buckets, the last
+	// one is forgotten for every new one. Having been idle the longest, it is the most likely to be full again.
+	std::list<std::string> bucketsByUse;
+
+	int maxInFlight = DEFAULT_MAX_IN_FLIGHT;
+	int inFlight = 0;
+	std::mutex mtx;
+};
+
+/// <summary>
+/// Releases an admitted request once it goes out of scope, so it is released even if handling it throws.
+/// </summary>
+class AdmittedRequest
+{
+public:
+	AdmittedRequest(AdmissionControl &admission) : admission(admission)
+	{
+	}
+
+	~AdmittedRequest()
+	{
+		admission.release();
+	}
+
+private:
+	AdmissionControl &admission;
+};
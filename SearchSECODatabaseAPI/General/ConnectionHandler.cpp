@@ -10,10 +10,14 @@ Utrecht University within the Software Project course.
 
 #include <boost/array.hpp>
 #include <boost/bind/bind.hpp>
+#include <algorithm>
 #include <chrono>
+#include <future>
+#include <queue>
 #include <string>
 #include <vector>
 #include <iostream>
+#include <poll.h>
 
 ConnectionHandler::~ConnectionHandler() 
 {
@@ -38,7 +42,7 @@ void ConnectionHandler::startListen(DatabaseHandler *databaseHandler, DatabaseCo
 		std::vector<std::pair<std::string, std::string>> ips = raft->getIps();
 		TcpServer server(ioContext, databaseHandler, databaseConnection, raft, handler, port, stats);
 		this->server = &server;
-		raft->start(handler, ips);
+		raft->start(handler, ips, false, port);
 		ioContext.run();
 	}
 	catch (std::exception &e)
@@ -58,72 +62,228 @@ void TcpConnection::sendData(const std::string &data, boost::system::error_code
 	boost::asio::write(socket_, boost::asio::buffer(data), error);
 }
 
-void TcpConnection::start(RequestHandler *handler, pointer thisPointer, Statistics *stats)
+std::string TcpConnection::receiveLine(boost::system::error_code &error)
 {
-
-	std::vector<char> request = std::vector<char>();
-	boost::system::error_code error;
-	size_t len;
-	len = boost::asio::read_until(socket_, boost::asio::dynamic_buffer(request), '\n', error);
-	if (error == boost::asio::error::eof)
+	size_t searched = 0;
+	size_t end;
+	while ((end = receiveBuffer.find('\n', searched)) == std::string::npos)
 	{
-		// The socket was closed before receiving '\n'.
-		return;
+		searched = receiveBuffer.size();
+		boost::array<char, 1024> chunk;
+		size_t len = receiveSome(chunk.data(), chunk.size(), error);
+		if (error)
+		{
+			return "";
+		}
+		receiveBuffer.append(chunk.data(), len);
 	}
-	std::string r(request.begin(), request.begin() + len - 1);
+	std::string line = receiveBuffer.substr(0, end);
+	receiveBuffer.erase(0, end + 1);
+	return line;
+}
 
-	std::cout << r << std::endl;
-	std::vector<std::string> header = Utility::splitStringOn(r, FIELD_DELIMITER_CHAR);
-	if (header.size() < 3)
+size_t TcpConnection::receiveSome(char *buffer, size_t size, boost::system::error_code &error)
+{
+	if (!waitForSocket(CONNECTION_TIMEOUT))
 	{
-		boost::asio::write(socket_, boost::asio::buffer(HTTPStatusCodes::clientError("Header too short.")), error);
-		return;
+		error = boost::asio::error::timed_out;
+		return 0;
 	}
+	return socket_.read_some(boost::asio::buffer(buffer, size), error);
+}
 
-	std::string length = header[2];
-	std::string totalData(request.begin() + len, request.end());
-
-	int size = Utility::safeStoi(length) - (request.size() - len);
-	if (errno != 0)
+void TcpConnection::start(RequestHandler *handler, pointer thisPointer, Statistics *stats)
+{
+	std::vector<std::string> header;
+	std::string data;
+	bool keepAlive;
+	std::string errorResponse;
+	boost::system::error_code error;
+	if (!receiveRequest(header, data, keepAlive, errorResponse))
 	{
-		boost::asio::write(socket_, boost::asio::buffer(HTTPStatusCodes::clientError("Error parsing command.")), error);
+		if (errorResponse != "")
+		{
+			sendResponse(errorResponse, keepAlive, error);
+		}
 		return;
 	}
-	if (size < 0)
+	if (keepAlive && header[0] != "conn")
 	{
-		boost::asio::write(
-			socket_, boost::asio::buffer(HTTPStatusCodes::clientError("Request body larger than expected.")), error);
+		this->keepAlive(handler, thisPointer, stats, header, data);
 		return;
 	}
 
-	stats->requestCounter->Add({{"Node", stats->myIP}, {"Client", header[1]}, {"Request", header[0]}}).Increment();
-	stats->latestRequest->Add({{"Node", stats->myIP}, {"Client", header[1]}, {"Request", header[0]}}).SetToCurrentTime();
-	std::vector<char> data(size);
-	readExpectedData(size, data, totalData, error);
-	std::string result = handler->handleRequest(header[0], header[1], totalData, thisPointer);
-	stats->newRequest = true;
-	boost::asio::write(socket_, boost::asio::buffer(result), error);
+	countRequest(stats, header);
+	std::string result = handler->handleRequest(header[0], header[1], data, thisPointer, isForwarded(header));
+	sendResponse(result, keepAlive, error);
 }
 
-void TcpConnection::readExpectedData(int &size, std::vector<char> &data, std::string &totalData,
-									 boost::system::error_code &error)
+void TcpConnection::keepAlive(RequestHandler *handler, pointer thisPointer, Statistics *stats,
+							  std::vector<std::string> header, std::string data)
 {
-	while (size > 0)
+	boost::system::error_code error;
+	std::queue<std::future<std::string>> pending;
+	while (true)
 	{
-		int prevSize = size;
-		size -= socket_.read_some(boost::asio::buffer(data), error);
-		if (error == boost::asio::error::eof)
+		// Handle the request received, a new node joining the network takes over the connection.
+		if (header[0] == "conn")
 		{
-			// The socket was closed before receiving all data.
+			while (!pending.empty() && !error)
+			{
+				sendResponse(pending.front().get(), true, error);
+				pending.pop();
+			}
+			countRequest(stats, header);
+			sendResponse(handler->handleRequest(header[0], header[1], data, thisPointer, isForwarded(header)), true,
+						 error);
 			return;
 		}
-		if (size < 0)
+		countRequest(stats, header);
+		pending.push(std::async(std::launch::async, &RequestHandler::handleRequest, handler, header[0], header[1],
+								std::move(data), thisPointer, isForwarded(header)));
+
+		// Send the responses which are done, in order. Wait for them if the pipeline is full, or the client is
+		// waiting for them before sending more requests.
+		while (!pending.empty() && !error &&
+			   (pending.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready ||
+				pending.size() >= MAX_PIPELINE_DEPTH || !waitForData(0)))
 		{
-			boost::asio::write(socket_, boost::asio::buffer(std::string("Request body larger than expected.")), error);
-			return;
+			sendResponse(pending.front().get(), true, error);
+			pending.pop();
+		}
+		if (error || (pending.empty() && !waitForData(CONNECTION_TIMEOUT)))
+		{
+			break;
+		}
+
+		bool keepAlive;
+		std::string errorResponse;
+		if (!receiveRequest(header, data, keepAlive, errorResponse))
+		{
+			// The response to a malformed request is sent after the responses to the requests before it.
+			if (errorResponse != "")
+			{
+				std::promise<std::string> response;
+				response.set_value(errorResponse);
+				pending.push(response.get_future());
+			}
+			break;
+		}
+	}
+
+	// The client is done, but still expects the responses of the requests which are being handled.
+	while (!pending.empty())
+	{
+		std::string result = pending.front().get();
+		if (!error)
+		{
+			sendResponse(result, true, error);
 		}
-		totalData.append(std::string(data.begin(), data.begin() + prevSize - size));
+		pending.pop();
 	}
+	socket_.shutdown(tcp::socket::shutdown_both, error);
+}
+
+bool TcpConnection::isForwarded(const std::vector<std::string> &header)
+{
+	return header.size() >= 4 && header[3] == FORWARDED;
+}
+
+bool TcpConnection::receiveRequest(std::vector<std::string> &header, std::string &data, bool &keepAlive,
+								   std::string &errorResponse)
+{
+	boost::system::error_code error;
+	keepAlive = false;
+	std::string line = receiveLine(error);
+	if (error)
+	{
+		// The socket was closed or stayed idle before receiving '\n'.
+		return false;
+	}
+
+	std::cout << line << std::endl;
+	header = Utility::splitStringOn(line, FIELD_DELIMITER_CHAR);
+	if (header.size() < 3)
+	{
+		errorResponse = HTTPStatusCodes::clientError("Header too short.");
+		return false;
+	}
+	keepAlive = header.size() >= 4 && header[3] == KEEP_ALIVE;
+
+	int size = Utility::safeStoi(header[2]);
+	if (errno != 0)
+	{
+		errorResponse = HTTPStatusCodes::clientError("Error parsing command.");
+		return false;
+	}
+
+	// Without keep-alive, the client should not send anything after the request.
+	if (size < 0 || (!keepAlive && receiveBuffer.size() > size))
+	{
+		errorResponse = HTTPStatusCodes::clientError("Request body larger than expected.");
+		return false;
+	}
+
+	data = receiveExpectedData(size, error);
+	// The socket was closed or stayed idle before receiving all data.
+	return !error;
+}
+
+std::string TcpConnection::receiveExpectedData(int size, boost::system::error_code &error)
+{
+	size_t received = receiveBuffer.size();
+	if (received < size)
+	{
+		// The rest of the data is read directly behind the part already received.
+		receiveBuffer.resize(size);
+		while (received < size)
+		{
+			size_t len = receiveSome(&receiveBuffer[received], size - received, error);
+			if (error)
+			{
+				receiveBuffer.resize(received);
+				return "";
+			}
+			received += len;
+		}
+	}
+	if (receiveBuffer.size() == size)
+	{
+		// Nothing was received after the data, so the buffer can be handed over without copying it.
+		std::string result = std::move(receiveBuffer);
+		receiveBuffer.clear();
+		return result;
+	}
+	std::string result = receiveBuffer.substr(0, size);
+	receiveBuffer.erase(0, size);
+	return result;
+}
+
+bool TcpConnection::waitForData(long long timeout)
+{
+	return receiveBuffer.size() > 0 || waitForSocket(timeout);
+}
+
+bool TcpConnection::waitForSocket(long long timeout)
+{
+	pollfd descriptor = {socket_.native_handle(), POLLIN, 0};
+	return poll(&descriptor, 1, timeout / 1000) > 0;
+}
+
+void TcpConnection::sendResponse(std::string response, bool keepAlive, boost::system::error_code &error)
+{
+	if (keepAlive)
+	{
+		response = std::to_string(response.size()) + ENTRY_DELIMITER_CHAR + response;
+	}
+	boost::asio::write(socket_, boost::asio::buffer(response), error);
+}
+
+void TcpConnection::countRequest(Statistics *stats, std::vector<std::string> header)
+{
+	stats->requestCounter->Add({{"Node", stats->myIP}, {"Client", header[1]}, {"Request", header[0]}}).Increment();
+	stats->latestRequest->Add({{"Node", stats->myIP}, {"Client", header[1]}, {"Request", header[0]}}).SetToCurrentTime();
+	stats->newRequest = true;
 }
 
 // TCP Server Methods.
@@ -5,6 +5,7 @@ Utrecht University within the Software Project course.
 */
 
 #pragma once
+#include "Definitions.h"
 #include "RequestHandler.h"
 #include "RAFTConsensus.h"
 #include "Statistics.h"
@@ -13,8 +14,10 @@ Utrecht University within the Software Project course.
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/asio.hpp>
 
-#define PORT 8003
 #define CONNECTION_TIMEOUT 10000000	// Timeout in microseconds.
+#define KEEP_ALIVE "keep-alive"
+#define FORWARDED "forwarded"		// Ends the header of a request passed on to the leader by another node.
+#define MAX_PIPELINE_DEPTH 16		// Requests of a single connection handled at the same time.
 
 using boost::asio::ip::tcp;
 
@@ -72,8 +75,18 @@ public:
 	/// </summary>
 	virtual void sendData(const std::string &data, boost::system::error_code &error);
 
+	/// <summary>
+	/// Reads a single line from the other side of the connection. The new line itself is not returned.
+	/// Fails with boost::asio::error::timed_out if the other side sends nothing for CONNECTION_TIMEOUT.
+	/// </summary>
+	virtual std::string receiveLine(boost::system::error_code &error);
+
 	/// <summary>
 	/// Starts the handeling of a request. Takes in the request handler to call.
+	/// If the header of the request ends with the KEEP_ALIVE field, the connection is kept open for more
+	/// requests until it has been idle for CONNECTION_TIMEOUT. The client may send the next requests without
+	/// waiting for the responses, which are sent in the same order, each preceded by its length and the
+	/// ENTRY_DELIMITER_CHAR.
 	/// </summary>
 	virtual void start(RequestHandler *handler, pointer thisPointer, Statistics *stats);
 
@@ -88,15 +101,64 @@ protected:
 	}
 
 private:
+	/// <summary>
+	/// Reads the header and data of a request.
+	/// </summary>
+	/// <param name="keepAlive"> Set to true if the client wants to keep the connection open. </param>
+	/// <param name="errorResponse">
+	/// Set to the response for the client if the request is malformed, left empty if the socket was closed.
+	/// </param>
+	/// <returns> False if no request could be read, in which case the connection should be closed. </returns>
+	bool receiveRequest(std::vector<std::string> &header, std::string &data, bool &keepAlive,
+						std::string &errorResponse);
+
+	/// <summary>
+	/// Checks if the header ends with the FORWARDED field, added by a node passing the request on to the leader.
+	/// </summary>
+	bool isForwarded(const std::vector<std::string> &header);
+
 	/// <summary>
 	/// Loops until expected amount of data is received.
+	/// Fails with boost::asio::error::timed_out if the client sends nothing for CONNECTION_TIMEOUT.
+	/// </summary>
+	std::string receiveExpectedData(int size, boost::system::error_code &error);
+
+	/// <summary>
+	/// Waits until the client sends more data, or the timeout in microseconds has passed.
+	/// </summary>
+	/// <returns> True if there is data to read, or the connection was closed by the client. </returns>
+	bool waitForData(long long timeout);
+
+	/// <summary>
+	/// Like waitForData, but ignores the data which was already received.
+	/// </summary>
+	bool waitForSocket(long long timeout);
+
+	/// <summary>
+	/// Reads what the other side sent, at most size bytes, after waiting for it for at most CONNECTION_TIMEOUT.
+	/// </summary>
+	size_t receiveSome(char *buffer, size_t size, boost::system::error_code &error);
+
+	/// <summary>
+	/// Sends the response to a request, preceded by its length if the connection is kept open.
+	/// </summary>
+	void sendResponse(std::string response, bool keepAlive, boost::system::error_code &error);
+
+	/// <summary>
+	/// Handles the requests of a connection which is kept open, until the client closes it or stays idle.
+	/// </summary>
+	void keepAlive(RequestHandler *handler, pointer thisPointer, Statistics *stats, std::vector<std::string> header,
+				   std::string data);
+
+	/// <summary>
+	/// Updates the statistics for a request which is about to be handled.
 	/// </summary>
-	void readExpectedData(int &size, std::vector<char> &data, std::string &totalData, 
-						  boost::system::error_code &error);
+	void countRequest(Statistics *stats, std::vector<std::string> header);
 
 
 	tcp::socket socket_;
 	std::string message_;
+	std::string receiveBuffer;
 };
 
 class TcpServer
@@ -0,0 +1,63 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#pragma once
+#include <atomic>
+#include <memory_resource>
+
+/// <summary>
+/// Passes allocations on to another memory resource, and counts them.
+/// Used below an arena to see how often it had to go to the heap.
+/// </summary>
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+	/// <summary>
+	/// Constructor method.
+	/// </summary>
+	/// <param name="upstream"> The resource which does the allocations. </param>
+	CountingResource(std::pmr::memory_resource *upstream = std::pmr::new_delete_resource()) : upstream(upstream)
+	{
+	}
+
+	/// <summary>
+	/// Returns the amount of allocations made.
+	/// </summary>
+	long long getAllocations() const
+	{
+		return allocations;
+	}
+
+	/// <summary>
+	/// Returns the amount of bytes allocated in total.
+	/// </summary>
+	long long getBytes() const
+	{
+		return bytes;
+	}
+
+private:
+	void *do_allocate(size_t size, size_t alignment) override
+	{
+		allocations++;
+		bytes += size;
+		return upstream->allocate(size, alignment);
+	}
+
+	void do_deallocate(void *pointer, size_t size, size_t alignment) override
+	{
+		upstream->deallocate(pointer, size, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+	{
+		return this == &other;
+	}
+
+	std::pmr::memory_resource *upstream;
+	std::atomic<long long> allocations = 0;
+	std::atomic<long long> bytes = 0;
+};
@@ -111,4 +111,49 @@ std::string DatabaseUtility::getUUID(const CassRow *row, const char *column)
 	cass_value_get_uuid(value, &authorID);
 	cass_uuid_string(authorID, result);
 	return result;
-}
\ No newline at end of file
+}
+
+types::Hash DatabaseUtility::getHash(const CassRow *row, const char *column)
+{
+	CassUuid uuid;
+	const CassValue *value = cass_row_get_column_by_name(row, column);
+	cass_value_get_uuid(value, &uuid);
+	return uuidToHash(uuid);
+}
+
+CassUuid DatabaseUtility::hashToUuid(const types::Hash &hash)
+{
+	// The first eight bytes are the time_low, time_mid and time_hi_and_version fields of the UUID, which the driver
+	// keeps from least to most significant, each in big-endian order.
+	const uint8_t *bytes = hash.bytes;
+	CassUuid uuid;
+	uuid.time_and_version = (uint64_t)bytes[0] << 24 | (uint64_t)bytes[1] << 16 | (uint64_t)bytes[2] << 8 |
+							(uint64_t)bytes[3] | (uint64_t)bytes[4] << 40 | (uint64_t)bytes[5] << 32 |
+							(uint64_t)bytes[6] << 56 | (uint64_t)bytes[7] << 48;
+	uuid.clock_seq_and_node = 0;
+	for (int i = 8; i < HASH_BYTES; i++)
+	{
+		uuid.clock_seq_and_node = uuid.clock_seq_and_node << 8 | bytes[i];
+	}
+	return uuid;
+}
+
+types::Hash DatabaseUtility::uuidToHash(CassUuid uuid)
+{
+	types::Hash hash;
+	uint8_t *bytes = hash.bytes;
+	bytes[0] = uuid.time_and_version >> 24;
+	bytes[1] = uuid.time_and_version >> 16;
+	bytes[2] = uuid.time_and_version >> 8;
+	bytes[3] = uuid.time_and_version;
+	bytes[4] = uuid.time_and_version >> 40;
+	bytes[5] = uuid.time_and_version >> 32;
+	bytes[6] = uuid.time_and_version >> 56;
+	bytes[7] = uuid.time_and_version >> 48;
+	for (int i = HASH_BYTES - 1; i >= 8; i--)
+	{
+		bytes[i] = uuid.clock_seq_and_node;
+		uuid.clock_seq_and_node >>= 8;
+	}
+	return hash;
+}
@@ -6,6 +6,7 @@ Utrecht University within the Software Project course.
 
 #pragma once
 #include "Definitions.h"
+#include "Types.h"
 #include <cassandra.h>
 #include <string>
 
@@ -59,4 +60,21 @@ public:
 	/// <param name="row"> The corresponding row. </param>
 	/// <param name="column"> The corresponding column. </param>
 	static std::string getUUID(const CassRow *row, const char *column);
+
+	/// <summary>
+	/// Retrieves a hash stored as a UUID from a row.
+	/// </summary>
+	/// <param name="row"> The corresponding row. </param>
+	/// <param name="column"> The corresponding column. </param>
+	static types::Hash getHash(const CassRow *row, const char *column);
+
+	/// <summary>
+	/// Converts a hash to the UUID it is stored as, which has the same bytes.
+	/// </summary>
+	static CassUuid hashToUuid(const types::Hash &hash);
+
+	/// <summary>
+	/// Converts a UUID back to the hash it stores.
+	/// </summary>
+	static types::Hash uuidToHash(CassUuid uuid);
 };
\ No newline at end of file
@@ -9,3 +9,4 @@ Utrecht University within the Software Project course.
 #define FIELD_DELIMITER_CHAR '?'
 #define ENTRY_DELIMITER_CHAR '\n'
 #define MAX_THREADS 16
+#define PORT 8003
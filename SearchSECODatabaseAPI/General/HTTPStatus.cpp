@@ -12,6 +12,7 @@ enum HTTPStatusCode
 {
 	successCode = 200,
 	clientErrorCode = 400,
+	tooManyRequestsCode = 429,
 	serverErrorCode = 500
 };
 
@@ -27,6 +28,7 @@ bool validCode(std::string request)
 
 	return code == std::to_string(successCode) 
 		|| code == std::to_string(clientErrorCode) 
+		|| code == std::to_string(tooManyRequestsCode)
 		|| code == std::to_string(serverErrorCode);
 }
 
@@ -45,6 +47,11 @@ std::string HTTPStatusCodes::serverError(std::string message)
 	return constructMessage(serverErrorCode, message);
 }
 
+std::string HTTPStatusCodes::tooManyRequests(std::string message, long long retryAfter)
+{
+	return constructMessage(tooManyRequestsCode, std::to_string(retryAfter) + FIELD_DELIMITER_CHAR + message);
+}
+
 std::string HTTPStatusCodes::getCode(std::string request)
 {
 	if (validCode(request))
@@ -27,6 +27,14 @@ namespace HTTPStatusCodes
 	/// </summary>
 	std::string serverError(std::string message);
 
+	/// <summary>
+	/// Adds a small part at the beginning of the message to
+	/// indicate the request was rejected because of too many requests.
+	/// The message starts with the milliseconds to wait before trying again,
+	/// separated from the rest by the FIELD_DELIMITER_CHAR.
+	/// </summary>
+	std::string tooManyRequests(std::string message, long long retryAfter);
+
 	/// <summary>
 	/// Obtains the code to glue to the message.
 	/// </summary>
@@ -4,22 +4,132 @@ Utrecht University within the Software Project course.
 © Copyright Utrecht University (Department of Information and Computing Sciences)
 */
 
+#include "ConnectionHandler.h"
 #include "HTTPStatus.h"
 #include "RequestHandler.h"
 
+#include <chrono>
+
 void RequestHandler::initialize(DatabaseHandler *databaseHandler, DatabaseConnection *databaseConnection,
 								RAFTConsensus *raft, Statistics *stats, std::string ip, int port)
 {
 	// Initialise the requestHandlers.
 	dbrh = new DatabaseRequestHandler(databaseHandler, stats, ip, port);
 	jrh = new JobRequestHandler(raft, this, databaseConnection, stats, ip, port);
+	this->raft = raft;
+	this->stats = stats;
 }
 
-std::string RequestHandler::handleRequest(std::string requestType, std::string client, std::string request,
-										  boost::shared_ptr<TcpConnection> connection)
+std::string RequestHandler::handleRequest(const std::string &requestType, const std::string &client,
+										  const std::string &request, boost::shared_ptr<TcpConnection> connection,
+										  bool forwarded)
 {
 	ERequestType eRequest = getERequestType(requestType);
+	ERequestLane lane = getLane(eRequest);
+	if (lane == eNoLane)
+	{
+		return dispatchRequest(eRequest, requestType, client, request, connection);
+	}
+
+	// A request passed on by another node was already charged to the client there.
+	bool charge = !forwarded || !isFromNode(connection);
+	long long retryAfter;
+	EAdmission admission = admissionControl.admit(client, requestType, retryAfter, charge);
+	if (admission != eAdmitted)
+	{
+		std::string reason = admission == eRateLimited ? "rate" : "overload";
+		if (stats != nullptr)
+		{
+			stats->shedCounter
+				->Add({{"Node", stats->myIP}, {"Request", requestType}, {"Reason", reason}})
+				.Increment();
+		}
+		return HTTPStatusCodes::tooManyRequests(
+			admission == eRateLimited ? "Too many requests of this type." : "Node is overloaded.", retryAfter);
+	}
+
+	AdmittedRequest admitted(admissionControl);
+	LanePlace place(this, lane);
+	if (!place.hasPlace())
+	{
+		if (stats != nullptr)
+		{
+			stats->shedCounter
+				->Add({{"Node", stats->myIP}, {"Request", requestType}, {"Reason", "lane"}})
+				.Increment();
+		}
+		return HTTPStatusCodes::tooManyRequests("Too many requests of this type waiting.", LANE_RETRY_AFTER);
+	}
+	return dispatchRequest(eRequest, requestType, client, request, connection);
+}
+
+bool RequestHandler::isFromNode(boost::shared_ptr<TcpConnection> connection)
+{
+	if (connection == nullptr || raft == nullptr)
+	{
+		return false;
+	}
+	boost::system::error_code error;
+	tcp::endpoint remote = connection->socket().remote_endpoint(error);
+	if (error)
+	{
+		return false;
+	}
+	std::string ip = remote.address().to_string();
+	for (std::string node : raft->getCurrentIPs())
+	{
+		if (Utility::splitStringOn(node, FIELD_DELIMITER_CHAR)[0] == ip)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool RequestHandler::enterLane(ERequestLane lane)
+{
+	const int slots[eNoLane] = {JOB_LANE_SLOTS, CHECK_LANE_SLOTS, UPLOAD_LANE_SLOTS, ANALYTICS_LANE_SLOTS};
+	const int queues[eNoLane] = {JOB_LANE_QUEUE, CHECK_LANE_QUEUE, UPLOAD_LANE_QUEUE, ANALYTICS_LANE_QUEUE};
+	auto start = std::chrono::steady_clock::now();
+	std::unique_lock<std::mutex> lock(lanemtx);
+	bool entered = inLane[lane] < slots[lane];
+	if (!entered && waitingForLane[lane] < queues[lane])
+	{
+		waitingForLane[lane]++;
+		entered = laneFree[lane].wait_for(lock, std::chrono::milliseconds(LANE_MAX_WAIT),
+										  [this, lane, &slots]() { return inLane[lane] < slots[lane]; });
+		waitingForLane[lane]--;
+	}
+	if (!entered)
+	{
+		return false;
+	}
+	inLane[lane]++;
+	lock.unlock();
+
+	if (stats != nullptr)
+	{
+		const std::string names[eNoLane] = {"job", "check", "upload", "analytics"};
+		std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+		stats->laneQueueingTime
+			->Add({{"Node", stats->myIP}, {"Lane", names[lane]}},
+				  prometheus::Histogram::BucketBoundaries{0.0001, 0.001, 0.01, 0.1, 1, 10})
+			.Observe(waited.count());
+	}
+	return true;
+}
+
+void RequestHandler::leaveLane(ERequestLane lane)
+{
+	std::lock_guard<std::mutex> lock(lanemtx);
+	inLane[lane]--;
+	laneFree[lane].notify_one();
+}
 
+std::string RequestHandler::dispatchRequest(ERequestType eRequest, const std::string &requestType,
+											const std::string &client, const std::string &request,
+											boost::shared_ptr<TcpConnection> connection)
+{
 	// Handle the request based on its type.
 	std::string result;
 	switch (eRequest)
@@ -36,9 +146,15 @@ std::string RequestHandler::handleRequest(std::string requestType, std::string c
 	case eConnect:
 		result = jrh->handleConnectRequest(connection, request);
 		break;
+	case eVote:
+		result = jrh->handleVoteRequest(request);
+		break;
 	case eGetIPs:
 		result = jrh->handleGetIPsRequest(requestType, client, request);
 		break;
+	case eGetJobState:
+		result = jrh->handleGetJobStateRequest(requestType, client, request);
+		break;
 	case eUploadJob:
 		result = jrh->handleUploadJobRequest(requestType, client, request);
 		break;
@@ -63,6 +179,9 @@ std::string RequestHandler::handleRequest(std::string requestType, std::string c
 	case eGetMethodByAuthor:
 		result = dbrh->handleGetMethodsByAuthorRequest(request);
 		break;
+	case eGetMethodByAuthorPage:
+		result = dbrh->handleGetMethodsByAuthorPageRequest(request);
+		break;
 	case eGetPrevProjectsRequest:
 		result = dbrh->handlePrevProjectsRequest(request);
 		break;
@@ -86,7 +205,35 @@ std::string RequestHandler::handleNotImplementedRequest()
 	return HTTPStatusCodes::clientError("Request not implemented yet.");
 }
 
-ERequestType RequestHandler::getERequestType(std::string requestType)
+ERequestLane RequestHandler::getLane(ERequestType eRequest)
+{
+	switch (eRequest)
+	{
+	case eGetIPs:
+	case eGetJobState:
+	case eGetTopJob:
+	case eUpdateJob:
+	case eFinishJob:
+		return eJobLane;
+	case eCheck:
+		return eCheckLane;
+	case eUpload:
+	case eCheckUpload:
+	case eUploadJob:
+	case eUploadCrawlData:
+		return eUploadLane;
+	case eExtractProjects:
+	case eGetAuthor:
+	case eGetMethodByAuthor:
+	case eGetMethodByAuthorPage:
+	case eGetPrevProjectsRequest:
+		return eAnalyticsLane;
+	default:
+		return eNoLane;
+	}
+}
+
+ERequestType RequestHandler::getERequestType(const std::string &requestType)
 {
 	if (requestType == "upld")
 	{
@@ -104,10 +251,18 @@ ERequestType RequestHandler::getERequestType(std::string requestType)
 	{
 		return eConnect;
 	}
+	else if (requestType == "vote")
+	{
+		return eVote;
+	}
 	else if (requestType == "gtip")
 	{
 		return eGetIPs;
 	}
+	else if (requestType == "gtjs")
+	{
+		return eGetJobState;
+	}
 	else if (requestType == "upjb")
 	{
 		return eUploadJob;
@@ -140,6 +295,10 @@ ERequestType RequestHandler::getERequestType(std::string requestType)
 	{
 		return eGetMethodByAuthor;
 	}
+	else if (requestType == "aump")
+	{
+		return eGetMethodByAuthorPage;
+	}
 	else if (requestType == "gppr")
 	{
 		return eGetPrevProjectsRequest;
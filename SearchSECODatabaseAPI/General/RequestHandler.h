@@ -5,6 +5,7 @@ Utrecht University within the Software Project course.
 */
 
 #pragma once
+#include "AdmissionControl.h"
 #include "DatabaseHandler.h"
 #include "JobRequestHandler.h"
 #include "DatabaseRequestHandler.h"
@@ -12,8 +13,24 @@ Utrecht University within the Software Project course.
 #include "DatabaseConnection.h"
 #include "Statistics.h"
 
+#include <condition_variable>
+#include <mutex>
 #include <boost/shared_ptr.hpp>
 
+// The amount of requests of each lane which can be handled at the same time.
+#define JOB_LANE_SLOTS 64
+#define CHECK_LANE_SLOTS 16
+#define UPLOAD_LANE_SLOTS 8
+#define ANALYTICS_LANE_SLOTS 4
+
+// The amount of requests of each lane which can wait for a place, further requests are rejected right away.
+#define JOB_LANE_QUEUE 256
+#define CHECK_LANE_QUEUE 64
+#define UPLOAD_LANE_QUEUE 16
+#define ANALYTICS_LANE_QUEUE 16
+#define LANE_MAX_WAIT 10000 // Milliseconds a request waits for a place in its lane before it is rejected.
+#define LANE_RETRY_AFTER 1000 // Milliseconds a rejected client is told to wait.
+
 class TcpConnection;
 
 /// <summary>
@@ -25,7 +42,9 @@ enum ERequestType
 	eCheck,
 	eCheckUpload,
 	eConnect,
+	eVote,
 	eGetIPs,
+	eGetJobState,
 	eUploadJob,
 	eUploadCrawlData,
 	eGetTopJob,
@@ -34,10 +53,25 @@ enum ERequestType
 	eExtractProjects,
 	eGetAuthor,
 	eGetMethodByAuthor,
+	eGetMethodByAuthorPage,
 	eGetPrevProjectsRequest,
 	eUnknown
 };
 
+/// <summary>
+/// The lanes in which requests are scheduled. Each lane can handle a limited amount of requests at the same time,
+/// so large uploads or analytics cannot take all threads and database connections away from the workers.
+/// Requests of the RAFT consensus itself are never held back.
+/// </summary>
+enum ERequestLane
+{
+	eJobLane,
+	eCheckLane,
+	eUploadLane,
+	eAnalyticsLane,
+	eNoLane
+};
+
 
 class RequestHandler
 {
@@ -50,6 +84,7 @@ public:
 
 	/// <summary>
 	/// Handles all requests send to the database.
+	/// Requests are rejected right away when their client does too many of them, or the node is overloaded.
 	/// </summary>
 	/// <param name="requestType">
 	/// Type of the request, a string of exactly 4 characters.
@@ -61,15 +96,67 @@ public:
 	/// <returns>
 	/// Response towards user after processing the request successfully.
 	/// </returns>
-	virtual std::string handleRequest(std::string requestType, std::string client, std::string request,
-									  boost::shared_ptr<TcpConnection> connection);
+	/// <param name="forwarded">
+	/// True if the request was passed on by another node, which already took it from the budget of the client.
+	/// </param>
+	virtual std::string handleRequest(const std::string &requestType, const std::string &client,
+									  const std::string &request, boost::shared_ptr<TcpConnection> connection,
+									  bool forwarded = false);
 
 	JobRequestHandler *getJobRequestHandler()
 	{
 		return jrh;
 	}
 
+	/// <summary>
+	/// Waits until the given lane has room for another request and takes its place.
+	/// The time spent waiting is added to the statistics.
+	/// </summary>
+	/// <returns>
+	/// False if too many requests are waiting for the lane already, or no place came free within LANE_MAX_WAIT.
+	/// No place is taken then.
+	/// </returns>
+	bool enterLane(ERequestLane lane);
+
+	/// <summary>
+	/// Gives up the place of a request in the given lane.
+	/// </summary>
+	void leaveLane(ERequestLane lane);
+
 private:
+	/// <summary>
+	/// Holds a place in a lane for as long as it exists, so the place is given up even if handling the request throws.
+	/// </summary>
+	class LanePlace
+	{
+	public:
+		LanePlace(RequestHandler *handler, ERequestLane lane) : handler(handler), lane(lane)
+		{
+			entered = handler->enterLane(lane);
+		}
+
+		~LanePlace()
+		{
+			if (entered)
+			{
+				handler->leaveLane(lane);
+			}
+		}
+
+		/// <summary>
+		/// Returns false if the request did not get a place, and should be rejected.
+		/// </summary>
+		bool hasPlace()
+		{
+			return entered;
+		}
+
+	private:
+		RequestHandler *handler;
+		ERequestLane lane;
+		bool entered;
+	};
+
 	/// <summary>
 	/// Handles unknown requests.
 	/// </summary>
@@ -95,8 +182,33 @@ private:
 	/// <returns>
 	/// The corresponding ERequestType.
 	/// </returns>
-	ERequestType getERequestType(std::string requestType);
+	ERequestType getERequestType(const std::string &requestType);
+
+	/// <summary>
+	/// Returns the lane in which the given type of request is handled.
+	/// </summary>
+	ERequestLane getLane(ERequestType eRequest);
+
+	/// <summary>
+	/// Handles the request in the lane of which a place has already been taken.
+	/// </summary>
+	std::string dispatchRequest(ERequestType eRequest, const std::string &requestType, const std::string &client,
+								const std::string &request, boost::shared_ptr<TcpConnection> connection);
+
+	/// <summary>
+	/// Checks if the connection comes from one of the nodes in the network.
+	/// </summary>
+	bool isFromNode(boost::shared_ptr<TcpConnection> connection);
 
 	DatabaseRequestHandler *dbrh;
 	JobRequestHandler *jrh;
+	RAFTConsensus *raft = nullptr;
+	Statistics *stats = nullptr;
+	AdmissionControl admissionControl;
+
+	// The amount of requests being handled in and waiting for each lane, guarded by lanemtx.
+	int inLane[eNoLane] = {};
+	int waitingForLane[eNoLane] = {};
+	std::condition_variable laneFree[eNoLane];
+	std::mutex lanemtx;
 };
@@ -0,0 +1,74 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#pragma once
+#include <errno.h>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <utility>
+
+/// <summary>
+/// Merges concurrent calls for the same key into one call, of which the result is given to all callers.
+/// </summary>
+template <class Key, class Value> class SingleFlight
+{
+public:
+	/// <summary>
+	/// Calls the function, unless a call for the same key is already in progress, in which case its result is
+	/// waited for instead. The errno set by the function is set for all callers.
+	/// </summary>
+	/// <param name="shared"> Set to true if the result of another call was used. </param>
+	Value call(Key key, std::function<Value()> function, bool &shared)
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		auto it = calls.find(key);
+		if (it != calls.end())
+		{
+			std::shared_future<std::pair<Value, int>> result = it->second;
+			lock.unlock();
+			shared = true;
+			std::pair<Value, int> value = result.get();
+			errno = value.second;
+			return value.first;
+		}
+		std::promise<std::pair<Value, int>> promise;
+		calls[key] = promise.get_future().share();
+		lock.unlock();
+		shared = false;
+
+		std::pair<Value, int> value;
+		try
+		{
+			value.first = function();
+			value.second = errno;
+			promise.set_value(value);
+		}
+		catch (...)
+		{
+			promise.set_exception(std::current_exception());
+			finish(key);
+			throw;
+		}
+		finish(key);
+		errno = value.second;
+		return value.first;
+	}
+
+private:
+	/// <summary>
+	/// Lets calls for the key which start from now on do their own call.
+	/// </summary>
+	void finish(Key key)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		calls.erase(key);
+	}
+
+	std::map<Key, std::shared_future<std::pair<Value, int>>> calls;
+	std::mutex mtx;
+};
@@ -60,6 +60,57 @@ void Statistics::Initialize()
 						  .Help("The latest vulnerabilities that have been received.")
 						  .Register(*registry);
 
+	failoverDuration = &prometheus::BuildGauge()
+							.Name("api_leader_failover_milliseconds")
+							.Help("Time it took to find a new leader after the last one dropped out.")
+							.Register(*registry);
+
+	duplicateJobCounter = &prometheus::BuildCounter()
+							   .Name("api_duplicate_jobs_total")
+							   .Help("Number of uploaded jobs skipped because their url was already in the job queue.")
+							   .Register(*registry);
+
+	laneQueueingTime = &prometheus::BuildHistogram()
+							.Name("api_lane_queueing_seconds")
+							.Help("Time requests waited for a place in their lane before being handled.")
+							.Register(*registry);
+
+	shedCounter = &prometheus::BuildCounter()
+					   .Name("api_shed_requests_total")
+					   .Help("Number of requests rejected because of too many requests.")
+					   .Register(*registry);
+
+	coalescedLookupCounter = &prometheus::BuildCounter()
+								  .Name("api_coalesced_lookups_total")
+								  .Help("Number of hash lookups which used the result of an identical lookup in progress.")
+								  .Register(*registry);
+
+	methodCacheCounter = &prometheus::BuildCounter()
+							  .Name("api_method_cache_lookups_total")
+							  .Help("Number of hash lookups in the method cache, by whether the hash was found.")
+							  .Register(*registry);
+
+	negativeCacheCounter = &prometheus::BuildCounter()
+								.Name("api_negative_cache_lookups_total")
+								.Help("Number of hash lookups in the cache of hashes without methods, by whether the "
+									  "hash was found.")
+								.Register(*registry);
+
+	negativeCacheSize = &prometheus::BuildGauge()
+							 .Name("api_negative_cache_hashes")
+							 .Help("Number of hashes without methods which are remembered.")
+							 .Register(*registry);
+
+	negativeCacheBytes = &prometheus::BuildGauge()
+							  .Name("api_negative_cache_bytes")
+							  .Help("Memory used by the cache of hashes without methods.")
+							  .Register(*registry);
+
+	uploadArenaCounter = &prometheus::BuildCounter()
+							  .Name("api_upload_arena_heap_total")
+							  .Help("Heap allocations and bytes used by the arenas of upload requests, by unit.")
+							  .Register(*registry);
+
 	// Ask the exposer to scrape the registry on incoming HTTP requests.
 	exposer->RegisterCollectable(registry);
 }
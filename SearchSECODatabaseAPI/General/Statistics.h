@@ -7,6 +7,7 @@ Utrecht University within the Software Project course.
 #pragma once
 
 #include <prometheus/counter.h>
+#include <prometheus/histogram.h>
 #include <prometheus/exposer.h>
 #include <prometheus/registry.h>
 #include <queue>
@@ -78,6 +79,16 @@ class Statistics
 	prometheus::Family<prometheus::Counter> *vulnCounter;
 	prometheus::Family<prometheus::Gauge> *recentProjects;
 	prometheus::Family<prometheus::Gauge> *recentVulns;
+	prometheus::Family<prometheus::Gauge> *failoverDuration;
+	prometheus::Family<prometheus::Counter> *duplicateJobCounter;
+	prometheus::Family<prometheus::Histogram> *laneQueueingTime;
+	prometheus::Family<prometheus::Counter> *shedCounter;
+	prometheus::Family<prometheus::Counter> *coalescedLookupCounter;
+	prometheus::Family<prometheus::Counter> *methodCacheCounter;
+	prometheus::Family<prometheus::Counter> *negativeCacheCounter;
+	prometheus::Family<prometheus::Gauge> *negativeCacheSize;
+	prometheus::Family<prometheus::Gauge> *negativeCacheBytes;
+	prometheus::Family<prometheus::Counter> *uploadArenaCounter;
 
 	// The ip of this node for identifying the node in the statistics.
 	std::string myIP;
@@ -102,6 +102,22 @@ std::vector<std::string> Utility::splitStringOn(std::string str, char delimiter)
 	return substrings;
 }
 
+void Utility::splitStringOn(std::string_view str, char delimiter, std::pmr::vector<std::string_view> &substrings)
+{
+	// Like getline, an empty string after the last delimiter is not a substring.
+	size_t start = 0;
+	while (start < str.size())
+	{
+		size_t end = str.find(delimiter, start);
+		if (end == std::string_view::npos)
+		{
+			end = str.size();
+		}
+		substrings.push_back(str.substr(start, end - start));
+		start = end + 1;
+	}
+}
+
 std::string Utility::hashToUUIDString(std::string hash)
 {
 	return hash.substr(0, 8) + "-" + hash.substr(8, 4) + "-" + hash.substr(12, 4) + "-" + hash.substr(16, 4) + "-" +
@@ -5,7 +5,9 @@ Utrecht University within the Software Project course.
 */
 
 #pragma once
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
 #include <math.h>
@@ -88,6 +90,14 @@ public:
 	/// <returns> A vector of the substrings obtained by splitting the string. </returns>
 	static std::vector<std::string> splitStringOn(std::string str, char delimiter);
 
+	/// <summary>
+	/// Splits a string on a special character like splitStringOn, without copying the substrings.
+	/// </summary>
+	/// <param name="str"> The string to be split, which should outlive the substrings. </param>
+	/// <param name="delimiter"> The character on which the string is split. </param>
+	/// <param name="substrings"> The vector the substrings are added to. </param>
+	static void splitStringOn(std::string_view str, char delimiter, std::pmr::vector<std::string_view> &substrings);
+
 	/// <summary>
 	/// Changes a string with the format of a hash to a string with the format of a UUID.
 	/// </summary>
@@ -35,7 +35,13 @@ documentation and/or software.
 #include "md5.h"
 
 /* system implementation headers */
+#include <algorithm>
 #include <cstdio>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 
 // Constants for MD5Transform routine.
@@ -348,6 +354,17 @@ std::string MD5::hexdigest() const
 
 //////////////////////////////
 
+// copy the raw digest, which is all zeros before finalize()
+void MD5::copyDigest(unsigned char out[16]) const
+{
+	if (finalized)
+		memcpy(out, digest, 16);
+	else
+		memset(out, 0, 16);
+}
+
+//////////////////////////////
+
 std::ostream& operator<<(std::ostream& out, MD5 md5)
 {
 	return out << md5.hexdigest();
@@ -360,4 +377,182 @@ std::string md5(const std::string str)
 	MD5 md5 = MD5(str);
 
 	return md5.hexdigest();
-}
\ No newline at end of file
+}
+//////////////////////////////
+
+#ifdef __SSE2__
+
+// the number of messages hashed at once, one in each 32 bit lane of an SSE2 register
+#define MD5_LANES 4
+
+// the rounds of MD5 on four lanes, SSE2 has no rotate so it is done with two shifts
+#define LANE_ROTATE(x, n) _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n))
+#define LANE_F(x, y, z) _mm_or_si128(_mm_and_si128(x, y), _mm_andnot_si128(x, z))
+#define LANE_G(x, y, z) _mm_or_si128(_mm_and_si128(x, z), _mm_andnot_si128(z, y))
+#define LANE_H(x, y, z) _mm_xor_si128(_mm_xor_si128(x, y), z)
+#define LANE_I(x, y, z) _mm_xor_si128(y, _mm_or_si128(x, _mm_xor_si128(z, _mm_set1_epi32(-1))))
+#define LANE_STEP(f, a, b, c, d, x, s, ac) \
+	a = _mm_add_epi32(LANE_ROTATE(_mm_add_epi32(_mm_add_epi32(a, f(b, c, d)), \
+		_mm_add_epi32(x, _mm_set1_epi32((int)ac))), s), b)
+
+// the number of 64 byte blocks a message takes after padding
+static size_t paddedBlocks(size_t length)
+{
+	return (length + 8) / 64 + 1;
+}
+
+// writes the padded message, followed by its length in bits, to out
+static void pad(std::string_view input, std::vector<unsigned char>& out)
+{
+	out.assign(paddedBlocks(input.size()) * 64, 0);
+	memcpy(out.data(), input.data(), input.size());
+	out[input.size()] = 0x80;
+	unsigned long long bits = (unsigned long long)input.size() * 8;
+	for (int i = 0; i < 8; i++)
+		out[out.size() - 8 + i] = (bits >> (8 * i)) & 0xff;
+}
+
+// hashes up to four messages, one in each lane, lanes which have no more blocks keep their state
+// padded holds a buffer for each lane, which is reused between calls
+static void md5Lanes(const std::string_view inputs[], size_t count, unsigned char digests[][16],
+	std::vector<unsigned char> padded[MD5_LANES])
+{
+	size_t blocks[MD5_LANES] = {0, 0, 0, 0};
+	size_t maxBlocks = 0;
+	for (size_t lane = 0; lane < count; lane++) {
+		pad(inputs[lane], padded[lane]);
+		blocks[lane] = padded[lane].size() / 64;
+		maxBlocks = std::max(maxBlocks, blocks[lane]);
+	}
+
+	__m128i state[4] = {_mm_set1_epi32(0x67452301), _mm_set1_epi32((int)0xefcdab89),
+		_mm_set1_epi32((int)0x98badcfe), _mm_set1_epi32(0x10325476)};
+
+	for (size_t block = 0; block < maxBlocks; block++) {
+		// gather word i of the current block of every lane, little endian like MD5::decode
+		unsigned int words[16][MD5_LANES] = {};
+		int active[MD5_LANES] = {0, 0, 0, 0};
+		for (size_t lane = 0; lane < count; lane++) {
+			if (block >= blocks[lane])
+				continue;
+			active[lane] = -1;
+			const unsigned char* input = &padded[lane][block * 64];
+			for (int i = 0; i < 16; i++)
+				words[i][lane] = (unsigned int)input[4 * i] | ((unsigned int)input[4 * i + 1] << 8) |
+					((unsigned int)input[4 * i + 2] << 16) | ((unsigned int)input[4 * i + 3] << 24);
+		}
+		__m128i x[16];
+		for (int i = 0; i < 16; i++)
+			x[i] = _mm_loadu_si128((const __m128i*)words[i]);
+		__m128i mask = _mm_loadu_si128((const __m128i*)active);
+
+		__m128i a = state[0], b = state[1], c = state[2], d = state[3];
+
+		/* Round 1 */
+		LANE_STEP(LANE_F, a, b, c, d, x[0], S11, 0xd76aa478);
+		LANE_STEP(LANE_F, d, a, b, c, x[1], S12, 0xe8c7b756);
+		LANE_STEP(LANE_F, c, d, a, b, x[2], S13, 0x242070db);
+		LANE_STEP(LANE_F, b, c, d, a, x[3], S14, 0xc1bdceee);
+		LANE_STEP(LANE_F, a, b, c, d, x[4], S11, 0xf57c0faf);
+		LANE_STEP(LANE_F, d, a, b, c, x[5], S12, 0x4787c62a);
+		LANE_STEP(LANE_F, c, d, a, b, x[6], S13, 0xa8304613);
+		LANE_STEP(LANE_F, b, c, d, a, x[7], S14, 0xfd469501);
+		LANE_STEP(LANE_F, a, b, c, d, x[8], S11, 0x698098d8);
+		LANE_STEP(LANE_F, d, a, b, c, x[9], S12, 0x8b44f7af);
+		LANE_STEP(LANE_F, c, d, a, b, x[10], S13, 0xffff5bb1);
+		LANE_STEP(LANE_F, b, c, d, a, x[11], S14, 0x895cd7be);
+		LANE_STEP(LANE_F, a, b, c, d, x[12], S11, 0x6b901122);
+		LANE_STEP(LANE_F, d, a, b, c, x[13], S12, 0xfd987193);
+		LANE_STEP(LANE_F, c, d, a, b, x[14], S13, 0xa679438e);
+		LANE_STEP(LANE_F, b, c, d, a, x[15], S14, 0x49b40821);
+
+		/* Round 2 */
+		LANE_STEP(LANE_G, a, b, c, d, x[1], S21, 0xf61e2562);
+		LANE_STEP(LANE_G, d, a, b, c, x[6], S22, 0xc040b340);
+		LANE_STEP(LANE_G, c, d, a, b, x[11], S23, 0x265e5a51);
+		LANE_STEP(LANE_G, b, c, d, a, x[0], S24, 0xe9b6c7aa);
+		LANE_STEP(LANE_G, a, b, c, d, x[5], S21, 0xd62f105d);
+		LANE_STEP(LANE_G, d, a, b, c, x[10], S22, 0x2441453);
+		LANE_STEP(LANE_G, c, d, a, b, x[15], S23, 0xd8a1e681);
+		LANE_STEP(LANE_G, b, c, d, a, x[4], S24, 0xe7d3fbc8);
+		LANE_STEP(LANE_G, a, b, c, d, x[9], S21, 0x21e1cde6);
+		LANE_STEP(LANE_G, d, a, b, c, x[14], S22, 0xc33707d6);
+		LANE_STEP(LANE_G, c, d, a, b, x[3], S23, 0xf4d50d87);
+		LANE_STEP(LANE_G, b, c, d, a, x[8], S24, 0x455a14ed);
+		LANE_STEP(LANE_G, a, b, c, d, x[13], S21, 0xa9e3e905);
+		LANE_STEP(LANE_G, d, a, b, c, x[2], S22, 0xfcefa3f8);
+		LANE_STEP(LANE_G, c, d, a, b, x[7], S23, 0x676f02d9);
+		LANE_STEP(LANE_G, b, c, d, a, x[12], S24, 0x8d2a4c8a);
+
+		/* Round 3 */
+		LANE_STEP(LANE_H, a, b, c, d, x[5], S31, 0xfffa3942);
+		LANE_STEP(LANE_H, d, a, b, c, x[8], S32, 0x8771f681);
+		LANE_STEP(LANE_H, c, d, a, b, x[11], S33, 0x6d9d6122);
+		LANE_STEP(LANE_H, b, c, d, a, x[14], S34, 0xfde5380c);
+		LANE_STEP(LANE_H, a, b, c, d, x[1], S31, 0xa4beea44);
+		LANE_STEP(LANE_H, d, a, b, c, x[4], S32, 0x4bdecfa9);
+		LANE_STEP(LANE_H, c, d, a, b, x[7], S33, 0xf6bb4b60);
+		LANE_STEP(LANE_H, b, c, d, a, x[10], S34, 0xbebfbc70);
+		LANE_STEP(LANE_H, a, b, c, d, x[13], S31, 0x289b7ec6);
+		LANE_STEP(LANE_H, d, a, b, c, x[0], S32, 0xeaa127fa);
+		LANE_STEP(LANE_H, c, d, a, b, x[3], S33, 0xd4ef3085);
+		LANE_STEP(LANE_H, b, c, d, a, x[6], S34, 0x4881d05);
+		LANE_STEP(LANE_H, a, b, c, d, x[9], S31, 0xd9d4d039);
+		LANE_STEP(LANE_H, d, a, b, c, x[12], S32, 0xe6db99e5);
+		LANE_STEP(LANE_H, c, d, a, b, x[15], S33, 0x1fa27cf8);
+		LANE_STEP(LANE_H, b, c, d, a, x[2], S34, 0xc4ac5665);
+
+		/* Round 4 */
+		LANE_STEP(LANE_I, a, b, c, d, x[0], S41, 0xf4292244);
+		LANE_STEP(LANE_I, d, a, b, c, x[7], S42, 0x432aff97);
+		LANE_STEP(LANE_I, c, d, a, b, x[14], S43, 0xab9423a7);
+		LANE_STEP(LANE_I, b, c, d, a, x[5], S44, 0xfc93a039);
+		LANE_STEP(LANE_I, a, b, c, d, x[12], S41, 0x655b59c3);
+		LANE_STEP(LANE_I, d, a, b, c, x[3], S42, 0x8f0ccc92);
+		LANE_STEP(LANE_I, c, d, a, b, x[10], S43, 0xffeff47d);
+		LANE_STEP(LANE_I, b, c, d, a, x[1], S44, 0x85845dd1);
+		LANE_STEP(LANE_I, a, b, c, d, x[8], S41, 0x6fa87e4f);
+		LANE_STEP(LANE_I, d, a, b, c, x[15], S42, 0xfe2ce6e0);
+		LANE_STEP(LANE_I, c, d, a, b, x[6], S43, 0xa3014314);
+		LANE_STEP(LANE_I, b, c, d, a, x[13], S44, 0x4e0811a1);
+		LANE_STEP(LANE_I, a, b, c, d, x[4], S41, 0xf7537e82);
+		LANE_STEP(LANE_I, d, a, b, c, x[11], S42, 0xbd3af235);
+		LANE_STEP(LANE_I, c, d, a, b, x[2], S43, 0x2ad7d2bb);
+		LANE_STEP(LANE_I, b, c, d, a, x[9], S44, 0xeb86d391);
+
+		// only lanes which still had a block take the new state
+		state[0] = _mm_add_epi32(state[0], _mm_and_si128(a, mask));
+		state[1] = _mm_add_epi32(state[1], _mm_and_si128(b, mask));
+		state[2] = _mm_add_epi32(state[2], _mm_and_si128(c, mask));
+		state[3] = _mm_add_epi32(state[3], _mm_and_si128(d, mask));
+	}
+
+	unsigned int result[4][MD5_LANES];
+	for (int i = 0; i < 4; i++)
+		_mm_storeu_si128((__m128i*)result[i], state[i]);
+	for (size_t lane = 0; lane < count; lane++)
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				digests[lane][4 * i + j] = (result[i][lane] >> (8 * j)) & 0xff;
+}
+
+void md5Batch(const std::string_view inputs[], size_t count, unsigned char digests[][16])
+{
+	std::vector<unsigned char> padded[MD5_LANES];
+	for (size_t i = 0; i < count; i += MD5_LANES)
+		md5Lanes(&inputs[i], std::min((size_t)MD5_LANES, count - i), &digests[i], padded);
+}
+
+#else
+
+void md5Batch(const std::string_view inputs[], size_t count, unsigned char digests[][16])
+{
+	for (size_t i = 0; i < count; i++) {
+		MD5 md5;
+		md5.update(inputs[i].data(), inputs[i].size());
+		md5.finalize();
+		md5.copyDigest(digests[i]);
+	}
+}
+
+#endif
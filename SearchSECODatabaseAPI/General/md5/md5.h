@@ -35,6 +35,7 @@ documentation and/or software.
 
 #include <cstring>
 #include <iostream>
+#include <string_view>
 
 
 // a small class for calculating MD5 hashes of strings or byte arrays
@@ -58,6 +59,7 @@ public:
 	void update(const char* buf, size_type length);
 	MD5& finalize();
 	std::string hexdigest() const;
+	void copyDigest(unsigned char out[16]) const;
 	friend std::ostream& operator<<(std::ostream&, MD5 md5);
 
 private:
@@ -90,4 +92,8 @@ private:
 
 std::string md5(const std::string str);
 
+// hashes many messages at once, which is faster than hashing them one by one
+// when they are short, the raw 16 byte digest of inputs[i] is written to digests[i]
+void md5Batch(const std::string_view inputs[], size_t count, unsigned char digests[][16]);
+
 #endif
\ No newline at end of file
@@ -9,23 +9,32 @@ Utrecht University within the Software Project course.
 #include "Utility.h"
 #include "DatabaseUtility.h"
 
+#include <algorithm>
 #include <iostream>
 #include <chrono>
+#include <climits>
+#include <functional>
 #include <unistd.h>
 
+DatabaseConnection::DatabaseConnection(int buckets)
+	: buckets(buckets), bucketHeads(std::vector<Job>(buckets)), headKnown(std::vector<bool>(buckets, false))
+{
+}
+
 void DatabaseConnection::connect(std::string ip, int port)
 {
 	connection = DatabaseUtility::connect(ip, port, "jobs");
+	uuidGen = cass_uuid_gen_new();
 	setPreparedStatements();
 }
 
 void DatabaseConnection::setPreparedStatements()
 {
 	preparedGetTopJob =
-		DatabaseUtility::prepareStatement(connection, "SELECT * FROM jobs.jobsqueue WHERE constant = 1 LIMIT 1");
+		DatabaseUtility::prepareStatement(connection, "SELECT * FROM jobs.jobsqueue WHERE constant = ? LIMIT 1");
 
 	preparedDeleteTopJob = DatabaseUtility::prepareStatement(
-		connection, "DELETE FROM jobs.jobsqueue WHERE constant = 1 AND priority = ? AND jobid = ?");
+		connection, "DELETE FROM jobs.jobsqueue WHERE constant = ? AND priority = ? AND jobid = ?");
 
 	preparedAddCurrentJob = DatabaseUtility::prepareStatement(
 		connection,
@@ -46,87 +55,155 @@ void DatabaseConnection::setPreparedStatements()
 
 	preparedUploadJob = DatabaseUtility::prepareStatement(
 		connection,
-		"INSERT INTO jobs.jobsqueue (constant, jobid, priority, url, retries, timeout) VALUES (1, uuid(), ?, ?, ?, ?)");
+		"INSERT INTO jobs.jobsqueue (constant, jobid, priority, url, retries, timeout) VALUES (?, uuid(), ?, ?, ?, ?)");
 
 	preparedUploadRetryJob = DatabaseUtility::prepareStatement(
 		connection,
-		"INSERT INTO jobs.jobsqueue (constant, jobid, priority, url, retries, timeout) VALUES (1, ?, ?, ?, ?, ?)");
+		"INSERT INTO jobs.jobsqueue (constant, jobid, priority, url, retries, timeout) VALUES (?, ?, ?, ?, ?, ?)");
 
 	preparedAmountOfJobs =
-		DatabaseUtility::prepareStatement(connection, "SELECT COUNT(*) FROM jobs.jobsqueue WHERE constant = 1");
+		DatabaseUtility::prepareStatement(connection, "SELECT COUNT(*) FROM jobs.jobsqueue WHERE constant = ?");
 
 	preparedCrawlID =
 		DatabaseUtility::prepareStatement(connection, "SELECT * FROM jobs.variables WHERE name = 'crawlID'");
 
 	preparedUpdateCrawlID =
 		DatabaseUtility::prepareStatement(connection, "UPDATE jobs.variables SET value = ? WHERE name = 'crawlID'");
+
+	preparedQueuedUrls = DatabaseUtility::prepareStatement(connection, "SELECT url FROM jobs.jobsqueue");
+
+	preparedCurrentUrls = DatabaseUtility::prepareStatement(connection, "SELECT url FROM jobs.currentjobs");
 }
 
 Job DatabaseConnection::getTopJob()
 {
 	errno = 0;
-	CassStatement *query = cass_prepared_bind(preparedGetTopJob);
-	CassFuture *resultFuture = cass_session_execute(connection, query);
-	Job job;
-	if (cass_future_error_code(resultFuture) == CASS_OK)
+	std::lock_guard<std::mutex> lock(bucketMtx);
+	fetchBucketHeads();
+	if (errno != 0)
 	{
-		// Retrieve the result.
-		const CassResult *result = cass_future_get_result(resultFuture);
-		const CassRow *row = cass_result_first_row(result);
-		CassUuid id;
-
-		cass_value_get_uuid(cass_row_get_column_by_name(row, "jobid"), &id);
-		job.url = DatabaseUtility::getString(row, "url");
-		job.priority = DatabaseUtility::getInt64(row, "priority");
-		job.retries = DatabaseUtility::getInt32(row, "retries");
-		job.timeout = DatabaseUtility::getInt64(row, "timeout");
-		cass_statement_free(query);
-		cass_future_free(resultFuture);
+		return Job();
+	}
 
-		// Add job to list of current jobs.
-		long long currTime = addCurrentJob(id, job);
-		if (errno != 0)
+	// The first job of the queue is the first job with the lowest priority value over all partitions.
+	int top = -1;
+	for (int i = 0; i < buckets; i++)
+	{
+		if (bucketHeads[i].jobid != "" && (top == -1 || bucketHeads[i].priority < bucketHeads[top].priority))
 		{
-			return job;
+			top = i;
 		}
+	}
+	if (top == -1)
+	{
+		errno = ERANGE;
+		return Job();
+	}
 
-		// Delete the job that is returned.
-		deleteTopJob(id, job.priority);
-		if (errno != 0)
-		{
-			// Do not delete current job, to prevent a newer version of the job from being accidentally deleted.
-			return job;
-		}
+	Job job = bucketHeads[top];
+	headKnown[top] = false;
+	CassUuid id;
+	cass_uuid_from_string(job.jobid.c_str(), &id);
 
-		char jobid[CASS_UUID_STRING_LENGTH];
-		cass_uuid_string(id, jobid);
+	// Add job to list of current jobs.
+	long long currTime = addCurrentJob(id, job);
+	if (errno != 0)
+	{
+		return job;
+	}
 
-		// Return result.
-		
-		job.jobid = jobid;
-		job.time = currTime;
+	// Delete the job that is returned.
+	deleteTopJob(top + 1, id, job.priority);
+	if (errno != 0)
+	{
+		// Do not delete current job, to prevent a newer version of the job from being accidentally deleted.
 		return job;
 	}
-	else
+
+	// Return result.
+	job.time = currTime;
+	return job;
+}
+
+void DatabaseConnection::loadQueueHeads()
+{
+	errno = 0;
+	std::lock_guard<std::mutex> lock(bucketMtx);
+	fetchBucketHeads();
+}
+
+void DatabaseConnection::resetQueueState()
+{
+	bucketMtx.lock();
+	headKnown = std::vector<bool>(buckets, false);
+	bucketMtx.unlock();
+}
+
+void DatabaseConnection::fetchBucketHeads()
+{
+	// Send the queries for all partitions first, so they are handled at the same time.
+	std::vector<std::pair<int, CassFuture *>> futures;
+	for (int i = 0; i < buckets; i++)
 	{
-		// An error occurred, which is handled below.
-		const char *message;
-		size_t messageLength;
-		cass_future_error_message(resultFuture, &message, &messageLength);
-		fprintf(stderr, "Unable to get job: '%.*s'\n", (int)messageLength, message);
+		if (headKnown[i])
+		{
+			continue;
+		}
+		CassStatement *query = cass_prepared_bind(preparedGetTopJob);
+		cass_statement_bind_int32(query, 0, i + 1);
+		futures.push_back(std::pair<int, CassFuture *>(i, cass_session_execute(connection, query)));
 		cass_statement_free(query);
-		errno = ENETUNREACH;
-		return job;
+	}
+
+	for (auto future : futures)
+	{
+		int i = future.first;
+		CassFuture *resultFuture = future.second;
+		if (cass_future_error_code(resultFuture) == CASS_OK)
+		{
+			// Retrieve the result.
+			const CassResult *result = cass_future_get_result(resultFuture);
+			Job job;
+			job.jobid = "";
+			if (cass_result_row_count(result) >= 1)
+			{
+				const CassRow *row = cass_result_first_row(result);
+				job.jobid = DatabaseUtility::getUUID(row, "jobid");
+				job.url = DatabaseUtility::getString(row, "url");
+				job.priority = DatabaseUtility::getInt64(row, "priority");
+				job.retries = DatabaseUtility::getInt32(row, "retries");
+				job.timeout = DatabaseUtility::getInt64(row, "timeout");
+			}
+			bucketHeads[i] = job;
+			headKnown[i] = true;
+			cass_result_free(result);
+		}
+		else
+		{
+			// An error occurred, which is handled below.
+			const char *message;
+			size_t messageLength;
+			cass_future_error_message(resultFuture, &message, &messageLength);
+			fprintf(stderr, "Unable to get job: '%.*s'\n", (int)messageLength, message);
+			errno = ENETUNREACH;
+		}
+		cass_future_free(resultFuture);
 	}
 }
 
-void DatabaseConnection::deleteTopJob(CassUuid id, cass_int64_t priority)
+int DatabaseConnection::getBucket(std::string url)
+{
+	return std::hash<std::string>()(url) % buckets + 1;
+}
+
+void DatabaseConnection::deleteTopJob(int bucket, CassUuid id, cass_int64_t priority)
 {
 	errno = 0;
 	CassStatement* query = cass_prepared_bind(preparedDeleteTopJob);
 
-	cass_statement_bind_int64(query, 0, priority);
-	cass_statement_bind_uuid(query, 1, id);
+	cass_statement_bind_int32(query, 0, bucket);
+	cass_statement_bind_int64(query, 1, priority);
+	cass_statement_bind_uuid(query, 2, id);
 
 	CassFuture* queryFuture = cass_session_execute(connection, query);
 
@@ -196,15 +273,9 @@ long long DatabaseConnection::addCurrentJob(Job job)
 long long DatabaseConnection::addCurrentJob(CassUuid id, Job job)
 {
 	errno = 0;
-	CassStatement *query = cass_prepared_bind(preparedAddCurrentJob);
-
-	cass_statement_bind_uuid_by_name(query, "jobid", id);
 	long long currTime = Utility::getCurrentTimeMilliSeconds();
-	cass_statement_bind_int64_by_name(query, "time", currTime);
-	cass_statement_bind_int64_by_name(query, "timeout", job.timeout);
-	cass_statement_bind_int64_by_name(query, "priority", job.priority);
-	cass_statement_bind_string_by_name(query, "url", job.url.c_str());
-	cass_statement_bind_int32_by_name(query, "retries", job.retries);	
+	job.time = currTime;
+	CassStatement *query = bindCurrentJob(id, job);
 
 	CassFuture *queryFuture = cass_session_execute(connection, query);
 
@@ -226,6 +297,88 @@ long long DatabaseConnection::addCurrentJob(CassUuid id, Job job)
 	return currTime;
 }
 
+std::vector<int> DatabaseConnection::renewCurrentJobs(std::vector<Job> jobs)
+{
+	std::vector<CassStatement *> queries;
+	for (Job job : jobs)
+	{
+		CassUuid id;
+		cass_uuid_from_string(job.jobid.c_str(), &id);
+		queries.push_back(bindCurrentJob(id, job));
+	}
+	return executeConcurrently(queries, "Unable to renew current job");
+}
+
+std::vector<int> DatabaseConnection::deleteCurrentJobs(std::vector<std::string> jobids)
+{
+	std::vector<CassStatement *> queries;
+	for (std::string jobid : jobids)
+	{
+		CassUuid id;
+		cass_uuid_from_string(jobid.c_str(), &id);
+		CassStatement *query = cass_prepared_bind(preparedDeleteCurrentJob);
+		cass_statement_bind_uuid_by_name(query, "jobid", id);
+		queries.push_back(query);
+	}
+	return executeConcurrently(queries, "Could not delete current job");
+}
+
+std::vector<int> DatabaseConnection::executeConcurrently(std::vector<CassStatement *> queries, std::string error)
+{
+	errno = 0;
+	std::vector<int> failed;
+
+	// The queries being executed, at most UPLOAD_WINDOW at the same time.
+	std::vector<std::pair<CassFuture *, int>> window;
+	auto finishQuery = [&](std::pair<CassFuture *, int> execution)
+	{
+		CassError rc = cass_future_error_code(execution.first);
+		if (rc != 0)
+		{
+			printf("%s: %s\n", error.c_str(), cass_error_desc(rc));
+			failed.push_back(execution.second);
+		}
+		cass_future_free(execution.first);
+	};
+
+	for (int i = 0; i < queries.size(); i++)
+	{
+		if (window.size() >= UPLOAD_WINDOW)
+		{
+			finishQuery(window.front());
+			window.erase(window.begin());
+		}
+		window.push_back(std::pair<CassFuture *, int>(cass_session_execute(connection, queries[i]), i));
+
+		// Statement objects can be freed immediately after being executed.
+		cass_statement_free(queries[i]);
+	}
+	for (auto execution : window)
+	{
+		finishQuery(execution);
+	}
+
+	std::sort(failed.begin(), failed.end());
+	if (failed.size() > 0)
+	{
+		errno = ENETUNREACH;
+	}
+	return failed;
+}
+
+CassStatement *DatabaseConnection::bindCurrentJob(CassUuid id, Job job)
+{
+	CassStatement *query = cass_prepared_bind(preparedAddCurrentJob);
+
+	cass_statement_bind_uuid_by_name(query, "jobid", id);
+	cass_statement_bind_int64_by_name(query, "time", job.time);
+	cass_statement_bind_int64_by_name(query, "timeout", job.timeout);
+	cass_statement_bind_int64_by_name(query, "priority", job.priority);
+	cass_statement_bind_string_by_name(query, "url", job.url.c_str());
+	cass_statement_bind_int32_by_name(query, "retries", job.retries);
+	return query;
+}
+
 Job DatabaseConnection::getCurrentJob(std::string jobid)
 {
 	errno = 0;
@@ -294,19 +447,7 @@ void DatabaseConnection::deleteCurrentJob(CassUuid id)
 void DatabaseConnection::addFailedJob(FailedJob job)
 {
 	errno = 0;
-	CassStatement *query = cass_prepared_bind(preparedAddFailedJob);
-
-	CassUuid jobid;
-	cass_uuid_from_string(job.jobid.c_str(), &jobid);
-
-	cass_statement_bind_uuid_by_name(query, "jobid", jobid);
-	cass_statement_bind_int64_by_name(query, "time", job.time);
-	cass_statement_bind_int64_by_name(query, "timeout", job.timeout);
-	cass_statement_bind_int64_by_name(query, "priority", job.priority);
-	cass_statement_bind_string_by_name(query, "url", job.url.c_str());
-	cass_statement_bind_int32_by_name(query, "retries", job.retries);
-	cass_statement_bind_int32_by_name(query, "reasonID", job.reasonID);
-	cass_statement_bind_string_by_name(query, "reasonData", job.reasonData.c_str());
+	CassStatement *query = bindFailedJob(job);
 
 	CassFuture *queryFuture = cass_session_execute(connection, query);
 
@@ -324,40 +465,88 @@ void DatabaseConnection::addFailedJob(FailedJob job)
 	cass_future_free(queryFuture);
 }
 
+std::vector<int> DatabaseConnection::addFailedJobs(std::vector<FailedJob> jobs)
+{
+	std::vector<CassStatement *> queries;
+	for (FailedJob job : jobs)
+	{
+		queries.push_back(bindFailedJob(job));
+	}
+	return executeConcurrently(queries, "Unable to add failed job");
+}
+
+CassStatement *DatabaseConnection::bindFailedJob(FailedJob job)
+{
+	CassStatement *query = cass_prepared_bind(preparedAddFailedJob);
+
+	CassUuid jobid;
+	cass_uuid_from_string(job.jobid.c_str(), &jobid);
+
+	cass_statement_bind_uuid_by_name(query, "jobid", jobid);
+	cass_statement_bind_int64_by_name(query, "time", job.time);
+	cass_statement_bind_int64_by_name(query, "timeout", job.timeout);
+	cass_statement_bind_int64_by_name(query, "priority", job.priority);
+	cass_statement_bind_string_by_name(query, "url", job.url.c_str());
+	cass_statement_bind_int32_by_name(query, "retries", job.retries);
+	cass_statement_bind_int32_by_name(query, "reasonID", job.reasonID);
+	cass_statement_bind_string_by_name(query, "reasonData", job.reasonData.c_str());
+	return query;
+}
+
 int DatabaseConnection::getNumberOfJobs()
 {
 	long long timeNow = Utility::getCurrentTimeSeconds();
 	if (timeNow - timeLastRecount > RECOUNT_WAIT_TIME)
 	{
 		errno = 0;
-		CassStatement *query = cass_prepared_bind(preparedAmountOfJobs);
-		CassFuture *resultFuture = cass_session_execute(connection, query);
-		if (cass_future_error_code(resultFuture) == CASS_OK)
+
+		// Count all partitions at the same time.
+		std::vector<CassFuture *> futures;
+		for (int i = 1; i <= buckets; i++)
 		{
-			// Retrieve the result.
-			const CassResult *result = cass_future_get_result(resultFuture);
-			const CassRow *row = cass_result_first_row(result);
-			long long count = DatabaseUtility::getInt64(row, "count");
+			CassStatement *query = cass_prepared_bind(preparedAmountOfJobs);
+			cass_statement_bind_int32(query, 0, i);
+			futures.push_back(cass_session_execute(connection, query));
 			cass_statement_free(query);
-			cass_future_free(resultFuture);
-			timeLastRecount = Utility::getCurrentTimeSeconds();
-			numberOfJobs = count;
 		}
-		else
+
+		long long count = 0;
+		for (CassFuture *resultFuture : futures)
 		{
-			// An error occurred, which is handled below.
-			const char *message;
-			size_t messageLength;
-			cass_future_error_message(resultFuture, &message, &messageLength);
-			fprintf(stderr, "Unable to get number of jobs: '%.*s'\n", (int)messageLength, message);
-			cass_statement_free(query);
+			if (cass_future_error_code(resultFuture) == CASS_OK)
+			{
+				// Retrieve the result.
+				const CassResult *result = cass_future_get_result(resultFuture);
+				const CassRow *row = cass_result_first_row(result);
+				count += DatabaseUtility::getInt64(row, "count");
+				cass_result_free(result);
+			}
+			else
+			{
+				// An error occurred, which is handled below.
+				const char *message;
+				size_t messageLength;
+				cass_future_error_message(resultFuture, &message, &messageLength);
+				fprintf(stderr, "Unable to get number of jobs: '%.*s'\n", (int)messageLength, message);
+				errno = ENETUNREACH;
+			}
 			cass_future_free(resultFuture);
-			errno = ENETUNREACH;
+		}
+		if (errno == 0)
+		{
+			timeLastRecount = Utility::getCurrentTimeSeconds();
+			numberOfJobs = count;
 		}
 	}
 	return numberOfJobs;
 }
 
+void DatabaseConnection::setNumberOfJobs(int amount)
+{
+	numberOfJobs = amount;
+	timeLastRecount = Utility::getCurrentTimeSeconds();
+}
+
 int DatabaseConnection::getCrawlID()
 {
 	errno = 0;
@@ -411,102 +600,249 @@ void DatabaseConnection::setCrawlID(int id)
 void DatabaseConnection::uploadJob(Job job, bool newJob)
 {
 	errno = 0;
-	CassStatement *query;
+	int bucket = getBucket(job.url);
+	CassStatement *query = bindUploadJob(job, newJob, bucket);
+
+	CassFuture *queryFuture = cass_session_execute(connection, query);
+
+	numberOfJobs++;
+
+	// Statement objects can be freed immediately after being executed.
+	cass_statement_free(query);
+
+	// This will block until the query has finished.
+	CassError rc = cass_future_error_code(queryFuture);
+
+	if (rc != CASS_OK)
+	{
+		printf("Query result: %s\n", cass_error_desc(rc));
+		errno = ENETUNREACH;
+	}
+	cass_future_free(queryFuture);
+
+	jobAdded(bucket, job.priority);
+}
+
+void DatabaseConnection::prepareNewJobs(std::vector<Job> &jobs)
+{
+	long long currentTime = Utility::getCurrentTimeMilliSeconds();
+	for (Job &job : jobs)
+	{
+		CassUuid id;
+		cass_uuid_gen_random(uuidGen, &id);
+		char idString[CASS_UUID_STRING_LENGTH];
+		cass_uuid_string(id, idString);
+		job.jobid = idString;
+		job.priority = currentTime - job.priority;
+	}
+}
+
+std::vector<int> DatabaseConnection::uploadJobs(std::vector<Job> jobs, bool newJobs)
+{
+	errno = 0;
+	std::vector<int> failed;
+
+	// Group the jobs per partition, so every batch only writes to a single partition.
+	std::vector<std::vector<int>> perBucket(buckets);
+	for (int i = 0; i < jobs.size(); i++)
+	{
+		perBucket[getBucket(jobs[i].url) - 1].push_back(i);
+	}
+
+	// The batches being written, with the jobs in them.
+	std::vector<std::pair<CassFuture *, std::vector<int>>> window;
+	auto finishBatch = [&](std::pair<CassFuture *, std::vector<int>> batch)
+	{
+		CassError rc = cass_future_error_code(batch.first);
+		if (rc != CASS_OK)
+		{
+			printf("Unable to add jobs: %s\n", cass_error_desc(rc));
+			failed.insert(failed.end(), batch.second.begin(), batch.second.end());
+		}
+		else
+		{
+			numberOfJobs += batch.second.size();
+		}
+		cass_future_free(batch.first);
+	};
+
+	for (int bucket = 1; bucket <= buckets; bucket++)
+	{
+		std::vector<int> &indices = perBucket[bucket - 1];
+		long long firstPriority = LLONG_MAX;
+		for (int start = 0; start < indices.size(); start += UPLOAD_BATCH_SIZE)
+		{
+			CassBatch *batch = cass_batch_new(CASS_BATCH_TYPE_UNLOGGED);
+			std::vector<int> batchIndices;
+			for (int i = start; i < indices.size() && i < start + UPLOAD_BATCH_SIZE; i++)
+			{
+				Job job = jobs[indices[i]];
+				CassStatement *query = bindUploadJob(job, newJobs, bucket);
+				cass_batch_add_statement(batch, query);
+				cass_statement_free(query);
+				batchIndices.push_back(indices[i]);
+				firstPriority = std::min(firstPriority, job.priority);
+			}
+
+			// Wait for the oldest batch if too many are being written already.
+			if (window.size() >= UPLOAD_WINDOW)
+			{
+				finishBatch(window.front());
+				window.erase(window.begin());
+			}
+			window.push_back(
+				std::pair<CassFuture *, std::vector<int>>(cass_session_execute_batch(connection, batch), batchIndices));
+			cass_batch_free(batch);
+		}
+		if (indices.size() > 0)
+		{
+			jobAdded(bucket, firstPriority);
+		}
+	}
+	for (auto batch : window)
+	{
+		finishBatch(batch);
+	}
 
-	long long resultPriority;
+	std::sort(failed.begin(), failed.end());
+	if (failed.size() > 0)
+	{
+		errno = ENETUNREACH;
+	}
+	return failed;
+}
+
+CassStatement *DatabaseConnection::bindUploadJob(Job &job, bool newJob, int bucket)
+{
+	CassStatement *query;
 	if (newJob)
 	{
 		query = cass_prepared_bind(preparedUploadJob);
 		long long currentTime = Utility::getCurrentTimeMilliSeconds();
-		resultPriority = currentTime - job.priority;
+		job.priority = currentTime - job.priority;
 	}
 	else
 	{
 		query = cass_prepared_bind(preparedUploadRetryJob);
-		resultPriority = job.priority;
 		CassUuid jobid;
 		cass_uuid_from_string(job.jobid.c_str(), &jobid);
 		cass_statement_bind_uuid_by_name(query, "jobid", jobid);
 	}
-	
-	cass_statement_bind_int64_by_name(query, "priority", resultPriority);
+
+	cass_statement_bind_int32_by_name(query, "constant", bucket);
+	cass_statement_bind_int64_by_name(query, "priority", job.priority);
 	cass_statement_bind_string_by_name(query, "url", job.url.c_str());
 	cass_statement_bind_int32_by_name(query, "retries", job.retries);
 	cass_statement_bind_int64_by_name(query, "timeout", job.timeout);
+	return query;
+}
 
-	CassFuture *queryFuture = cass_session_execute(connection, query);
+void DatabaseConnection::jobAdded(int bucket, long long priority)
+{
+	// The new job may be in front of the first job we know of for its partition.
+	std::lock_guard<std::mutex> lock(bucketMtx);
+	if (headKnown[bucket - 1] &&
+		(bucketHeads[bucket - 1].jobid == "" || priority <= bucketHeads[bucket - 1].priority))
+	{
+		headKnown[bucket - 1] = false;
+	}
+}
 
-	numberOfJobs++;
+std::vector<Job> DatabaseConnection::getTimedOutJobs(const std::set<std::string> &liveJobs)
+{
+	errno = 0;
+	CassStatement *query = cass_prepared_bind(preparedGetCurrentJobs);
+	cass_statement_set_consistency(query, CASS_CONSISTENCY_LOCAL_ONE);
+	CassFuture *resultFuture = cass_session_execute(connection, query);
 
-	// Statement objects can be freed immediately after being executed.
-	cass_statement_free(query);
+	std::vector<Job> timedOut;
 
-	// This will block until the query has finished.
-	CassError rc = cass_future_error_code(queryFuture);
+	if (cass_future_error_code(resultFuture) == CASS_OK)
+	{
+		const CassResult *result = cass_future_get_result(resultFuture);
 
-	if (rc != 0)
+		// Collect the jobs of which the timeout has passed.
+		CassIterator *iterator = cass_iterator_from_result(result);
+		long long currentTime = Utility::getCurrentTimeMilliSeconds();
+		while (cass_iterator_next(iterator))
+		{
+			Job job = retrieveCurrentJob(cass_iterator_get_row(iterator));
+			if (job.time + job.timeout < currentTime && liveJobs.find(job.jobid) == liveJobs.end())
+			{
+				timedOut.push_back(job);
+			}
+		}
+
+		cass_iterator_free(iterator);
+		cass_result_free(result);
+	}
+	else
 	{
-		printf("Query result: %s\n", cass_error_desc(rc));
+		// An error occurred which is handled below.
+		const char *message;
+		size_t messageLength;
+		cass_future_error_message(resultFuture, &message, &messageLength);
+		fprintf(stderr, "Unable to get current jobs: '%.*s'\n", (int)messageLength, message);
 		errno = ENETUNREACH;
 	}
-	cass_future_free(queryFuture);
+
+	cass_statement_free(query);
+	cass_future_free(resultFuture);
+	return timedOut;
 }
 
-void DatabaseConnection::updateCurrentJobs()
+std::vector<std::string> DatabaseConnection::getQueuedUrls(bool currentJobs, std::string &pagingState)
 {
-	while (true)
+	errno = 0;
+	CassStatement *query = cass_prepared_bind(currentJobs ? preparedCurrentUrls : preparedQueuedUrls);
+	cass_statement_set_paging_size(query, URL_PAGE_SIZE);
+	if (!pagingState.empty())
 	{
-		usleep(UPDATE_JOBS_TIMEOUT);
-		CassStatement *query = cass_prepared_bind(preparedGetCurrentJobs);
-		cass_statement_set_consistency(query, CASS_CONSISTENCY_LOCAL_ONE);
-		CassFuture *resultFuture = cass_session_execute(connection, query);
+		cass_statement_set_paging_state_token(query, pagingState.data(), pagingState.size());
+	}
 
-		if (cass_future_error_code(resultFuture) == CASS_OK)
-		{
-			const CassResult *result = cass_future_get_result(resultFuture);
+	CassFuture *resultFuture = cass_session_execute(connection, query);
 
-			// Add the methods found as the result of the query.
-			CassIterator *iterator = cass_iterator_from_result(result);
-			long long currentTime = Utility::getCurrentTimeMilliSeconds();
-			while (cass_iterator_next(iterator))
-			{
-				const CassRow *row = cass_iterator_get_row(iterator);
-				CassUuid jobid;
-				cass_value_get_uuid(cass_row_get_column_by_name(row, "jobid"), &jobid);
-				updateCurrentJob(jobid, retrieveCurrentJob(row), currentTime);
-			}
+	std::vector<std::string> urls;
 
-			cass_iterator_free(iterator);
-			cass_result_free(result);
+	if (cass_future_error_code(resultFuture) == CASS_OK)
+	{
+		const CassResult *result = cass_future_get_result(resultFuture);
+		CassIterator *iterator = cass_iterator_from_result(result);
+		while (cass_iterator_next(iterator))
+		{
+			urls.push_back(DatabaseUtility::getString(cass_iterator_get_row(iterator), "url"));
+		}
+
+		// The paging state is only changed once the page is retrieved, so a retry asks for the same page.
+		const char *token = nullptr;
+		size_t tokenLength = 0;
+		if (cass_result_has_more_pages(result) &&
+			cass_result_paging_state_token(result, &token, &tokenLength) == CASS_OK && token != nullptr)
+		{
+			pagingState.assign(token, tokenLength);
 		}
 		else
 		{
-			// An error occurred which is handled below.
-			const char *message;
-			size_t messageLength;
-			cass_future_error_message(resultFuture, &message, &messageLength);
-			fprintf(stderr, "Unable to get current jobs: '%.*s'\n", (int)messageLength, message);
-			errno = ENETUNREACH;
+			pagingState.clear();
 		}
 
-		cass_statement_free(query);
-		cass_future_free(resultFuture);
+		cass_iterator_free(iterator);
+		cass_result_free(result);
 	}
-}
-
-void DatabaseConnection::updateCurrentJob(CassUuid jobid, Job job, long long currentTime)
-{
-	if (job.time + job.timeout < currentTime)
+	else
 	{
-		FailedJob failedJob(job, 2, "Timed out at: " + std::to_string(currentTime));
-		addFailedJob(failedJob);
-		deleteCurrentJob(jobid);
-		if (job.retries < MAX_JOB_RETRIES)
-		{
-			job.retries++;
-			uploadJob(job, false);
-		}
+		// An error occurred, which is handled below.
+		const char *message;
+		size_t messageLength;
+		cass_future_error_message(resultFuture, &message, &messageLength);
+		fprintf(stderr, "Unable to get urls: '%.*s'\n", (int)messageLength, message);
+		errno = ENETUNREACH;
 	}
+
+	cass_statement_free(query);
+	cass_future_free(resultFuture);
+	return urls;
 }
 
 Job DatabaseConnection::retrieveCurrentJob(const CassRow *row)
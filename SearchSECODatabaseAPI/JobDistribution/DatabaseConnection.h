@@ -6,8 +6,13 @@ Utrecht University within the Software Project course.
 
 #pragma once
 #include "JobTypes.h"
+#include "UrlIndex.h"
 
+#include <atomic>
+#include <mutex>
+#include <set>
 #include <string>
+#include <vector>
 #include <cassandra.h>
 
 #define IP "cassandra"
@@ -16,6 +21,16 @@ Utrecht University within the Software Project course.
 #define MAX_JOB_RETRIES 1
 #define RECOUNT_WAIT_TIME 600
 
+// The job queue is spread over this many partitions, numbered 1 up to and including this amount.
+// Jobs from before the queue was spread are in partition 1, so this can be raised without moving any jobs.
+#define JOB_QUEUE_BUCKETS 16
+
+// Jobs uploaded together are written in batches of at most this many jobs, of which at most UPLOAD_WINDOW
+// batches are being written at the same time.
+#define UPLOAD_BATCH_SIZE 100
+#define UPLOAD_WINDOW 8
+#define URL_PAGE_SIZE 10000
+
 using namespace jobTypes;
 
 /// <summary>
@@ -24,6 +39,12 @@ using namespace jobTypes;
 class DatabaseConnection
 {
 public:
+	/// <summary>
+	/// Constructor method.
+	/// </summary>
+	/// <param name="buckets"> The amount of partitions the job queue is spread over. </param>
+	DatabaseConnection(int buckets = JOB_QUEUE_BUCKETS);
+
 	/// <summary>
 	/// Connect to the database.
 	/// </summary>
@@ -35,10 +56,28 @@ public:
 	/// </summary>
 	virtual void uploadJob(Job job, bool newJob);
 
+	/// <summary>
+	/// Gives new jobs their jobid and their priority in the queue, so they can be written again after a failure
+	/// without being added twice.
+	/// </summary>
+	virtual void prepareNewJobs(std::vector<Job> &jobs);
+
+	/// <summary>
+	/// Adds multiple new jobs to the database at once. The jobs are grouped per partition of the queue
+	/// and written in unlogged batches, several batches at the same time.
+	/// </summary>
+	/// <param name="jobs">
+	/// The jobs to add, with the priority as given by the user for new jobs and as it was in the queue otherwise.
+	/// </param>
+	/// <param name="newJobs"> False if the jobs were in the queue before and keep their jobid. </param>
+	/// <returns> The indices of the jobs which could not be added. Sets errno if this is not empty. </returns>
+	virtual std::vector<int> uploadJobs(std::vector<Job> jobs, bool newJobs = true);
+
 	/// <summary>
 	/// Retrieves the url of the first job in the jobs table and returns it.
+	/// The first job is found by comparing the first jobs of all partitions of the queue.
 	/// </summary>
-	/// <returns> Job object containing data on the top job. </returns>
+	/// <returns> Job object containing data on the top job. Sets errno to ERANGE if the queue is empty. </returns>
 	virtual Job getTopJob();
 
 	/// <summary>
@@ -63,16 +102,48 @@ public:
 	/// </summary>
 	virtual long long addCurrentJob(Job job);
 
+	/// <summary>
+	/// Writes the given jobs to the currentjobs table with the time they have, several at the same time.
+	/// </summary>
+	/// <returns> The indices of the jobs which could not be written. Sets errno if this is not empty. </returns>
+	virtual std::vector<int> renewCurrentJobs(std::vector<Job> jobs);
+
 	/// <summary>
 	/// Adds a job to the failedjobs table.
 	/// </summary>
 	virtual void addFailedJob(FailedJob job);
 
+	/// <summary>
+	/// Adds multiple jobs to the failedjobs table, several at the same time.
+	/// </summary>
+	/// <returns> The indices of the jobs which could not be added. Sets errno if this is not empty. </returns>
+	virtual std::vector<int> addFailedJobs(std::vector<FailedJob> jobs);
+
+	/// <summary>
+	/// Deletes the jobs with the given jobids from the currentjobs table, several at the same time.
+	/// </summary>
+	/// <returns> The indices of the jobs which could not be deleted. Sets errno if this is not empty. </returns>
+	virtual std::vector<int> deleteCurrentJobs(std::vector<std::string> jobids);
+
 	/// <summary>
 	/// Returns the amount of jobs in the jobs table.
 	/// </summary>
 	virtual int getNumberOfJobs();
 
+	/// <summary>
+	/// Returns the amount of jobs in the jobs table as counted last time, without counting again.
+	/// </summary>
+	int getCachedNumberOfJobs()
+	{
+		return numberOfJobs;
+	}
+
+	/// <summary>
+	/// Sets the amount of jobs in the jobs table, so they do not have to be counted again.
+	/// Used when taking over from a leader which already knew the amount.
+	/// </summary>
+	void setNumberOfJobs(int amount);
+
 	/// <summary>
 	/// Returns the current crawl ID in the database.
 	/// </summary>
@@ -84,15 +155,73 @@ public:
 	virtual void setCrawlID(int id);
 
 	/// <summary>
-	/// Regularly updates the current jobs to check for a timeout.
+	/// Checks the current jobs for a timeout once. The leader does this every UPDATE_JOBS_TIMEOUT, and moves
+	/// the jobs returned to the failed jobs. Sets errno if this fails.
 	/// </summary>
-	virtual void updateCurrentJobs();
+	/// <param name="liveJobs">
+	/// The jobs which are still being worked on according to the leader, whatever time the database has for them.
+	/// </param>
+	/// <returns> The current jobs of which the timeout has passed. </returns>
+	virtual std::vector<Job> getTimedOutJobs(const std::set<std::string> &liveJobs);
+
+	/// <summary>
+	/// Retrieves the first job of every partition of the queue which is not known yet, so the first job request
+	/// after becoming the leader does not have to wait for it. Sets errno if this fails.
+	/// </summary>
+	virtual void loadQueueHeads();
+
+	/// <summary>
+	/// Forgets the first jobs of the partitions, as the other nodes may have changed the queue since we were the
+	/// leader last. The urls of the jobs are kept, those are kept up to date by the heartbeat.
+	/// </summary>
+	void resetQueueState();
+
+	/// <summary>
+	/// Retrieves a page of at most URL_PAGE_SIZE urls of the jobs in the jobs table or the currentjobs table.
+	/// </summary>
+	/// <param name="currentJobs"> True to read the currentjobs table instead of the jobs table. </param>
+	/// <param name="pagingState">
+	/// Empty for the first page, and set to the state of the next page, or empty after the last page.
+	/// Only changed if the page could be retrieved.
+	/// </param>
+	virtual std::vector<std::string> getQueuedUrls(bool currentJobs, std::string &pagingState);
+
+	/// <summary>
+	/// Returns the urls of the jobs which are in the queue or being worked on, as known to the leader.
+	/// </summary>
+	UrlIndex *getUrlIndex()
+	{
+		return &urlIndex;
+	}
 
 private:
 	/// <summary>
-	/// Deletes the first job in the jobs table given its jobid and priority.
+	/// Deletes the first job in the jobs table given its partition, jobid and priority.
+	/// </summary>
+	void deleteTopJob(int bucket, CassUuid id, cass_int64_t priority);
+
+	/// <summary>
+	/// Retrieves the first job of every partition of the queue of which we do not know the first job yet.
+	/// Should be called while holding bucketMtx.
+	/// </summary>
+	void fetchBucketHeads();
+
+	/// <summary>
+	/// Returns the partition of the queue a job with the given url is put in.
+	/// </summary>
+	int getBucket(std::string url);
+
+	/// <summary>
+	/// Creates the statement which adds the given job to the given partition of the queue.
+	/// Sets the priority of the job to the priority it gets in the queue.
+	/// </summary>
+	CassStatement *bindUploadJob(Job &job, bool newJob, int bucket);
+
+	/// <summary>
+	/// Lets the next call to getTopJob look at the given partition again if a job with the given priority
+	/// may have been put in front of the first job we know of.
 	/// </summary>
-	void deleteTopJob(CassUuid id, cass_int64_t priority);
+	void jobAdded(int bucket, long long priority);
 
 	/// <summary>
 	/// Deletes the job in the currentjobs table given its jobid.
@@ -104,6 +233,11 @@ private:
 	/// </summary>
 	long long addCurrentJob(CassUuid id, Job job);
 
+	/// <summary>
+	/// Creates the statement which adds the given job to the currentjobs table, with the time of the job.
+	/// </summary>
+	CassStatement *bindCurrentJob(CassUuid id, Job job);
+
 	/// <summary>
 	/// Retrieves the job from the given row.
 	/// </summary>
@@ -115,18 +249,40 @@ private:
 	void setPreparedStatements();
 
 	/// <summary>
-	/// Moves a job with passed timeout to the failed jobs.
+	/// Creates the statement which adds the given job to the failedjobs table.
 	/// </summary>
-	virtual void updateCurrentJob(CassUuid jobid, Job job, long long currentTime);
+	CassStatement *bindFailedJob(FailedJob job);
+
+	/// <summary>
+	/// Executes the given queries, at most UPLOAD_WINDOW at the same time, and frees them.
+	/// </summary>
+	/// <param name="error"> The message to print when a query fails. </param>
+	/// <returns> The indices of the queries which failed. Sets errno if this is not empty. </returns>
+	std::vector<int> executeConcurrently(std::vector<CassStatement *> queries, std::string error);
 
 	/// <summary>
 	/// The connection with the database.
 	/// <summary>
 	CassSession *connection;
 
-	int numberOfJobs;
+	/// <summary>
+	/// Generates the jobids of new jobs.
+	/// </summary>
+	CassUuidGen *uuidGen;
+
+	// Changed by every thread uploading or handing out jobs.
+	std::atomic<int> numberOfJobs{0};
 	long long timeLastRecount = -1;
 
+	// The first job of every partition of the queue, guarded by bucketMtx. A head with an empty jobid means the
+	// partition is empty. Heads which are not known are retrieved on the next call to getTopJob.
+	int buckets;
+	std::vector<Job> bucketHeads;
+	std::vector<bool> headKnown;
+	std::mutex bucketMtx;
+
+	UrlIndex urlIndex;
+
 	const CassPrepared *preparedGetTopJob;
 	const CassPrepared *preparedDeleteTopJob;
 	const CassPrepared *preparedAddCurrentJob;
@@ -139,5 +295,7 @@ private:
 	const CassPrepared *preparedUploadRetryJob;
 	const CassPrepared *preparedCrawlID;
 	const CassPrepared *preparedUpdateCrawlID;
+	const CassPrepared *preparedQueuedUrls;
+	const CassPrepared *preparedCurrentUrls;
 };
 
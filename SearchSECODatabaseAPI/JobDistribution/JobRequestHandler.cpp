@@ -31,10 +31,15 @@ std::string JobRequestHandler::handleConnectRequest(boost::shared_ptr<TcpConnect
 	return raft->connectNewNode(connection, request);
 }
 
+std::string JobRequestHandler::handleVoteRequest(std::string request)
+{
+	return raft->handleVoteRequest(request);
+}
+
 std::string JobRequestHandler::handleGetIPsRequest(std::string request, std::string client, std::string data)
 {
-	// If you are the leader, get the ips from the RAFT consensus.
-	if (raft->isLeader())
+	// If you are the leader, or a follower which recently heard from the leader, get the ips from the RAFT consensus.
+	if (raft->isLeader() || raft->isUpToDate())
 	{
 		std::vector<std::string> ips = raft->getCurrentIPs();
 		std::string result;
@@ -48,6 +53,36 @@ std::string JobRequestHandler::handleGetIPsRequest(std::string request, std::str
 	return raft->passRequestToLeader(request, client, data);
 }
 
+std::string JobRequestHandler::handleGetJobStateRequest(std::string request, std::string client, std::string data)
+{
+	// If you are the leader, or a follower which recently heard from the leader, use the job state you know of.
+	bool leader = raft->isLeader();
+	if (leader || raft->isUpToDate())
+	{
+		statemtx.lock();
+		int amount = leader ? database->getCachedNumberOfJobs() : replicatedNumberOfJobs;
+		long long currentTime = Utility::getCurrentTimeMilliSeconds();
+		int busy = 0;
+		for (auto const &entry : currentJobs)
+		{
+			if (entry.second.time + entry.second.timeout >= currentTime)
+			{
+				busy++;
+			}
+		}
+		statemtx.unlock();
+
+		// A follower which did not receive the amount of jobs yet can not answer itself.
+		if (amount >= 0)
+		{
+			return HTTPStatusCodes::success(std::to_string(crawlID) + FIELD_DELIMITER_CHAR + std::to_string(amount) +
+											FIELD_DELIMITER_CHAR + std::to_string(busy) + ENTRY_DELIMITER_CHAR);
+		}
+	}
+	// If you are not the leader, pass the request to the leader.
+	return raft->passRequestToLeader(request, client, data);
+}
+
 std::string JobRequestHandler::handleGetJobRequest(std::string request, std::string client, std::string data)
 {
 	// If you are the leader, check if there is a job left.
@@ -67,10 +102,17 @@ std::string JobRequestHandler::handleGetJobRequest(std::string request, std::str
 		{
 			Job job = getTopJobWithRetry();
 			jobmtx.unlock();
+			if (errno == ERANGE)
+			{
+				// The amount of jobs was outdated, the queue is empty.
+				database->setNumberOfJobs(0);
+				return HTTPStatusCodes::success("NoJob");
+			}
 			if (errno != 0)
 			{
 				return HTTPStatusCodes::serverError("Unable to get job from database.");
 			}
+			trackCurrentJob(job);
 			return HTTPStatusCodes::success(
 				std::string("Spider") + FIELD_DELIMITER_CHAR + job.jobid + FIELD_DELIMITER_CHAR + job.url +
 				FIELD_DELIMITER_CHAR + std::to_string(job.time) + FIELD_DELIMITER_CHAR + std::to_string(job.timeout));
@@ -116,7 +158,7 @@ std::string JobRequestHandler::handleUpdateJobRequest(std::string request, std::
 			return HTTPStatusCodes::clientError("Incorrect job time.");
 		}
 
-		long long time = getCurrentJobTimeWithRetry(jobid);
+		long long time = getCurrentJobTime(jobid);
 
 		// If job was not present in currentjobs (or an error was thrown),
 		if (time == -1)
@@ -140,10 +182,25 @@ std::string JobRequestHandler::handleUpdateJobRequest(std::string request, std::
 			return HTTPStatusCodes::clientError("Job not currently expected.");
 		}
 
+		// Renew the job in memory if we know all about it, the new time is written to the database later.
+		long long newTime = renewCurrentJob(jobid);
+		if (newTime != -1)
+		{
+			return HTTPStatusCodes::success(std::to_string(newTime));
+		}
+
 		Job job = getCurrentJobWithRetry(jobid);
+		if (job.jobid == "")
+		{
+			// The job timed out and was moved to the failed jobs in the meantime.
+			untrackCurrentJob(jobid);
+			return HTTPStatusCodes::clientError("Job not currently expected.");
+		}
 
 		// Update timeout timer in currentjobs table.
-		long long newTime = addCurrentJobWithRetry(job);
+		newTime = addCurrentJobWithRetry(job);
+		job.time = newTime;
+		trackCurrentJob(job);
 		return HTTPStatusCodes::success(std::to_string(newTime));
 	}
 	// If you are not the leader, pass the request to the leader.
@@ -175,7 +232,7 @@ std::string JobRequestHandler::handleFinishJobRequest(std::string request, std::
 
 		stats->jobCounter->Add({{"Node", stats->myIP}, {"Client", client}, {"Reason", std::to_string(reasonID)}}).Increment();
 
-		long long time = getCurrentJobTimeWithRetry(jobid);
+		long long time = getCurrentJobTime(jobid);
 
 		// If job was not present in currentjobs (or an error was thrown),
 		if (time == -1)
@@ -199,34 +256,45 @@ std::string JobRequestHandler::handleFinishJobRequest(std::string request, std::
 			return HTTPStatusCodes::clientError("Job not currently expected.");
 		}
 
-		Job job = getCurrentJobWithRetry(jobid);
+		// Make sure a renewed time of the job is not written after the job has been removed.
+		// If we know all about the job, it is removed from the database by the job writer.
+		writemtx.lock();
+		Job job = takeCurrentJob(jobid);
+		if (job.jobid == "")
+		{
+			job = getCurrentJobWithRetry(jobid);
+		}
+		untrackCurrentJob(jobid);
+		writemtx.unlock();
+		if (job.jobid == "")
+		{
+			// The job timed out and was moved to the failed jobs in the meantime.
+			return HTTPStatusCodes::clientError("Job not currently expected.");
+		}
 
 		// Check if the worker failed to complete the job.
+		// The failed job is written to the database, and possibly put back in the queue, by the job writer.
 		if (reasonID != 0)
 		{
-			FailedJob failedJob(job, reasonID, reasonData);
-			addFailedJobWithRetry(failedJob);
-
-			if (errno != 0)
-			{
-				return HTTPStatusCodes::serverError("Job could not be added to failed jobs list.");
-			}
+			std::lock_guard<std::mutex> lock(sinkmtx);
+			pendingFailedJobs.push_back(FailedJob(job, reasonID, reasonData));
 
 			std::set<int> noRetryReasons = NO_RETRY_REASONS;
 			if (job.retries < MAX_JOB_RETRIES && noRetryReasons.find(reasonID) == noRetryReasons.end())
 			{
 				job.retries++;
-				tryUploadJobWithRetry(job, false);
-				if (errno != 0)
-				{
-					return HTTPStatusCodes::serverError("Job could not be re-added to the jobsqueue.");
-				}
+				pendingRetries.push_back(job);
+			}
+			else
+			{
+				database->getUrlIndex()->remove(job.url);
 			}
 
 			return HTTPStatusCodes::success("Job failed succesfully.");
 		}
 		else
 		{
+			database->getUrlIndex()->remove(job.url);
 			stats->addRecentProject(job.url);
 			return HTTPStatusCodes::success("Job finished succesfully.");
 		}
@@ -247,6 +315,14 @@ std::string JobRequestHandler::handleUploadJobRequest(std::string request, std::
 std::string JobRequestHandler::handleUploadJobRequest(std::string request, std::string client,
 													  std::vector<std::string> data)
 {
+	// Until all urls in the queue are known, we can not tell which jobs are already in it.
+	UrlIndex *urlIndex = database->getUrlIndex();
+	if (urlIndex->isLoading())
+	{
+		return HTTPStatusCodes::tooManyRequests("The jobs in the queue are being retrieved, try again later.",
+												URL_LOADING_RETRY_AFTER);
+	}
+
 	std::vector<std::string> urls;
 	std::vector<int> priorities;
 	std::vector<long long> timeouts;
@@ -284,25 +360,37 @@ std::string JobRequestHandler::handleUploadJobRequest(std::string request, std::
 		}
 	}
 
-	// Call to the database to upload jobs.
+	// Skip the jobs of which the url is already in the queue or being worked on.
+	std::vector<Job> jobs;
+	std::vector<int> lines;
 	for (int i = 0; i < urls.size(); i++)
 	{
-		Job job("", timeouts[i], priorities[i], urls[i], 0);
-		tryUploadJobWithRetry(job, true);
-		if (errno != 0)
+		if (urlIndex->insert(urls[i]))
 		{
-			return HTTPStatusCodes::serverError("Unable to add job " + std::to_string(i) + " to database.");
+			jobs.push_back(Job("", timeouts[i], priorities[i], urls[i], 0));
+			lines.push_back(i);
 		}
 	}
+	if (stats != nullptr && jobs.size() < urls.size())
+	{
+		stats->duplicateJobCounter->Add({{"Node", stats->myIP}, {"Client", client}})
+			.Increment(urls.size() - jobs.size());
+	}
+
+	// Call to the database to upload jobs.
+	std::vector<int> failed = uploadJobsWithRetry(jobs);
 
-	if (errno == 0)
+	if (failed.size() == 0)
 	{
 		return HTTPStatusCodes::success("Your job(s) has been succesfully added to the queue.");
 	}
-	else
+	std::string failedJobs = "";
+	for (int i : failed)
 	{
-		return HTTPStatusCodes::clientError("An error has occurred while adding your job(s) to the queue.");
+		urlIndex->remove(jobs[i].url);
+		failedJobs += (failedJobs == "" ? "" : ", ") + std::to_string(lines[i]);
 	}
+	return HTTPStatusCodes::serverError("Unable to add job(s) " + failedJobs + " to database.");
 }
 
 std::string JobRequestHandler::handleCrawlDataRequest(std::string request, std::string client, std::string data)
@@ -328,6 +416,12 @@ std::string JobRequestHandler::handleCrawlDataRequest(std::string request, std::
 		}
 		if (jobID == timeLastCrawl)
 		{
+			// Keep the crawl job, so the crawler can send its results again later.
+			if (database->getUrlIndex()->isLoading())
+			{
+				return HTTPStatusCodes::tooManyRequests("The jobs in the queue are being retrieved, try again later.",
+														URL_LOADING_RETRY_AFTER);
+			}
 			int id = Utility::safeStoi(identifiers[0]);
 			if (errno != 0)
 			{
@@ -366,6 +460,338 @@ void JobRequestHandler::updateCrawlID(int id)
 	}
 }
 
+std::string JobRequestHandler::takeJobChanges(std::string *snapshot)
+{
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::lock_guard<std::mutex> lock(statemtx);
+	std::string changes = "J" + fieldDelimiter + std::to_string(database->getCachedNumberOfJobs()) + fieldDelimiter +
+						  std::to_string(timeLastCrawl) + jobChanges + database->getUrlIndex()->takeChanges();
+	jobChanges = "";
+
+	// Forget the jobs of which the timeout has passed, those are handled by the database.
+	// The followers forget them as well, so they do not keep jobs which will never be finished.
+	long long currentTime = Utility::getCurrentTimeMilliSeconds();
+	for (auto it = currentJobs.begin(); it != currentJobs.end();)
+	{
+		if (it->second.time + it->second.timeout < currentTime)
+		{
+			changes += fieldDelimiter + "D" + fieldDelimiter + it->first;
+			it = currentJobs.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+
+	if (snapshot != nullptr)
+	{
+		*snapshot = "J" + fieldDelimiter + std::to_string(database->getCachedNumberOfJobs()) + fieldDelimiter +
+					std::to_string(timeLastCrawl) + fieldDelimiter + "S";
+		for (auto const &entry : currentJobs)
+		{
+			*snapshot += fieldDelimiter + "H" + fieldDelimiter + entry.first + fieldDelimiter +
+						 std::to_string(entry.second.time) + fieldDelimiter + std::to_string(entry.second.timeout);
+		}
+	}
+	return changes;
+}
+
+void JobRequestHandler::applyJobChanges(std::vector<std::string> changes)
+{
+	std::lock_guard<std::mutex> lock(statemtx);
+	for (int i = 0; i < changes.size();)
+	{
+		if (changes[i] == "J" && i + 2 < changes.size())
+		{
+			replicatedNumberOfJobs = Utility::safeStoi(changes[i + 1]);
+			timeLastCrawl = Utility::safeStoll(changes[i + 2]);
+			i += 3;
+		}
+		else if (changes[i] == "H" && i + 3 < changes.size())
+		{
+			// The rest of the job is not sent along, it is retrieved from the database when needed.
+			Job job;
+			job.jobid = changes[i + 1];
+			job.time = Utility::safeStoll(changes[i + 2]);
+			job.timeout = Utility::safeStoll(changes[i + 3]);
+			currentJobs[job.jobid] = job;
+			i += 4;
+		}
+		else if (changes[i] == "D" && i + 1 < changes.size())
+		{
+			currentJobs.erase(changes[i + 1]);
+			i += 2;
+		}
+		else if (changes[i] == "U" && i + 1 < changes.size())
+		{
+			database->getUrlIndex()->insert(changes[i + 1], false);
+			i += 2;
+		}
+		else if (changes[i] == "F" && i + 1 < changes.size())
+		{
+			database->getUrlIndex()->remove(changes[i + 1], false);
+			i += 2;
+		}
+		else if (changes[i] == "S")
+		{
+			// The full state follows, which replaces whatever we missed before joining.
+			currentJobs.clear();
+			i += 1;
+		}
+		else
+		{
+			std::cout << "Incorrect job changes in heartbeat." << std::endl;
+			return;
+		}
+	}
+}
+
+void JobRequestHandler::loadQueueState(bool urls)
+{
+	database->loadQueueHeads();
+	if (errno != 0)
+	{
+		std::cout << "Unable to retrieve the first jobs of the queue, they are retrieved on the first job request."
+				  << std::endl;
+	}
+	if (urls)
+	{
+		loadUrls();
+	}
+}
+
+void JobRequestHandler::loadUrls()
+{
+	// Add the urls page by page, so they are never all in memory twice.
+	for (bool currentJobs : {false, true})
+	{
+		std::string pagingState = "";
+		do
+		{
+			std::function<std::vector<std::string>()> function = [currentJobs, &pagingState, this]() {
+				return this->database->getQueuedUrls(currentJobs, pagingState);
+			};
+			std::vector<std::string> urls = Utility::queryWithRetry(function);
+			// The paging state is kept, so we continue where we were once the database is back.
+			while (errno != 0)
+			{
+				std::cout << "Unable to retrieve the urls in the job queue, trying again later." << std::endl;
+				usleep(pow(2, MAX_RETRIES) * RETRY_SLEEP);
+				urls = Utility::queryWithRetry(function);
+			}
+			database->getUrlIndex()->addAll(urls);
+		} while (pagingState != "");
+	}
+	database->getUrlIndex()->finishLoading();
+}
+
+void JobRequestHandler::takeOverJobs()
+{
+	std::lock_guard<std::mutex> lock(statemtx);
+	if (replicatedNumberOfJobs >= 0)
+	{
+		database->setNumberOfJobs(replicatedNumberOfJobs);
+	}
+	database->resetQueueState();
+
+	// The urls are kept up to date by the heartbeat, changes left from an earlier term of our own are outdated.
+	database->getUrlIndex()->takeChanges();
+}
+
+void JobRequestHandler::updateCurrentJobs()
+{
+	writeFinishedJobs();
+	writeCurrentJobs();
+
+	// Writes which failed are tried again later, until then the database can not tell whether these jobs timed out.
+	std::set<std::string> liveJobs;
+	statemtx.lock();
+	long long currentTime = Utility::getCurrentTimeMilliSeconds();
+	for (auto const &entry : currentJobs)
+	{
+		if (entry.second.time + entry.second.timeout >= currentTime)
+		{
+			liveJobs.insert(entry.first);
+		}
+	}
+	statemtx.unlock();
+	sinkmtx.lock();
+	liveJobs.insert(pendingDeletes.begin(), pendingDeletes.end());
+	sinkmtx.unlock();
+
+	std::vector<Job> timedOut = database->getTimedOutJobs(liveJobs);
+	if (timedOut.size() == 0)
+	{
+		return;
+	}
+
+	// The jobs are moved by the job writer, which tries again for the writes which fail.
+	std::string reasonData = "Timed out at: " + std::to_string(currentTime);
+	sinkmtx.lock();
+	for (Job job : timedOut)
+	{
+		pendingFailedJobs.push_back(FailedJob(job, 2, reasonData));
+		pendingDeletes.push_back(job.jobid);
+		if (job.retries < MAX_JOB_RETRIES)
+		{
+			job.retries++;
+			pendingRetries.push_back(job);
+		}
+		else
+		{
+			database->getUrlIndex()->remove(job.url);
+		}
+	}
+	sinkmtx.unlock();
+	writeFinishedJobs();
+}
+
+void JobRequestHandler::trackCurrentJob(Job job)
+{
+	std::lock_guard<std::mutex> lock(statemtx);
+	currentJobs[job.jobid] = job;
+	addJobChange(job);
+}
+
+long long JobRequestHandler::renewCurrentJob(std::string jobid)
+{
+	std::lock_guard<std::mutex> lock(statemtx);
+	long long currentTime = Utility::getCurrentTimeMilliSeconds();
+	auto it = currentJobs.find(jobid);
+	if (it == currentJobs.end() || it->second.url == "" || it->second.time + it->second.timeout < currentTime)
+	{
+		return -1;
+	}
+	it->second.time = currentTime;
+	renewedJobs.insert(jobid);
+	addJobChange(it->second);
+	return currentTime;
+}
+
+void JobRequestHandler::addJobChange(Job job)
+{
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	jobChanges += fieldDelimiter + "H" + fieldDelimiter + job.jobid + fieldDelimiter + std::to_string(job.time) +
+				  fieldDelimiter + std::to_string(job.timeout);
+}
+
+void JobRequestHandler::writeCurrentJobs()
+{
+	std::lock_guard<std::mutex> writeLock(writemtx);
+	std::vector<Job> jobs;
+	statemtx.lock();
+	for (std::string jobid : renewedJobs)
+	{
+		auto it = currentJobs.find(jobid);
+		if (it != currentJobs.end())
+		{
+			jobs.push_back(it->second);
+		}
+	}
+	renewedJobs.clear();
+	statemtx.unlock();
+	if (jobs.size() == 0)
+	{
+		return;
+	}
+
+	std::vector<int> failed = database->renewCurrentJobs(jobs);
+
+	// Try again next time for the jobs which could not be written.
+	std::lock_guard<std::mutex> lock(statemtx);
+	for (int i : failed)
+	{
+		if (currentJobs.find(jobs[i].jobid) != currentJobs.end())
+		{
+			renewedJobs.insert(jobs[i].jobid);
+		}
+	}
+}
+
+void JobRequestHandler::writeFinishedJobs()
+{
+	sinkmtx.lock();
+	std::vector<FailedJob> failedJobs;
+	std::vector<std::string> deletes;
+	std::vector<Job> retries;
+	failedJobs.swap(pendingFailedJobs);
+	deletes.swap(pendingDeletes);
+	retries.swap(pendingRetries);
+	sinkmtx.unlock();
+
+	// Each kind of write is done in one batch, several statements at the same time.
+	std::vector<int> failedFailedJobs;
+	std::vector<int> failedDeletes;
+	std::vector<int> failedRetries;
+	if (failedJobs.size() > 0)
+	{
+		failedFailedJobs = database->addFailedJobs(failedJobs);
+	}
+	if (deletes.size() > 0)
+	{
+		failedDeletes = database->deleteCurrentJobs(deletes);
+	}
+	if (retries.size() > 0)
+	{
+		failedRetries = database->uploadJobs(retries, false);
+	}
+
+	// Try again next time for the writes which failed.
+	std::lock_guard<std::mutex> lock(sinkmtx);
+	for (int i : failedFailedJobs)
+	{
+		pendingFailedJobs.push_back(failedJobs[i]);
+	}
+	for (int i : failedDeletes)
+	{
+		pendingDeletes.push_back(deletes[i]);
+	}
+	for (int i : failedRetries)
+	{
+		pendingRetries.push_back(retries[i]);
+	}
+}
+
+Job JobRequestHandler::takeCurrentJob(std::string jobid)
+{
+	std::lock_guard<std::mutex> lock(statemtx);
+	auto it = currentJobs.find(jobid);
+	if (it == currentJobs.end() || it->second.url == "" ||
+		it->second.time + it->second.timeout < Utility::getCurrentTimeMilliSeconds())
+	{
+		return Job();
+	}
+	Job job = it->second;
+	std::lock_guard<std::mutex> sinkLock(sinkmtx);
+	pendingDeletes.push_back(jobid);
+	return job;
+}
+
+void JobRequestHandler::untrackCurrentJob(std::string jobid)
+{
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::lock_guard<std::mutex> lock(statemtx);
+	currentJobs.erase(jobid);
+	renewedJobs.erase(jobid);
+	jobChanges += fieldDelimiter + "D" + fieldDelimiter + jobid;
+}
+
+long long JobRequestHandler::getCurrentJobTime(std::string jobid)
+{
+	statemtx.lock();
+	auto it = currentJobs.find(jobid);
+	if (it != currentJobs.end() && it->second.time + it->second.timeout >= Utility::getCurrentTimeMilliSeconds())
+	{
+		long long time = it->second.time;
+		statemtx.unlock();
+		errno = 0;
+		return time;
+	}
+	statemtx.unlock();
+	return getCurrentJobTimeWithRetry(jobid);
+}
+
 void JobRequestHandler::connectWithRetry(std::string ip, int port)
 {
 	errno = 0;
@@ -403,13 +829,39 @@ Job JobRequestHandler::getTopJobWithRetry()
 	return Utility::queryWithRetry(function);
 }
 
-void JobRequestHandler::tryUploadJobWithRetry(Job job, bool newMethod)
+std::vector<int> JobRequestHandler::uploadJobsWithRetry(std::vector<Job> jobs)
 {
-	std::function<bool()> function = [job, newMethod, this]() {
-		this->database->uploadJob(job, newMethod);
-		return true;
-	};
-	Utility::queryWithRetry(function);
+	// A batch which timed out may still have been written, so a retry has to write the very same jobs.
+	database->prepareNewJobs(jobs);
+	std::vector<int> remaining;
+	for (int i = 0; i < jobs.size(); i++)
+	{
+		remaining.push_back(i);
+	}
+
+	// Only retry the jobs which could not be added.
+	for (int retries = 0; remaining.size() > 0; retries++)
+	{
+		std::vector<Job> retryJobs;
+		for (int i : remaining)
+		{
+			retryJobs.push_back(jobs[i]);
+		}
+		std::vector<int> failed = database->uploadJobs(retryJobs, false);
+		std::vector<int> stillRemaining;
+		for (int i : failed)
+		{
+			stillRemaining.push_back(remaining[i]);
+		}
+		remaining = stillRemaining;
+		if (remaining.size() == 0 || retries >= MAX_RETRIES)
+		{
+			break;
+		}
+		usleep(pow(2, retries) * RETRY_SLEEP);
+	}
+	errno = remaining.size() == 0 ? 0 : ENETUNREACH;
+	return remaining;
 }
 
 long long JobRequestHandler::getCurrentJobTimeWithRetry(std::string jobid)
@@ -429,12 +881,3 @@ long long JobRequestHandler::addCurrentJobWithRetry(Job job)
 	std::function<long long()> function = [job, this]() { return this->database->addCurrentJob(job); };
 	return Utility::queryWithRetry(function);
 }
-
-void JobRequestHandler::addFailedJobWithRetry(FailedJob job)
-{
-	std::function<bool()> function = [job, this]() {
-		this->database->addFailedJob(job);
-		return true;
-	};
-	Utility::queryWithRetry(function);
-}
@@ -8,13 +8,19 @@ Utrecht University within the Software Project course.
 #include "DatabaseConnection.h"
 #include "RAFTConsensus.h"
 
+#include <atomic>
+#include <map>
 #include <mutex>
+#include <set>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
 #define MIN_AMOUNT_JOBS 500
 #define MAX_RETRIES 3
 #define CRAWL_TIMEOUT_SECONDS 150
 #define NO_RETRY_REASONS {10}
+#define LEASE_WRITE_INTERVAL 5000000 // Microseconds between writes of renewed job times to the database.
+#define URL_LOADING_RETRY_AFTER 5000 // Milliseconds to wait with uploading jobs while the queued urls are retrieved.
 
 class TcpConnection;
 
@@ -32,11 +38,27 @@ public:
 	/// </summary>
 	std::string handleConnectRequest(boost::shared_ptr<TcpConnection> connection, std::string request);
 
+	/// <summary>
+	/// Handles request from a node which wants to become the new leader of the network.
+	/// </summary>
+	std::string handleVoteRequest(std::string request);
+
 	/// <summary>
 	/// Handles request for the ip adresses in the network.
+	/// Followers which recently heard from the leader answer this themselves, others pass it on to the leader.
 	/// </summary>
 	std::string handleGetIPsRequest(std::string request, std::string client, std::string data);
 
+	/// <summary>
+	/// Handles request for the state of the job queue.
+	/// Followers which recently heard from the leader answer this themselves, others pass it on to the leader.
+	/// </summary>
+	/// <returns>
+	/// "crawlID?amount?busy", where amount is the amount of jobs in the queue and busy the amount of jobs being
+	/// worked on.
+	/// </returns>
+	std::string handleGetJobStateRequest(std::string request, std::string client, std::string data);
+
 	/// <summary>
 	/// Handles request to upload one or more jobs with their priorities.
 	/// </summary>
@@ -57,6 +79,7 @@ public:
 	/// Consists of url and priority pairs, the url and priority are separated by the FIELD_DELIMITER_CHAR ('?') and
 	/// the pairs by the ENTRY_DELIMITER_CHAR ('\n').
 	/// Data format is "url1?priority1'\n'url2?priority2'\n'..."
+	/// Jobs of which the url is already in the queue or being worked on are skipped.
 	/// </param>
 	/// <returns>
 	/// Response to user whether the job(s) has/have been uploaded succesfully or not.
@@ -77,6 +100,7 @@ public:
 
 	/// <summary>
 	/// Handles the request to update the job time.
+	/// The new time is kept in memory and written to the database within LEASE_WRITE_INTERVAL.
 	/// </summary>
 	/// <returns>
 	/// The new time of the job.
@@ -85,14 +109,13 @@ public:
 
 	/// <summary>
 	/// Handles request to indicate the worker is finished with a job, successfully or not.
+	/// A failed job is added to the failedjobs table, and put back in the queue, by writeFinishedJobs.
 	/// </summary>
 	/// <returns>
 	/// Response is "Job not currently expected." if a newer version of the job was
 	/// given out, or if the job is not known to have been given out. Reponse is
 	/// "Job finished successfully" on success and "Job failed successfully" on 
-	/// a client-side failure, which was correctly handled and uploaded.
-	/// For a client-side failure, when the database fails to upload the current job
-	/// to the failedjobs table, "Job could not be added to failed jobs list." is returned.
+	/// a client-side failure.
 	/// </returns>
 	std::string handleFinishJobRequest(std::string request, std::string client, std::string data);
 
@@ -113,7 +136,7 @@ public:
 	/// which is needed by the crawler to crawl a specific part of GitHub
 	/// and if there is currently a crawler working.
 	/// </summary>	
-	int crawlID;
+	std::atomic<int> crawlID{0};
 	long long timeLastCrawl = -1;
 
 	/// <summary>
@@ -124,6 +147,66 @@ public:
 	/// </param>
 	void updateCrawlID(int id);
 
+	/// <summary>
+	/// Takes the changes to the job queue made since the last call, which the leader sends to the other nodes
+	/// with the heartbeat. Starts with "J?amount?timeLastCrawl", followed by "H?jobid?time?timeout" for every
+	/// job handed out or updated and "D?jobid" for every job finished, failed or timed out. After that follow
+	/// "U?url" for every url added to the queue and "F?url" for every url forgotten.
+	/// </summary>
+	/// <param name="snapshot">
+	/// If given, set to the full job state at the same moment, for nodes which just joined. This is
+	/// "J?amount?timeLastCrawl?S" followed by "H?jobid?time?timeout" for every job handed out.
+	/// </param>
+	std::string takeJobChanges(std::string *snapshot = nullptr);
+
+	/// <summary>
+	/// Applies the changes to the job queue received from the leader, so we can take over without having to
+	/// ask the database first. An "S" means the jobs which follow are all jobs handed out, replacing what we knew.
+	/// </summary>
+	/// <param name="changes"> The changes as made by takeJobChanges, split on the FIELD_DELIMITER_CHAR. </param>
+	void applyJobChanges(std::vector<std::string> changes);
+
+	/// <summary>
+	/// Starts using the job state received from the old leader, after we became the leader ourselves.
+	/// The first jobs of the queue are forgotten, loadQueueState retrieves them again. The urls are kept, as the
+	/// heartbeat kept them up to date.
+	/// </summary>
+	void takeOverJobs();
+
+	/// <summary>
+	/// Retrieves the first job of every partition of the queue. Should be called after becoming the leader.
+	/// </summary>
+	/// <param name="urls"> If true, loadUrls is called as well. </param>
+	void loadQueueState(bool urls = true);
+
+	/// <summary>
+	/// Retrieves the urls of all jobs in the database, so they will not be added to the queue again.
+	/// Called once by every node when it starts, after that the heartbeat keeps them up to date.
+	/// Keeps trying until the database can be reached.
+	/// </summary>
+	void loadUrls();
+
+	/// <summary>
+	/// Writes the times of the jobs renewed since the last call to the database.
+	/// Called by the leader every LEASE_WRITE_INTERVAL.
+	/// </summary>
+	void writeCurrentJobs();
+
+	/// <summary>
+	/// Moves the jobs of which the timeout has passed to the failed jobs. Everything only kept in memory is written
+	/// first, and jobs which are renewed or finished in memory but not in the database yet are skipped, so the
+	/// database never times out a job we still accept updates for. The timed out jobs are written like finished
+	/// jobs, so the writes which fail are tried again. Called by the leader every UPDATE_JOBS_TIMEOUT.
+	/// </summary>
+	void updateCurrentJobs();
+
+	/// <summary>
+	/// Writes the failed jobs received since the last call to the database, together with removing finished jobs
+	/// from the currentjobs table and putting failed jobs back in the queue. Writes which fail are tried again on
+	/// the next call. Called by the leader every HEARTBEAT_TIME.
+	/// </summary>
+	void writeFinishedJobs();
+
 	DatabaseConnection *getDatabaseConnection()
 	{
 		return database;
@@ -136,6 +219,58 @@ private:
 	Statistics *stats;
 	std::mutex jobmtx;
 
+	// The jobs which are currently handed out, by jobid. Kept by the leader and copied to the other nodes through
+	// the heartbeat, which only sends the time and timeout. Guarded by statemtx.
+	std::map<std::string, Job> currentJobs;
+	std::string jobChanges = "";
+	int replicatedNumberOfJobs = -1;
+	std::mutex statemtx;
+
+	// The jobs of which the new time has not been written to the database yet, guarded by statemtx.
+	// Holding writemtx prevents writing while a job is being removed from the database.
+	std::set<std::string> renewedJobs;
+	std::mutex writemtx;
+
+	// The writes for finished and failed jobs which still have to be done, guarded by sinkmtx.
+	std::vector<FailedJob> pendingFailedJobs;
+	std::vector<std::string> pendingDeletes;
+	std::vector<Job> pendingRetries;
+	std::mutex sinkmtx;
+
+	/// <summary>
+	/// Remembers that a job has been handed out at its time, for the other nodes as well.
+	/// </summary>
+	void trackCurrentJob(Job job);
+
+	/// <summary>
+	/// Sets the time of a job which is handed out to now, without going to the database.
+	/// </summary>
+	/// <returns> The new time, or -1 if the job is not known completely or its timeout has passed. </returns>
+	long long renewCurrentJob(std::string jobid);
+
+	/// <summary>
+	/// Adds a job to the changes sent to the other nodes. Should be called while holding statemtx.
+	/// </summary>
+	void addJobChange(Job job);
+
+	/// <summary>
+	/// Takes a job which is finished from memory, and schedules its removal from the currentjobs table.
+	/// </summary>
+	/// <returns> The job, or a job without jobid if it is not known completely or its timeout has passed. </returns>
+	Job takeCurrentJob(std::string jobid);
+
+	/// <summary>
+	/// Forgets a job which has been finished or failed, for the other nodes as well.
+	/// </summary>
+	void untrackCurrentJob(std::string jobid);
+
+	/// <summary>
+	/// Gets the time at which a job was handed out. Only asks the database if we do not know the job,
+	/// or its timeout has passed, in which case the database may have moved it to the failed jobs.
+	/// </summary>
+	/// <returns> The time of the job. Returns -1 if job is unknown or an error occured. </returns>
+	long long getCurrentJobTime(std::string jobid);
+
 	/// <summary>
 	/// Tries to connect with database, if it fails it retries as many times as MAX_RETRIES.
 	/// If it succeeds, it connects with the database and returns.
@@ -151,11 +286,11 @@ private:
 	Job getTopJobWithRetry();
 
 	/// <summary>
-	/// Tries to upload a job to the database, if it fails it retries like above.
-	/// If it succeeds, it returns true.
-	/// If it fails, it returns false.
+	/// Tries to upload multiple jobs to the database at once, retrying the jobs which could not be added
+	/// as many times as MAX_RETRIES.
 	/// </summary>
-	void tryUploadJobWithRetry(Job job, bool newMethod);
+	/// <returns> The indices of the jobs which still could not be added. </returns>
+	std::vector<int> uploadJobsWithRetry(std::vector<Job> jobs);
 
 	/// <summary>
 	/// Attempts to retrieve the time of a match from the currentjobs table with a matching jobid.
@@ -180,9 +315,4 @@ private:
 	/// Adds the given job to the currentjobs table.
 	/// </summary>
 	long long addCurrentJobWithRetry(Job job);
-
-	/// <summary>
-	/// Adds a job with the given parameters to the failedjobs table with retry.
-	/// </summary>
-	void addFailedJobWithRetry(FailedJob job);
 };
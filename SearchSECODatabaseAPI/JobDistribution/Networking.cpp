@@ -7,7 +7,9 @@ Utrecht University within the Software Project course.
 #include "Networking.h"
 #include "Definitions.h"
 
-#include <boost/array.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 
 // We used https://www.boost.org/doc/libs/1_75_0/doc/html/boost_asio/tutorial.html as a base.
@@ -19,7 +21,24 @@ void NetworkHandler::openConnection(std::string server, std::string port)
 	tcp::resolver resolver(ioContext);
 	tcp::resolver::results_type endpoints = resolver.resolve(serverApi, port);
 
-	boost::asio::connect(socket, endpoints);
+	if (timeout <= 0)
+	{
+		boost::asio::connect(socket, endpoints);
+		return;
+	}
+	bool done = false;
+	boost::system::error_code error;
+	boost::asio::async_connect(socket, endpoints,
+							   [&done, &error](const boost::system::error_code &result, const tcp::endpoint &endpoint)
+							   {
+								   error = result;
+								   done = true;
+							   });
+	runWithTimeout(done, error);
+	if (error)
+	{
+		throw boost::system::system_error(error);
+	}
 }
 
 NetworkHandler* NetworkHandler::createHandler()
@@ -34,57 +53,116 @@ void NetworkHandler::sendData(const char* data, int dataLength)
 
 std::string NetworkHandler::receiveData(bool stopOnNewLine)
 {
-	// The buffer we are going to return as a string.
-	std::vector<char> ret = std::vector<char>();
+	// Offset (relative to bufferStart) up to which we already know there is no delimiter.
+	size_t searched = 0;
 	for (;;)
 	{
+		if (stopOnNewLine && bufferEnd - bufferStart > searched)
+		{
+			const char *begin = buffer.data() + bufferStart;
+			const char *found = static_cast<const char *>(
+				memchr(begin + searched, ENTRY_DELIMITER_CHAR, bufferEnd - bufferStart - searched));
+			if (found != nullptr)
+			{
+				std::string result(begin, found);
+				bufferStart += found - begin + 1;
+				return result;
+			}
+			searched = bufferEnd - bufferStart;
+		}
 
-		boost::array<char, 128> buf;
 		boost::system::error_code error;
+		fillBuffer(RECEIVE_CHUNK_SIZE, error);
 
-		// Read the incoming data.
-		size_t len = socket.read_some(boost::asio::buffer(buf), error);
-
-		try
+		if (error == boost::asio::error::eof && !stopOnNewLine)
 		{
-			if (len == 0 && stopOnNewLine) 
-			{
-				throw std::runtime_error("No data received, meaning the other side dropped out.");
-			}
+			// Connection closed cleanly by peer, so everything we have is the result.
+			std::string result(buffer.data() + bufferStart, buffer.data() + bufferEnd);
+			bufferStart = bufferEnd = 0;
+			return result;
 		}
-		catch (std::runtime_error e)
+		else if (error)
 		{
-			std::cout << e.what() << std::endl;
+			// If any error occurs, we just throw.
+			std::cout << "Networking error: " << error.message() << std::endl;
+			throw boost::system::system_error(error);
 		}
-		// Add it to buffer.
-		for (int i = 0; i < len; i++)
+	}
+}
+
+std::string NetworkHandler::receiveExpectedData(size_t size)
+{
+	while (bufferEnd - bufferStart < size)
+	{
+		boost::system::error_code error;
+		fillBuffer(std::max<size_t>(size - (bufferEnd - bufferStart), RECEIVE_CHUNK_SIZE), error);
+		if (error)
 		{
-			ret.push_back(buf[i]);
+			std::cout << "Networking error: " << error.message() << std::endl;
+			throw boost::system::system_error(error);
 		}
+	}
+	std::string result(buffer.data() + bufferStart, size);
+	bufferStart += size;
+	return result;
+}
 
-		if (ret[ret.size() - 1] == ENTRY_DELIMITER_CHAR && stopOnNewLine ||
-			error == boost::asio::error::eof && !stopOnNewLine)
+size_t NetworkHandler::fillBuffer(size_t minimumFree, boost::system::error_code &error)
+{
+	if (bufferStart == bufferEnd)
+	{
+		bufferStart = bufferEnd = 0;
+	}
+	if (buffer.size() - bufferEnd < minimumFree)
+	{
+		// Move the unread data to the front before deciding whether we need to grow.
+		if (bufferStart > 0)
 		{
-			break; // Connection closed cleanly by peer.
+			memmove(buffer.data(), buffer.data() + bufferStart, bufferEnd - bufferStart);
+			bufferEnd -= bufferStart;
+			bufferStart = 0;
 		}
-		else if (error)
+		if (buffer.size() - bufferEnd < minimumFree)
 		{
-			try
-			{
-			// If any error occurs, we just throw.
-			std::cout << "Networking error: " << error.message();
-			throw boost::system::system_error(error);
-			}
-			catch (boost::system::system_error e)
-			{
-				std::cout << e.what() << std::endl;
-			}
+			buffer.resize(std::max(bufferEnd + minimumFree, 2 * buffer.size()));
 		}
+	}
 
+	auto freeSpace = boost::asio::buffer(buffer.data() + bufferEnd, buffer.size() - bufferEnd);
+	size_t len = 0;
+	if (timeout <= 0)
+	{
+		len = socket.read_some(freeSpace, error);
+	}
+	else
+	{
+		bool done = false;
+		socket.async_read_some(freeSpace,
+							   [&done, &error, &len](const boost::system::error_code &result, size_t read)
+							   {
+								   error = result;
+								   len = read;
+								   done = true;
+							   });
+		runWithTimeout(done, error);
 	}
-	if (stopOnNewLine) 
+	bufferEnd += len;
+	return len;
+}
+
+void NetworkHandler::runWithTimeout(bool &done, boost::system::error_code &error)
+{
+	ioContext.restart();
+	ioContext.run_for(std::chrono::microseconds(timeout));
+	if (!done)
 	{
-		return std::string(ret.begin(), ret.end() - 1);
+		// Cancel the operation and wait for its handler, so it does not outlive the variables it refers to.
+		socket.cancel();
+		ioContext.restart();
+		ioContext.run();
+		if (error == boost::asio::error::operation_aborted)
+		{
+			error = boost::asio::error::timed_out;
+		}
 	}
-	return std::string(ret.begin(), ret.end());
 }
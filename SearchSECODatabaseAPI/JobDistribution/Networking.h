@@ -6,6 +6,9 @@ Utrecht University within the Software Project course.
 
 #pragma once
 #include <boost/asio.hpp>
+#include <vector>
+
+#define RECEIVE_CHUNK_SIZE 65536
 
 using boost::asio::ip::tcp;
 
@@ -38,8 +41,27 @@ public:
 	/// If true, will stop listning when encountering a new line.
 	///	If false, will stop when the connection stops.
 	/// </param>
+	/// <remarks>
+	/// Data read past the new line is kept in the buffer and returned by the next call.
+	/// Throws a boost::system::system_error if the connection fails before the data is complete.
+	/// </remarks>
 	std::string receiveData(bool stopOnNewLine = true);
 
+	/// <summary>
+	/// Receives exactly the given amount of bytes from the other side of the connection.
+	/// Used when the size of the data is known beforehand, so no delimiter has to be searched for.
+	/// Throws a boost::system::system_error if the connection fails before all data is received.
+	/// </summary>
+	/// <param name="size"> The amount of bytes to receive. </param>
+	std::string receiveExpectedData(size_t size);
+
+	/// <summary>
+	/// Sets the maximum time opening the connection or a single read may take.
+	/// When it passes, a boost::system::system_error with boost::asio::error::timed_out is thrown.
+	/// </summary>
+	/// <param name="microseconds"> The timeout in microseconds, or 0 to wait indefinitely. </param>
+	void setTimeout(long long microseconds) { timeout = microseconds; };
+
 private:
 	boost::asio::io_context ioContext;
 	/// <summary>
@@ -50,5 +72,25 @@ private:
 	{
 	};
 
+	/// <summary>
+	/// Reads the next chunk of data from the socket and appends it to the buffer.
+	/// Makes sure there is room for at least minimumFree bytes before reading.
+	/// </summary>
+	/// <returns> The amount of bytes read. </returns>
+	size_t fillBuffer(size_t minimumFree, boost::system::error_code &error);
+
+	/// <summary>
+	/// Runs the io context until the pending operation is done or the timeout has passed.
+	/// In the latter case the operation is cancelled and the error is set to timed_out.
+	/// </summary>
+	void runWithTimeout(bool &done, boost::system::error_code &error);
+
 	tcp::socket socket;
+	long long timeout = 0;
+
+	// The data received but not yet returned lies between bufferStart and bufferEnd.
+	// The buffer is reused between calls, so it only grows when a message does not fit.
+	std::vector<char> buffer;
+	size_t bufferStart = 0;
+	size_t bufferEnd = 0;
 };
@@ -10,9 +10,11 @@ Utrecht University within the Software Project course.
 #include "ConnectionHandler.h"
 #include "JobRequestHandler.h"
 #include "Utility.h"
+#include "HTTPStatus.h"
 
 #include <algorithm>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <map>
 #include <thread>
@@ -23,8 +25,21 @@ RAFTConsensus::~RAFTConsensus()
 	if (started) 
 	{
 		stop = true;
+		mtx.lock();
+		for (Connection &follower : *others)
+		{
+			std::lock_guard<std::mutex> lock(follower.state->mtx);
+			follower.state->dropped = true;
+			follower.state->cv.notify_all();
+		}
+		mtx.unlock();
 		// Sleep so we know for sure the thread has stopped before we delete everything.
 		usleep(HEARTBEAT_TIME + HEARTBEAT_TIME / 5);
+		// A follower only notices once its current read times out.
+		while (listening)
+		{
+			usleep(HEARTBEAT_TIME / 10);
+		}
 	}
 }
 
@@ -70,22 +85,63 @@ std::vector<std::pair<std::string, std::string>> RAFTConsensus::getIps(std::stri
 std::vector<std::string> RAFTConsensus::getCurrentIPs()
 {
 	std::vector<std::string> result = std::vector<std::string>();
-	for (auto ip : *others)
+	mtx.lock();
+	if (leader)
 	{
-		result.push_back(connectionToString(ip));
+		for (auto ip : *others)
+		{
+			result.push_back(connectionToString(ip));
+		}
+		mtx.unlock();
+		result.push_back(myIp + FIELD_DELIMITER_CHAR + myPort);
+		return result;
+	}
+
+	// We may not have received the heartbeat which announced ourselves yet.
+	std::pair<std::string, std::string> me(myIp, myPort);
+	if (std::find(nonLeaderNodes.begin(), nonLeaderNodes.end(), me) == nonLeaderNodes.end())
+	{
+		result.push_back(myIp + FIELD_DELIMITER_CHAR + myPort);
 	}
-	result.push_back(myIp + FIELD_DELIMITER_CHAR + myPort);
+	for (auto node : nonLeaderNodes)
+	{
+		result.push_back(node.first + FIELD_DELIMITER_CHAR + node.second);
+	}
+	result.push_back(leaderIp + FIELD_DELIMITER_CHAR + leaderPort);
+	mtx.unlock();
 	return result;
 }
 
+bool RAFTConsensus::isUpToDate()
+{
+	if (leader)
+	{
+		return false;
+	}
+	termMtx.lock();
+	bool electing = leaderLost;
+	termMtx.unlock();
+	return !electing && Utility::getCurrentTimeMilliSeconds() - lastHeartbeat <= MAX_READ_STALENESS / 1000;
+}
+
 void RAFTConsensus::start(RequestHandler* requestHandler, 
 	std::vector<std::pair<std::string, std::string>> ips, 
-	bool assumeLeader) 
+	bool assumeLeader,
+	int port) 
 {
 	started = true;
+	mtx.lock();
+	delete others;
 	others = new std::vector<Connection>();
+	nodeConnectionChange = "";
+	mtx.unlock();
 	leader = true;
+	listenPort = port;
 	this->requestHandler = requestHandler;
+
+	// The urls of the job queue are retrieved once, before any change to them can be received.
+	JobRequestHandler *jrh = requestHandler->getJobRequestHandler();
+	bool loadUrls = jrh->getDatabaseConnection()->getUrlIndex()->startLoading();
 	if (!assumeLeader) 
 	{
 		connectToLeader(ips);
@@ -93,16 +149,24 @@ void RAFTConsensus::start(RequestHandler* requestHandler,
 
 	if (leader) 
 	{
-		new std::thread(&RAFTConsensus::heartbeatSender, this);
-		new std::thread(&DatabaseConnection::updateCurrentJobs, requestHandler->getJobRequestHandler()->getDatabaseConnection());
+		// The threads of the leader stop as soon as we step down, or win a later term after that.
+		long long term = getTerm();
+		new std::thread(&RAFTConsensus::heartbeatSender, this, term);
+		new std::thread(&JobRequestHandler::loadQueueState, jrh, loadUrls);
+		new std::thread(&RAFTConsensus::jobWriter, this, term);
 	}
 	else 
 	{
+		listening = true;
 		new std::thread(&RAFTConsensus::listenForHeartbeat, this);
+		if (loadUrls)
+		{
+			new std::thread(&JobRequestHandler::loadUrls, jrh);
+		}
 	}
 }
 
-void RAFTConsensus::connectToLeader(std::vector<std::pair<std::string, std::string>> ips) 
+bool RAFTConsensus::connectToLeader(std::vector<std::pair<std::string, std::string>> ips) 
 {
 	// Loop through all set IP's where we expect the leader to be.
 	for (auto const& ipPort : ips)
@@ -118,18 +182,26 @@ void RAFTConsensus::connectToLeader(std::vector<std::pair<std::string, std::stri
 				tryConnectingWithIp(ip, port, response);
 			}
 			// If we get through the while loop without throwing an exception, then we have found the leader.
+			mtx.lock();
 			leaderIp = ip;
 			leaderPort = port;
 			leader = false;
-			break;
+			mtx.unlock();
+			lastHeartbeat = Utility::getCurrentTimeMilliSeconds();
+			termMtx.lock();
+			leaderLost = false;
+			termMtx.unlock();
+			return true;
 		}
 		catch (std::exception const& e) 
 		{
 			std::cout << e.what() << std::endl;
 			delete networkhandler;
+			networkhandler = nullptr;
 			continue;
 		}
 	}
+	return false;
 }
 
 void RAFTConsensus::handleInitialData(std::vector<std::string> initialData)
@@ -146,43 +218,41 @@ void RAFTConsensus::handleInitialData(std::vector<std::string> initialData)
 		std::cout << e.what() << std::endl;
 		return;
 	}
+	mtx.lock();
 	myIp = initialData[1];
 	myPort = initialData[2];
+	nonLeaderNodes.clear();
 	// We check i + 1 instead if just i, because we need 2 values every time.
 	for (int i = 3; i + 1 < initialData.size(); i += 2) 
 	{
 		nonLeaderNodes.push_back(std::pair<std::string, std::string>(initialData[i], initialData[i + 1]));
 	}
+	mtx.unlock();
 }
 
 void RAFTConsensus::tryConnectingWithIp(std::string &ip, std::string &port, std::string &response)
 {
 	networkhandler = NetworkHandler::createHandler();
+	// Not hearing from the leader within the election timeout means it is gone.
+	networkhandler->setTimeout(randomTime(ELECTION_TIMEOUT_MIN, ELECTION_TIMEOUT_MAX));
 	// If the IP + port are not open, this will throw an exception sending us to the catch.
 	networkhandler->openConnection(ip, port);
 
 	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
 	networkhandler->sendData("conn" + std::string(1, FIELD_DELIMITER_CHAR) + "node" + myIp + FIELD_DELIMITER_CHAR +
-							 std::to_string(2 + std::to_string(PORT).length() + myIp.length()) + entryDelimiter + myIp +
-							 FIELD_DELIMITER_CHAR + std::to_string(PORT) + entryDelimiter);
+							 std::to_string(2 + std::to_string(listenPort).length() + myIp.length()) + entryDelimiter +
+							 myIp + FIELD_DELIMITER_CHAR + std::to_string(listenPort) + entryDelimiter);
 
 	response = networkhandler->receiveData();
 	std::vector<std::string> receivedLeader = Utility::splitStringOn(response, FIELD_DELIMITER_CHAR);
-	if (receivedLeader[0] != RESPONSE_OK)
+	if (receivedLeader.size() == 0 || receivedLeader[0] != RESPONSE_OK)
 	{
-		try
-		{
-			// If we get something which is not an OK, we will assume that it has send back the true leader.
-			if (receivedLeader.size() != 2)
-			{
-				throw std::runtime_error("Incorrect response from connect request. Size was " +
-										std::to_string(receivedLeader.size()));
-			}
-		}
-		catch (std::exception const& e)
+		// If we get something which is not an OK, we will assume that it has send back the true leader.
+		// Nodes which are looking for a new leader themselves send back something else, which ends up in the catch.
+		if (receivedLeader.size() != 2)
 		{
-			std::cout << e.what() << std::endl;
-			return;
+			throw std::runtime_error("Incorrect response from connect request. Size was " +
+									 std::to_string(receivedLeader.size()));
 		}
 		ip = receivedLeader[0];
 		port = receivedLeader[1];
@@ -205,33 +275,276 @@ void RAFTConsensus::listenForHeartbeat()
 		}
 		catch(std::exception const& ex) 
 		{
-			auto newLeader = nonLeaderNodes[0];
-			nonLeaderNodes.clear();
-			if (newLeader.first == myIp && newLeader.second == myPort)
-			{ 
-				std::cout << "Old leader dropped, we are the next in line, so we are now the leader." << std::endl;
-				// We are next in the list, so we are going to assume leadership.
-				delete others;
-				start(requestHandler, {}, true);
-				return;
+			if (stop || !electNewLeader())
+			{
+				break;
 			}
-			usleep(LEADER_DROPOUT_WAIT_TIME);
-			std::cout << "Attempt connection with new leader." << std::endl;
-			connectToLeader({newLeader});
-			try
+			continue;
+		}
+		lastHeartbeat = Utility::getCurrentTimeMilliSeconds();
+		handleHeartbeat(data);
+		try
+		{
+			// Let the leader know we are still here, and which term we are in.
+			networkhandler->sendData(std::string(RESPONSE_OK) + FIELD_DELIMITER_CHAR + std::to_string(getTerm()) +
+									 ENTRY_DELIMITER_CHAR);
+		}
+		catch (std::exception const &ex)
+		{
+			// The next receive will fail as well, which is where we handle the leader dropping out.
+			std::cout << "Could not acknowledge heartbeat." << std::endl;
+		}
+	}
+	listening = false;
+}
+
+bool RAFTConsensus::electNewLeader()
+{
+	// The failover started when we last heard from the leader.
+	long long lostTime = lastHeartbeat;
+	std::string me = myIp + FIELD_DELIMITER_CHAR + myPort;
+	termMtx.lock();
+	leaderLost = true;
+	termMtx.unlock();
+	delete networkhandler;
+	networkhandler = nullptr;
+	std::cout << "Lost the connection with the leader, looking for a new one." << std::endl;
+
+	while (!stop)
+	{
+		usleep(randomTime(ELECTION_BACKOFF_MIN, ELECTION_BACKOFF_MAX));
+		termMtx.lock();
+		std::string candidate = votedFor;
+		termMtx.unlock();
+
+		bool found = false;
+		if (candidate != "" && candidate != me)
+		{
+			// Give the candidate we voted for the time to win, before standing ourselves.
+			std::vector<std::string> ipPort = Utility::splitStringOn(candidate, FIELD_DELIMITER_CHAR);
+			long long deadline = Utility::getCurrentTimeMilliSeconds() + ELECTION_TIMEOUT_MAX / 1000;
+			while (!stop && !found && ipPort.size() == 2 && Utility::getCurrentTimeMilliSeconds() < deadline)
 			{
-				if(leader) 
+				found = connectToLeader({{ipPort[0], ipPort[1]}});
+				if (!found)
 				{
-					throw std::runtime_error("Could not connect with the new leader.");
+					usleep(ELECTION_BACKOFF_MIN);
 				}
 			}
-			catch(std::exception const& e) 
+		}
+		if (!found && !stop)
+		{
+			std::pair<std::string, std::string> knownLeader;
+			if (requestVotes(knownLeader) && !stop)
+			{
+				std::cout << "Won the election, we are now the leader." << std::endl;
+				termMtx.lock();
+				leaderLost = false;
+				termMtx.unlock();
+				requestHandler->getJobRequestHandler()->takeOverJobs();
+				start(requestHandler, {}, true, listenPort);
+				recordFailover(lostTime);
+				return false;
+			}
+			// The other nodes still hear from a leader, so we were the only one to lose it.
+			if (knownLeader.first != "")
 			{
-				std::cout << e.what() << std::endl;
-				return;
+				found = connectToLeader({knownLeader});
 			}
 		}
-		handleHeartbeat(data);
+		if (found)
+		{
+			recordFailover(lostTime);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool RAFTConsensus::requestVotes(std::pair<std::string, std::string> &knownLeader)
+{
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::pair<std::string, std::string> me(myIp, myPort);
+	termMtx.lock();
+	currentTerm++;
+	long long term = currentTerm;
+	votedFor = myIp + fieldDelimiter + myPort;
+	termMtx.unlock();
+
+	// The old leader is part of the cluster as well. It may only be cut off from us, in which case it has to hear
+	// about the new term, and the majority has to be one of all nodes, or both sides of a split could win.
+	std::vector<std::pair<std::string, std::string>> peers;
+	mtx.lock();
+	std::vector<std::pair<std::string, std::string>> cluster = nonLeaderNodes;
+	cluster.push_back(std::pair<std::string, std::string>(leaderIp, leaderPort));
+	mtx.unlock();
+	for (auto node : cluster)
+	{
+		if (node != me && node.first != "" && std::find(peers.begin(), peers.end(), node) == peers.end())
+		{
+			peers.push_back(node);
+		}
+	}
+	std::cout << "Standing as candidate for term " << term << "." << std::endl;
+
+	// Ask all nodes at the same time, so the election only takes a single round trip.
+	std::vector<std::future<std::string>> responses;
+	for (auto peer : peers)
+	{
+		responses.push_back(std::async(std::launch::async, &RAFTConsensus::requestVote, this, peer, term));
+	}
+
+	int votes = 1;
+	for (auto &response : responses)
+	{
+		std::vector<std::string> splitted = Utility::splitStringOn(response.get(), FIELD_DELIMITER_CHAR);
+		if (splitted.size() < 2)
+		{
+			continue;
+		}
+		if (splitted[0] == RESPONSE_OK)
+		{
+			votes++;
+			continue;
+		}
+		long long otherTerm = Utility::safeStoll(splitted[1]);
+		termMtx.lock();
+		if (errno == 0)
+		{
+			observeTerm(otherTerm);
+		}
+		termMtx.unlock();
+		if (splitted.size() == 4)
+		{
+			knownLeader = std::pair<std::string, std::string>(splitted[2], splitted[3]);
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(termMtx);
+	// If another node started a newer term in the meantime, we lost.
+	return currentTerm == term && votes > (peers.size() + 1) / 2;
+}
+
+std::string RAFTConsensus::requestVote(std::pair<std::string, std::string> node, long long term)
+{
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+	std::string request = std::to_string(term) + fieldDelimiter + myIp + fieldDelimiter + myPort + entryDelimiter;
+	std::unique_ptr<NetworkHandler> networking(NetworkHandler::createHandler());
+	try
+	{
+		networking->setTimeout(VOTE_TIMEOUT);
+		networking->openConnection(node.first, node.second);
+		networking->sendData("vote" + fieldDelimiter + "node" + myIp + fieldDelimiter +
+							 std::to_string(request.length()) + entryDelimiter + request);
+		return networking->receiveData();
+	}
+	catch (std::exception const &ex)
+	{
+		return "";
+	}
+}
+
+std::string RAFTConsensus::handleVoteRequest(std::string request)
+{
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+	std::vector<std::string> splitted =
+		Utility::splitStringOn(request.substr(0, request.find(ENTRY_DELIMITER_CHAR)), FIELD_DELIMITER_CHAR);
+	long long term = splitted.size() == 3 ? Utility::safeStoll(splitted[0]) : -1;
+
+	mtx.lock();
+	std::string knownLeader = leaderIp + fieldDelimiter + leaderPort;
+	mtx.unlock();
+
+	std::lock_guard<std::mutex> lock(termMtx);
+	std::string rejection = RESPONSE_NO + fieldDelimiter + std::to_string(currentTerm);
+	if (splitted.size() != 3 || errno != 0)
+	{
+		return rejection + entryDelimiter;
+	}
+	// A node which still hears from its leader does not help replacing it, but points the candidate to it instead.
+	if (!leader && !leaderLost &&
+		Utility::getCurrentTimeMilliSeconds() - lastHeartbeat < ELECTION_TIMEOUT_MIN / 1000)
+	{
+		return rejection + fieldDelimiter + knownLeader + entryDelimiter;
+	}
+
+	// A candidate in a newer term means the other nodes lost us, so the leader steps down as well.
+	observeTerm(term);
+	if (leader)
+	{
+		return rejection + fieldDelimiter + myIp + fieldDelimiter + myPort + entryDelimiter;
+	}
+	std::string candidate = splitted[1] + fieldDelimiter + splitted[2];
+	if (term == currentTerm && (votedFor == "" || votedFor == candidate))
+	{
+		votedFor = candidate;
+		return RESPONSE_OK + fieldDelimiter + std::to_string(currentTerm) + entryDelimiter;
+	}
+	return RESPONSE_NO + fieldDelimiter + std::to_string(currentTerm) + entryDelimiter;
+}
+
+void RAFTConsensus::observeTerm(long long term)
+{
+	if (term <= currentTerm)
+	{
+		return;
+	}
+	currentTerm = term;
+	votedFor = "";
+	if (leader)
+	{
+		std::cout << "Found the newer term " << term << ", stepping down as leader." << std::endl;
+		leader = false;
+		leaderLost = true;
+		listening = true;
+		new std::thread(&RAFTConsensus::rejoinNetwork, this);
+	}
+}
+
+void RAFTConsensus::rejoinNetwork()
+{
+	mtx.lock();
+	// Our followers take part in the election of the new leader, so remember them before letting them go.
+	nonLeaderNodes.clear();
+	for (Connection &follower : std::vector<Connection>(*others))
+	{
+		nonLeaderNodes.push_back(std::pair<std::string, std::string>(follower.ip, follower.port));
+		dropConnection(follower);
+	}
+	leaderIp = "";
+	leaderPort = "";
+	mtx.unlock();
+
+	lastHeartbeat = Utility::getCurrentTimeMilliSeconds();
+	if (!stop && electNewLeader())
+	{
+		listenForHeartbeat();
+		return;
+	}
+	listening = false;
+}
+
+long long RAFTConsensus::getTerm()
+{
+	std::lock_guard<std::mutex> lock(termMtx);
+	return currentTerm;
+}
+
+long long RAFTConsensus::randomTime(long long min, long long max)
+{
+	std::lock_guard<std::mutex> lock(termMtx);
+	return std::uniform_int_distribution<long long>(min, max)(randomGenerator);
+}
+
+void RAFTConsensus::recordFailover(long long lostTime)
+{
+	long long duration = Utility::getCurrentTimeMilliSeconds() - lostTime;
+	std::cout << "Found a new leader in " << duration << " ms." << std::endl;
+	if (stats != nullptr)
+	{
+		stats->failoverDuration->Add({{"Node", stats->myIP}}).Set(duration);
 	}
 }
 
@@ -244,6 +557,20 @@ std::string RAFTConsensus::connectNewNode(boost::shared_ptr<TcpConnection> conne
 		request = request.substr(0, request.length() - 1);
 
 		std::vector<std::string> splitted = Utility::splitStringOn(request, FIELD_DELIMITER_CHAR);
+		if (splitted.size() < 2)
+		{
+			return HTTPStatusCodes::clientError("Incorrect connect request.");
+		}
+		if (splitted[0] == "")
+		{
+			// Nodes which do not know their own ip are known by the address they connect from.
+			boost::system::error_code error;
+			tcp::endpoint remote = connection->socket().remote_endpoint(error);
+			if (!error)
+			{
+				splitted[0] = remote.address().to_string();
+			}
+		}
 
 		mtx.lock();
 		std::string initialData = "";
@@ -260,12 +587,22 @@ std::string RAFTConsensus::connectNewNode(boost::shared_ptr<TcpConnection> conne
 		nodeConnectionChange += "A" + fieldDelimiter + connectionToString(conn);
 
 		mtx.unlock();
-		new std::thread(&RAFTConsensus::listenForRequests, this, connection);
+		new std::thread(&RAFTConsensus::heartbeatFollower, conn);
+		new std::thread(&RAFTConsensus::listenForAcks, this, conn);
 
 		std::string connectingIp = fieldDelimiter + connectionToString(conn);
 
 		return std::string(RESPONSE_OK) + connectingIp + initialData + entryDelimiter;
 	}
+	termMtx.lock();
+	bool electing = leaderLost;
+	termMtx.unlock();
+	if (electing)
+	{
+		// We do not know the leader either, the other node will have to try again later.
+		return std::string(RESPONSE_NO) + entryDelimiter;
+	}
+	std::lock_guard<std::mutex> lock(mtx);
 	return leaderIp + fieldDelimiter + leaderPort + entryDelimiter;
 }
 
@@ -273,11 +610,27 @@ void RAFTConsensus::handleHeartbeat(std::string heartbeat)
 {
 	std::vector<std::string> hbSplitted = Utility::splitStringOn(heartbeat, FIELD_DELIMITER_CHAR);
 
-	if (hbSplitted.size() == 0) 
+	if (hbSplitted.size() < 2) 
 	{
 		return;
 	}
-	int crawlid = Utility::safeStoi(hbSplitted[0]);
+	long long term = Utility::safeStoll(hbSplitted[0]);
+	if (errno != 0)
+	{
+		std::cout << "Error parsing term from heartbeat.\n";
+		return;
+	}
+	termMtx.lock();
+	if (term < currentTerm)
+	{
+		termMtx.unlock();
+		std::cout << "Ignoring heartbeat of an outdated leader.\n";
+		return;
+	}
+	observeTerm(term);
+	termMtx.unlock();
+
+	int crawlid = Utility::safeStoi(hbSplitted[1]);
 	if (errno == 0) 
 	{
 		requestHandler->getJobRequestHandler()->crawlID = crawlid;
@@ -286,10 +639,18 @@ void RAFTConsensus::handleHeartbeat(std::string heartbeat)
 	{
 		std::cout << "Error parsing crawlid from heartbeat.\n";
 	}
-	for (int i = 1; i < hbSplitted.size(); i += 3) 
+	for (int i = 2; i < hbSplitted.size(); i += 3) 
 	{
+		if ((hbSplitted[i] != "A" && hbSplitted[i] != "R") || i + 2 >= hbSplitted.size())
+		{
+			// The rest of the heartbeat describes the changes to the job queue.
+			requestHandler->getJobRequestHandler()->applyJobChanges(
+				std::vector<std::string>(hbSplitted.begin() + i, hbSplitted.end()));
+			break;
+		}
 		std::pair<std::string, std::string> pairReceived = 
 			std::pair<std::string, std::string>(hbSplitted[i+1], hbSplitted[i+2]);
+		std::lock_guard<std::mutex> lock(mtx);
 		if (hbSplitted[i] == "A") 
 		{
 			bool found = false;
@@ -312,10 +673,6 @@ void RAFTConsensus::handleHeartbeat(std::string heartbeat)
 				pairReceived), 
 				nonLeaderNodes.end());
 		}
-		else 
-		{
-			std::cout << "Incorrect heartbeat" << std::endl;
-		}
 	}
 }
 
@@ -323,14 +680,22 @@ std::string RAFTConsensus::passRequestToLeader(std::string requestType, std::str
 {
 	std::string received = "";
 
+	// The leader may change while we are connecting, so we use the one known at this moment.
+	mtx.lock();
+	std::string ip = leaderIp;
+	std::string port = leaderPort;
+	mtx.unlock();
+
 	try
 	{
 		std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
 		NetworkHandler *networking = NetworkHandler::createHandler();
 
-		networking->openConnection(leaderIp, leaderPort);
+		networking->openConnection(ip, port);
+		// The request was already charged to the client here, so the leader should not charge it again.
 		networking->sendData(requestType + FIELD_DELIMITER_CHAR + client + FIELD_DELIMITER_CHAR +
-							 std::to_string(request.length()) + entryDelimiter + request);
+							 std::to_string(request.length()) + FIELD_DELIMITER_CHAR + FORWARDED + entryDelimiter +
+							 request);
 
 		received = networking->receiveData(false);
 		delete networking;
@@ -342,83 +707,204 @@ std::string RAFTConsensus::passRequestToLeader(std::string requestType, std::str
 	return received;
 }
 
-void RAFTConsensus::heartbeatSender()
+bool RAFTConsensus::leading(long long term)
 {
-	while (!stop) 
+	return !stop && leader && getTerm() == term;
+}
+
+void RAFTConsensus::jobWriter(long long term)
+{
+	long long lastWrite = Utility::getCurrentTimeMilliSeconds();
+	long long lastSweep = lastWrite;
+	while (!stop)
+	{
+		// Sleep in short steps, so we notice quickly when we have to stop.
+		usleep(HEARTBEAT_TIME);
+		if (stop)
+		{
+			break;
+		}
+		bool stillLeading = leading(term);
+		requestHandler->getJobRequestHandler()->writeFinishedJobs();
+		if (!stillLeading || Utility::getCurrentTimeMilliSeconds() - lastWrite >= LEASE_WRITE_INTERVAL / 1000)
+		{
+			requestHandler->getJobRequestHandler()->writeCurrentJobs();
+			lastWrite = Utility::getCurrentTimeMilliSeconds();
+		}
+		if (!stillLeading)
+		{
+			// We wrote what was left of our term, the new leader continues from the database.
+			break;
+		}
+
+		// The timeouts are checked by this thread as well, so no write is in progress while they are.
+		if (Utility::getCurrentTimeMilliSeconds() - lastSweep >= UPDATE_JOBS_TIMEOUT / 1000)
+		{
+			requestHandler->getJobRequestHandler()->updateCurrentJobs();
+			lastSweep = Utility::getCurrentTimeMilliSeconds();
+		}
+	}
+}
+
+void RAFTConsensus::heartbeatSender(long long term)
+{
+	while (leading(term)) 
 	{
 		usleep(HEARTBEAT_TIME);
+		if (!leading(term))
+		{
+			break;
+		}
+		// Only hold the lock while copying the nodes, so a slow node can not stop new nodes from connecting.
 		mtx.lock();
-		std::string data = getHeartbeat();
+		std::vector<Connection> followers = *others;
+		bool newFollowers = std::any_of(followers.begin(), followers.end(),
+										[](const Connection &c) { return !c.state->synced; });
+		std::string snapshot = "";
+		std::string data = getHeartbeat(newFollowers ? &snapshot : nullptr);
 		mtx.unlock();
-		boost::system::error_code error;
-		// Going from back to front, so we don't have to worry as much about connections
-		// being added or removed while we are in this loop.
-		mtx.lock();
-		for (int i = others->size() - 1; i >= 0; i--) 
+
+		long long now = Utility::getCurrentTimeMilliSeconds();
+		for (Connection &follower : followers)
 		{
-			try 
+			std::unique_lock<std::mutex> lock(follower.state->mtx);
+			bool missedAcks = now - follower.state->lastAck > HEARTBEAT_ACK_TIMEOUT / 1000;
+			bool sendExpired = follower.state->sendStarted != -1 &&
+							   now - follower.state->sendStarted > HEARTBEAT_SEND_DEADLINE / 1000;
+			if (follower.state->failed || missedAcks || sendExpired)
 			{
-				boost::shared_ptr<TcpConnection> connection = others->at(i).connection;
-				
-				connection->sendData(data, error);
-				if (error)
-				{
-					std::cout << "Error "<< error << " sending data: Connection dropped." << std::endl;
-					dropConnection(i);
-				}
-			}
-			catch(std::exception const& ex)
-			{
-				// If an error occured, we assume the connection has dropped.
-				std::cout << "Connection dropped." << std::endl;
-				dropConnection(i);
-				
+				lock.unlock();
+				std::cout << "Connection with " << connectionToString(follower) << " dropped." << std::endl;
+				mtx.lock();
+				dropConnection(follower);
+				mtx.unlock();
+				continue;
 			}
+			// A follower which just joined missed the earlier changes, so it gets the full job state once.
+			follower.state->pending += follower.state->synced ? data : snapshot;
+			follower.state->synced = true;
+			follower.state->cv.notify_all();
 		}
-		mtx.unlock();
 	}
 }
 
-void RAFTConsensus::dropConnection(int i) 
+void RAFTConsensus::heartbeatFollower(Connection follower)
+{
+	std::shared_ptr<FollowerState> state = follower.state;
+	std::unique_lock<std::mutex> lock(state->mtx);
+	while (!state->dropped)
+	{
+		if (state->pending == "")
+		{
+			state->cv.wait(lock);
+			continue;
+		}
+		std::string data = "";
+		data.swap(state->pending);
+		state->sendStarted = Utility::getCurrentTimeMilliSeconds();
+		lock.unlock();
+
+		boost::system::error_code error;
+		try
+		{
+			follower.connection->sendData(data, error);
+		}
+		catch (std::exception const &ex)
+		{
+			error = boost::asio::error::broken_pipe;
+		}
+
+		lock.lock();
+		state->sendStarted = -1;
+		if (error)
+		{
+			// The heartbeat sender will drop this node the next time it comes by.
+			std::cout << "Error " << error << " sending heartbeat to " << connectionToString(follower) << std::endl;
+			state->failed = true;
+			return;
+		}
+	}
+}
+
+void RAFTConsensus::dropConnection(Connection connection) 
 {
 	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
 
-	Connection c = others->at(i);
+	auto it = std::find_if(others->begin(), others->end(),
+						   [&connection](const Connection &c) { return c.state == connection.state; });
+	if (it == others->end())
+	{
+		return;
+	}
 	if(nodeConnectionChange != "") 
 	{
 		nodeConnectionChange += fieldDelimiter;
 	}
-	nodeConnectionChange += "R" + fieldDelimiter + connectionToString(c);
+	nodeConnectionChange += "R" + fieldDelimiter + connectionToString(connection);
 
-	(*others)[i] = (*others)[others->size()-1];
+	*it = others->back();
 	others->pop_back();
+
+	// Stop the threads belonging to this node.
+	{
+		std::lock_guard<std::mutex> lock(connection.state->mtx);
+		connection.state->dropped = true;
+		connection.state->cv.notify_all();
+	}
+	boost::system::error_code error;
+	connection.connection->socket().shutdown(tcp::socket::shutdown_both, error);
 }
 
-std::string RAFTConsensus::getHeartbeat()
+std::string RAFTConsensus::getHeartbeat(std::string *snapshot)
 {
 	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
 	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
 	JobRequestHandler* jrh = requestHandler->getJobRequestHandler();
 
-	std::string hb = std::to_string(jrh->crawlID) + 
-		fieldDelimiter + nodeConnectionChange + entryDelimiter;
+	std::string hb = std::to_string(getTerm()) + fieldDelimiter + std::to_string(jrh->crawlID) + fieldDelimiter;
+	if (nodeConnectionChange != "")
+	{
+		hb += nodeConnectionChange + fieldDelimiter;
+	}
+	if (snapshot != nullptr)
+	{
+		std::string jobs = "";
+		std::string changes = jrh->takeJobChanges(&jobs);
+		*snapshot = hb + jobs + entryDelimiter;
+		hb += changes + entryDelimiter;
+	}
+	else
+	{
+		hb += jrh->takeJobChanges() + entryDelimiter;
+	}
 	nodeConnectionChange = "";
 	return hb;
 }
 
-void RAFTConsensus::listenForRequests(boost::shared_ptr<TcpConnection> connection) 
+void RAFTConsensus::listenForAcks(Connection follower) 
 {
-	try 
+	boost::system::error_code error;
+	while (!error)
 	{
-		while(!stop) 
+		std::string ack = follower.connection->receiveLine(error);
+		if (error)
+		{
+			break;
+		}
+		follower.state->lastAck = Utility::getCurrentTimeMilliSeconds();
+
+		// A follower in a newer term means a new leader was elected without us.
+		std::vector<std::string> splitted = Utility::splitStringOn(ack, FIELD_DELIMITER_CHAR);
+		if (splitted.size() >= 2)
 		{
-			connection->start(requestHandler, connection, stats);
+			long long term = Utility::safeStoll(splitted[1]);
+			std::lock_guard<std::mutex> lock(termMtx);
+			if (errno == 0)
+			{
+				observeTerm(term);
+			}
 		}
 	}
-	catch (std::exception const& e) 
-	{
-		std::cout << e.what();
-	}
 }
 
 std::string RAFTConsensus::connectionToString(Connection connection)
@@ -5,24 +5,73 @@ Utrecht University within the Software Project course.
 */
 
 #pragma once
+#include "Definitions.h"
 #include "Networking.h"
 #include "Statistics.h"
+#include "Utility.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <vector>
 #include <boost/shared_ptr.hpp>
 #include <mutex>
+#include <random>
 #include <prometheus/counter.h>
 
 #define RESPONSE_OK "ok"
-#define HEARTBEAT_TIME 1000000
-#define LEADER_DROPOUT_WAIT_TIME 1000000
+#define RESPONSE_NO "no"
+#define HEARTBEAT_TIME 200000
+#define HEARTBEAT_ACK_TIMEOUT (10 * HEARTBEAT_TIME)		// Drop a follower if it did not ack for this long.
+#define HEARTBEAT_SEND_DEADLINE (2 * HEARTBEAT_TIME)	// Drop a follower if a single send takes this long.
+
+// Times in microseconds. A follower which does not hear from the leader for a random time between the minimum and
+// maximum election timeout considers it gone. It then waits a random backoff before standing as a candidate,
+// so nodes rarely stand at the same time and split the votes.
+#define ELECTION_TIMEOUT_MIN 600000
+#define ELECTION_TIMEOUT_MAX 1200000
+#define ELECTION_BACKOFF_MIN 150000
+#define ELECTION_BACKOFF_MAX 300000
+#define VOTE_TIMEOUT 200000
+
+// A follower only answers read-only requests itself if it heard from the leader this recently, in microseconds.
+#define MAX_READ_STALENESS (2 * HEARTBEAT_TIME)
 
 
 class TcpConnection;
 class RequestHandler;
 
+/// <summary>
+/// Keeps track of the heartbeats that still have to be send to a follower and of when it last acknowledged one.
+/// </summary>
+struct FollowerState
+{
+  public:
+	std::mutex mtx;
+	std::condition_variable cv;
+
+	// Heartbeats which have not been written to the follower yet.
+	std::string pending = "";
+
+	// Time in milliseconds at which the current send started, or -1 if no send is in progress.
+	long long sendStarted = -1;
+
+	std::atomic<long long> lastAck;
+	bool failed = false;
+	bool dropped = false;
+
+	// Set once the follower has been sent the full job state, after which it only gets the changes.
+	// Only used by the heartbeat sender.
+	bool synced = false;
+
+	FollowerState() : lastAck(Utility::getCurrentTimeMilliSeconds())
+	{
+	}
+};
+
 /// <summary>
 /// Represents the data of a connection with another node.
+/// The state is shared between copies, so the leader can work on a copy of the list of nodes.
 /// </summary>
 struct Connection
 {
@@ -30,9 +79,10 @@ struct Connection
 	boost::shared_ptr<TcpConnection> connection;
 	std::string ip;
 	std::string port;
+	std::shared_ptr<FollowerState> state;
 
 	Connection(boost::shared_ptr<TcpConnection> conn, std::string ip, std::string port)
-		: connection(conn), ip(ip), port(port)
+		: connection(conn), ip(ip), port(port), state(std::make_shared<FollowerState>())
 	{
 	}
 };
@@ -53,15 +103,23 @@ public:
 	/// <param name="assumeLeader">
 	/// If set to true, will skip the connect phase and assume that this node is the leader.
 	/// </param>
+	/// <param name="port"> The port on which this node listens for requests. </param>
 	void start(RequestHandler* requestHandler, 
 		std::vector<std::pair<std::string, std::string>> ips, 
-		bool assumeLeader = false);
+		bool assumeLeader = false,
+		int port = PORT);
 
 	/// <summary>
 	/// Returns true if this node is the leader in the network.
 	/// </summary>
 	virtual bool isLeader() { return leader; };
 
+	/// <summary>
+	/// Returns true if this node is a follower which heard from the leader within MAX_READ_STALENESS,
+	/// so it can answer read-only requests from its own view of the network instead of asking the leader.
+	/// </summary>
+	virtual bool isUpToDate();
+
 	/// <summary>
 	/// Will pass the given request on to the leader of the network.
 	/// </summary>
@@ -79,6 +137,21 @@ public:
 	/// </returns>
 	virtual std::string connectNewNode(boost::shared_ptr<TcpConnection> connection, std::string request);
 
+	/// <summary>
+	/// Handles a vote request of a node which stands as candidate to become the new leader.
+	/// The vote is granted if the term of the candidate is not behind ours, we did not vote for another
+	/// candidate in this term and we lost contact with the leader ourselves.
+	/// A leader steps down if the term of the candidate is newer than its own.
+	/// </summary>
+	/// <param name="request"> The term, ip and port of the candidate. </param>
+	/// <returns> Ok or no, followed by our current term. </returns>
+	virtual std::string handleVoteRequest(std::string request);
+
+	/// <summary>
+	/// Returns the term of the leader this node knows of.
+	/// </summary>
+	long long getTerm();
+
 	/// <summary>
 	/// Reads the given file and gets the ips out of it.
 	/// </summary>
@@ -87,6 +160,7 @@ public:
 
 	/// <summary>
 	/// Returns the ips currently know to this api.
+	/// A follower returns the nodes it learned of through the heartbeats, followed by the leader.
 	/// </summary>
 	/// <returns> List of ips with port. </returns>
 	virtual std::vector<std::string> getCurrentIPs();
@@ -106,7 +180,56 @@ private:
 	/// If no connection can be astablished, we will assume the role of leader.
 	/// </summary>
 	/// <param name="ips"> List of node to try and connect with. </param>
-	void connectToLeader(std::vector<std::pair<std::string, std::string>> ips);
+	/// <returns> True if a connection with the leader has been set up. </returns>
+	bool connectToLeader(std::vector<std::pair<std::string, std::string>> ips);
+
+	/// <summary>
+	/// Finds a new leader after the connection with the old one has been lost.
+	/// Either connects to the candidate we voted for, or stands as candidate ourselves,
+	/// until a leader has been found.
+	/// </summary>
+	/// <returns> True if we are connected to a new leader, false if we became the leader or are stopping. </returns>
+	bool electNewLeader();
+
+	/// <summary>
+	/// Starts a new term and asks all other nodes, including the old leader, for their vote.
+	/// </summary>
+	/// <param name="knownLeader"> Set to the leader some node still hears from, if any. </param>
+	/// <returns> True if the majority of all nodes in the network voted for us. </returns>
+	bool requestVotes(std::pair<std::string, std::string> &knownLeader);
+
+	/// <summary>
+	/// Asks a single node for its vote in the given term.
+	/// </summary>
+	/// <returns> The response of the node, or an empty string if it could not be reached. </returns>
+	std::string requestVote(std::pair<std::string, std::string> node, long long term);
+
+	/// <summary>
+	/// Moves to the given term if it is newer than ours, forgetting our vote.
+	/// A leader which sees a newer term steps down and starts looking for the new leader.
+	/// Should be called while holding termMtx.
+	/// </summary>
+	void observeTerm(long long term);
+
+	/// <summary>
+	/// Lets go of the followers after stepping down as leader, and finds the new leader of the network.
+	/// </summary>
+	void rejoinNetwork();
+
+	/// <summary>
+	/// Returns true if we are still the leader in the given term.
+	/// </summary>
+	bool leading(long long term);
+
+	/// <summary>
+	/// Returns a random amount of microseconds between min and max.
+	/// </summary>
+	long long randomTime(long long min, long long max);
+
+	/// <summary>
+	/// Keeps track of how long it took to find a new leader since the last heartbeat of the old one.
+	/// </summary>
+	void recordFailover(long long lostTime);
 
 
 	/// <summary>
@@ -139,47 +262,79 @@ private:
 
 
 	/// <summary>
-	/// Sends a heartbeat to all nodes in the network every once in a while.
+	/// Hands a heartbeat to every node in the network every once in a while.
+	/// The actual sending is done per node by heartbeatFollower, so a slow node does not delay the others.
+	/// Nodes which stopped acknowledging heartbeats or are stuck in a send are dropped.
+	/// Stops once we are no longer the leader in the given term.
+	/// </summary>
+	void heartbeatSender(long long term);
+
+	/// <summary>
+	/// Writes the pending heartbeats of a single follower until the follower is dropped.
 	/// </summary>
-	void heartbeatSender();
+	static void heartbeatFollower(Connection follower);
 
 	/// <summary>
 	/// Gets the data that is going to be send in the heartbeat by the heartbeatSender method.
 	/// </summary>
-	std::string getHeartbeat();
+	/// <param name="snapshot">
+	/// If given, set to the same heartbeat with the full job state instead of the changes, for new followers.
+	/// </param>
+	std::string getHeartbeat(std::string *snapshot = nullptr);
 
 	/// <summary>
-	/// Listens for incoming data on the given connection. Any request received will be handled locally.
-	/// The result of the request will be send back through the connection. This will be done as long
-	/// as the connection stays open.
+	/// Listens for heartbeat acknowledgements on the given connection and keeps track of the last one received.
+	/// An acknowledgement carries the term of the follower, so we step down if it is newer than ours.
+	/// This will be done as long as the connection stays open.
 	/// </summary>
-	void listenForRequests(boost::shared_ptr<TcpConnection> connection);
+	void listenForAcks(Connection follower);
 
 	/// <summary>
-	/// Removes a connection from the list of nodes connected to the leader.
+	/// Lets the job request handler write the finished and failed jobs to the database every HEARTBEAT_TIME,
+	/// the renewed job times every LEASE_WRITE_INTERVAL and check the current jobs for a timeout every
+	/// UPDATE_JOBS_TIMEOUT, as long as we are the leader in the given term.
+	/// After stepping down everything still in memory is written once more.
+	/// </summary>
+	void jobWriter(long long term);
+
+	/// <summary>
+	/// Removes a connection from the list of nodes connected to the leader and stops sending heartbeats to it.
 	/// This method will keep track that the connection has been dropped, so that it can be send in the heartbeat.
+	/// Should be called while holding mtx.
 	/// </summary>
-	/// <param name="i"> The index of the node to be dropped. </param>
-	void dropConnection(int i);
+	/// <param name="connection"> The node to be dropped. </param>
+	void dropConnection(Connection connection);
 
 	/// <summary>
 	/// Converts a connection to a string that can be used to connect to the other side of the connection.
 	/// </summary>
-	std::string connectionToString(Connection connection);
+	static std::string connectionToString(Connection connection);
 
-	bool leader;
-	bool stop = false;
+	// Read by the threads of the leader and written when stepping down, so they can not be plain booleans.
+	std::atomic<bool> leader{false};
+	std::atomic<bool> stop{false};
 	bool started = false;
+	std::atomic<bool> listening{false};
 	std::mutex mtx;
 	Statistics *stats;
+	int listenPort = PORT;
+
+	// Election variables, guarded by termMtx.
+	std::mutex termMtx;
+	long long currentTerm = 0;
+	std::string votedFor = "";
+	bool leaderLost = false;
+	std::atomic<long long> lastHeartbeat{0};
+	std::mt19937 randomGenerator = std::mt19937(std::random_device()());
 
 	// Non-leader variables.
-	NetworkHandler* networkhandler;
+	NetworkHandler* networkhandler = nullptr;
 	std::string leaderIp, leaderPort, myIp, myPort;
+	// Only changed by the thread listening for heartbeats or when stepping down, under mtx.
 	std::vector<std::pair<std::string, std::string>> nonLeaderNodes;
 
 	// Leader variables.
-	std::vector<Connection>* others;
+	std::vector<Connection>* others = nullptr;
 	RequestHandler* requestHandler;
 	std::string nodeConnectionChange = "";
 };
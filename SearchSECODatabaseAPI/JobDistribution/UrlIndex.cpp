@@ -0,0 +1,190 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "UrlIndex.h"
+#include "Definitions.h"
+
+#include <functional>
+
+bool UrlIndex::insert(std::string url, bool replicate)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	uint64_t print = fingerprint(url);
+	removedWhileLoading.erase(print);
+	if (!add(print))
+	{
+		return false;
+	}
+	if (replicate)
+	{
+		changes += std::string(1, FIELD_DELIMITER_CHAR) + "U" + FIELD_DELIMITER_CHAR + url;
+	}
+	return true;
+}
+
+void UrlIndex::remove(std::string url, bool replicate)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	uint64_t print = fingerprint(url);
+	if (loadState == eLoading)
+	{
+		removedWhileLoading.insert(print);
+	}
+	size_t slot = findSlot(print);
+	if (slots[slot] == print)
+	{
+		// The slot can not be emptied, as other fingerprints may have been put after it.
+		slots[slot] = removedSlot;
+		count--;
+	}
+	if (replicate)
+	{
+		changes += std::string(1, FIELD_DELIMITER_CHAR) + "F" + FIELD_DELIMITER_CHAR + url;
+	}
+}
+
+bool UrlIndex::contains(std::string url)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	uint64_t print = fingerprint(url);
+	return slots[findSlot(print)] == print;
+}
+
+void UrlIndex::addAll(std::vector<std::string> newUrls)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	for (std::string const &url : newUrls)
+	{
+		uint64_t print = fingerprint(url);
+		if (removedWhileLoading.find(print) == removedWhileLoading.end())
+		{
+			add(print);
+		}
+	}
+}
+
+void UrlIndex::clear()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	slots = std::vector<uint64_t>(URL_INDEX_MIN_SLOTS, emptySlot);
+	count = 0;
+	used = 0;
+}
+
+int UrlIndex::size()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return count;
+}
+
+bool UrlIndex::startLoading()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	if (loadState != eUnloaded)
+	{
+		return false;
+	}
+	loadState = eLoading;
+	return true;
+}
+
+void UrlIndex::finishLoading()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	loadState = eLoaded;
+	removedWhileLoading.clear();
+}
+
+bool UrlIndex::isLoading()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return loadState == eLoading;
+}
+
+std::string UrlIndex::takeChanges()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	std::string result;
+	result.swap(changes);
+	return result;
+}
+
+uint64_t UrlIndex::fingerprint(const std::string &url)
+{
+	uint64_t print = std::hash<std::string>()(url);
+	return print <= removedSlot ? print + removedSlot + 1 : print;
+}
+
+size_t UrlIndex::findSlot(uint64_t print)
+{
+	// The table is never full, so there always is an empty slot to stop at.
+	size_t mask = slots.size() - 1;
+	size_t removed = slots.size();
+	for (size_t i = print & mask;; i = (i + 1) & mask)
+	{
+		if (slots[i] == print)
+		{
+			return i;
+		}
+		if (slots[i] == emptySlot)
+		{
+			// Reuse the first removed slot passed, so the table does not fill up with them.
+			return removed < slots.size() ? removed : i;
+		}
+		if (slots[i] == removedSlot && removed == slots.size())
+		{
+			removed = i;
+		}
+	}
+}
+
+bool UrlIndex::add(uint64_t print)
+{
+	size_t slot = findSlot(print);
+	if (slots[slot] == print)
+	{
+		return false;
+	}
+	if (slots[slot] == emptySlot)
+	{
+		used++;
+	}
+	slots[slot] = print;
+	count++;
+
+	// Keep the table at most half full, counting the removed slots, so the searches stay short.
+	if (used * 2 > slots.size())
+	{
+		size_t amount = URL_INDEX_MIN_SLOTS;
+		while (amount <= count * 2)
+		{
+			amount *= 2;
+		}
+		resize(amount);
+	}
+	return true;
+}
+
+void UrlIndex::resize(size_t amount)
+{
+	std::vector<uint64_t> oldSlots(amount, emptySlot);
+	oldSlots.swap(slots);
+	used = count;
+	size_t mask = amount - 1;
+	for (uint64_t print : oldSlots)
+	{
+		if (print == emptySlot || print == removedSlot)
+		{
+			continue;
+		}
+		size_t i = print & mask;
+		while (slots[i] != emptySlot)
+		{
+			i = (i + 1) & mask;
+		}
+		slots[i] = print;
+	}
+}
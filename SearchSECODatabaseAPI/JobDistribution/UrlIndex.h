@@ -0,0 +1,123 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#define URL_INDEX_MIN_SLOTS 1024 // Slots of an empty index, always a power of two.
+
+/// <summary>
+/// Keeps track of the urls of all jobs which are in the queue or being worked on, so the same repository is not
+/// added to the queue twice. Every node keeps one, the leader passes on its changes with the heartbeat.
+/// Only a 64 bit fingerprint of every url is kept, in a table which is at most half full, so a url takes 16 to 32
+/// bytes: ten million queued urls take at most 320 MB. Two urls with the same fingerprint are seen as the same,
+/// for ten million urls the chance this happens at all is about one in 370000.
+/// </summary>
+class UrlIndex
+{
+public:
+	/// <summary>
+	/// Adds the given url, if it is not known yet.
+	/// </summary>
+	/// <param name="replicate"> If true, the change is passed on to the other nodes. </param>
+	/// <returns> True if the url was added, false if it was already known. </returns>
+	bool insert(std::string url, bool replicate = true);
+
+	/// <summary>
+	/// Forgets the given url, after its job is finished or dropped.
+	/// </summary>
+	/// <param name="replicate"> If true, the change is passed on to the other nodes. </param>
+	void remove(std::string url, bool replicate = true);
+
+	/// <summary>
+	/// Returns true if the given url is known.
+	/// </summary>
+	bool contains(std::string url);
+
+	/// <summary>
+	/// Adds all given urls, as retrieved from the database. Urls removed since loading started are skipped,
+	/// as the database may not have known about that yet.
+	/// </summary>
+	void addAll(std::vector<std::string> urls);
+
+	/// <summary>
+	/// Forgets all urls.
+	/// </summary>
+	void clear();
+
+	/// <summary>
+	/// Returns the amount of urls known.
+	/// </summary>
+	int size();
+
+	/// <summary>
+	/// Marks the urls as being retrieved from the database, unless that was done before.
+	/// </summary>
+	/// <returns> True if the urls should be retrieved, false if they are already known. </returns>
+	bool startLoading();
+
+	/// <summary>
+	/// Marks the urls as retrieved from the database, after which they are kept up to date in memory.
+	/// </summary>
+	void finishLoading();
+
+	/// <summary>
+	/// Returns true if the urls are being retrieved from the database at the moment.
+	/// </summary>
+	bool isLoading();
+
+	/// <summary>
+	/// Returns the urls added and removed since the last call, to be passed on to the other nodes.
+	/// This is "?U?url" for every url added and "?F?url" for every url forgotten.
+	/// </summary>
+	std::string takeChanges();
+
+private:
+	enum ELoadState
+	{
+		eUnloaded,
+		eLoading,
+		eLoaded
+	};
+
+	/// <summary>
+	/// Returns the fingerprint of the given url, which is never an emptySlot or removedSlot.
+	/// </summary>
+	static uint64_t fingerprint(const std::string &url);
+
+	/// <summary>
+	/// Returns the slot holding the given fingerprint, or the slot it should be put in if it is not there.
+	/// </summary>
+	size_t findSlot(uint64_t print);
+
+	/// <summary>
+	/// Adds the given fingerprint, if it is not there yet. Expects mtx to be locked.
+	/// </summary>
+	/// <returns> True if the fingerprint was added, false if it was already there. </returns>
+	bool add(uint64_t print);
+
+	/// <summary>
+	/// Moves all fingerprints to a table with the given amount of slots, dropping the removed slots.
+	/// </summary>
+	void resize(size_t amount);
+
+	static constexpr uint64_t emptySlot = 0;
+	static constexpr uint64_t removedSlot = 1;
+
+	std::vector<uint64_t> slots = std::vector<uint64_t>(URL_INDEX_MIN_SLOTS, emptySlot);
+	// The amount of fingerprints, and of slots which are not empty including the removed ones.
+	size_t count = 0;
+	size_t used = 0;
+	// The urls removed while loading, which an older page of the database should not add again.
+	std::unordered_set<uint64_t> removedWhileLoading;
+	ELoadState loadState = eUnloaded;
+	std::string changes;
+	std::mutex mtx;
+};
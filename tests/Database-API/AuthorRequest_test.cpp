@@ -11,12 +11,16 @@ Utrecht University within the Software Project course.
 #include "RaftConsensusMock.cpp"
 #include "HTTPStatus.h"
 #include "Utility.h"
+#include "md5/md5.h"
 
 #include <gtest/gtest.h>
 #include <iostream>
 
 std::string fieldDel(1, FIELD_DELIMITER_CHAR);
 
+// The checksum at the end of the continuation tokens for the paging state "\x01\xab?" of the author in the tests.
+std::string pageChecksum = md5("41ab73738f244a0383dc621036d99f34\x01\xab?").substr(0, CONTINUATION_CHECKSUM_LENGTH);
+
 // Checks if two authors are equal. I.e., they have the same contents.
 MATCHER_P(authorEqual, author, "")
 {
@@ -43,7 +47,7 @@ TEST(GetAuthorRequest, OneRequestOneMatch)
 
 	Author author("Author", "author@mail.com");
 
-	EXPECT_CALL(database, idToAuthor("47919e8f-7103-48a3-9514-3f2d9d49ac61")).WillOnce(testing::Return(author));
+	EXPECT_CALL(database, idToAuthor(Hash("47919e8f-7103-48a3-9514-3f2d9d49ac61"))).WillOnce(testing::Return(author));
 
 	// Check if the output is correct.
 	std::string result = handler.handleRequest("idau", "", request, nullptr);
@@ -66,7 +70,7 @@ TEST(GetAuthorRequest, OneRequestNoMatch)
 	std::string output = "No results found.";
 	Author author("","");
 
-	EXPECT_CALL(database, idToAuthor("47919e8f-7103-48a3-9514-3f2d9d49ac61")).WillOnce(testing::Return(author));
+	EXPECT_CALL(database, idToAuthor(Hash("47919e8f-7103-48a3-9514-3f2d9d49ac61"))).WillOnce(testing::Return(author));
 
 	// Check if the output is correct.
 	std::string result = handler.handleRequest("idau", "", request, nullptr);
@@ -106,8 +110,8 @@ TEST(GetAuthorRequest, MultipleRequestMultipleMatch)
 	Author author1("Author1", "author1@mail.com");
 	Author author2("Author2", "author2@mail.com");
 
-	EXPECT_CALL(database, idToAuthor("47919e8f-7103-48a3-9514-3f2d9d49ac61")).WillOnce(testing::Return(author1));
-	EXPECT_CALL(database, idToAuthor("41ab7373-8f24-4a03-83dc-621036d99f34")).WillOnce(testing::Return(author2));
+	EXPECT_CALL(database, idToAuthor(Hash("47919e8f-7103-48a3-9514-3f2d9d49ac61"))).WillOnce(testing::Return(author1));
+	EXPECT_CALL(database, idToAuthor(Hash("41ab7373-8f24-4a03-83dc-621036d99f34"))).WillOnce(testing::Return(author2));
 
 	// Check if the output is correct.
 	std::string result = handler.handleRequest("idau", "", request, nullptr);
@@ -139,8 +143,8 @@ TEST(GetAuthorRequest, MultipleRequestSingleMatch)
 	Author author2("", "");
 
 	// Test if the request is implemented correctly.
-	EXPECT_CALL(database, idToAuthor("47919e8f-7103-48a3-9514-3f2d9d49ac61")).WillOnce(testing::Return(author1));
-	EXPECT_CALL(database, idToAuthor("41ab7373-8f24-4a03-83dc-621036d99f34")).WillOnce(testing::Return(author2));
+	EXPECT_CALL(database, idToAuthor(Hash("47919e8f-7103-48a3-9514-3f2d9d49ac61"))).WillOnce(testing::Return(author1));
+	EXPECT_CALL(database, idToAuthor(Hash("41ab7373-8f24-4a03-83dc-621036d99f34"))).WillOnce(testing::Return(author2));
 	std::string result = handler.handleRequest("idau", "", request, nullptr);
 	ASSERT_EQ(result, HTTPStatusCodes::success(output));
 }
@@ -190,7 +194,7 @@ TEST(GetMethodByAuthorTests, SingleIDRequest)
 					  FIELD_DELIMITER_CHAR, ENTRY_DELIMITER_CHAR);
 	std::string output(outputChars.begin(), outputChars.end());
 
-	EXPECT_CALL(database, authorToMethods("41ab7373-8f24-4a03-83dc-621036d99f34")).WillOnce(testing::Return(v));
+	EXPECT_CALL(database, authorToMethods(Hash("41ab7373-8f24-4a03-83dc-621036d99f34"))).WillOnce(testing::Return(v));
 
 	// Check if the output is correct.
 	std::string result = handler.handleRequest("aume", "", "41ab7373-8f24-4a03-83dc-621036d99f34", nullptr);
@@ -241,8 +245,8 @@ TEST(GetMethodByAuthorTests, MultipleIDRequest)
 					  FIELD_DELIMITER_CHAR, ENTRY_DELIMITER_CHAR);
 	std::string output2(outputChars2.begin(), outputChars2.end());
 
-	EXPECT_CALL(database, authorToMethods("47919e8f-7103-48a3-9514-3f2d9d49ac61")).WillOnce(testing::Return(v1));
-	EXPECT_CALL(database, authorToMethods("41ab7373-8f24-4a03-83dc-621036d99f34")).WillOnce(testing::Return(v2));
+	EXPECT_CALL(database, authorToMethods(Hash("47919e8f-7103-48a3-9514-3f2d9d49ac61"))).WillOnce(testing::Return(v1));
+	EXPECT_CALL(database, authorToMethods(Hash("41ab7373-8f24-4a03-83dc-621036d99f34"))).WillOnce(testing::Return(v2));
 
 	// Check if the output is correct.
 	std::vector<char> inputFunctionChars = {};
@@ -268,7 +272,7 @@ TEST(GetMethodByAuthorTests, SingleIDNoMatch)
 
 	std::vector<MethodID> v;
 
-	EXPECT_CALL(database, authorToMethods("47919e8f-7103-48a3-9514-3f2d9d49ac61")).WillOnce(testing::Return(v));
+	EXPECT_CALL(database, authorToMethods(Hash("47919e8f-7103-48a3-9514-3f2d9d49ac61"))).WillOnce(testing::Return(v));
 
 	// Check if the output is correct.
 	std::string result = handler.handleRequest("aume", "", "47919e8f-7103-48a3-9514-3f2d9d49ac61", nullptr);
@@ -296,8 +300,8 @@ TEST(GetMethodByAuthorTests, MultipleIDOneMatch)
 	std::vector<MethodID> v2;
 	v.push_back(method);
 
-	EXPECT_CALL(database, authorToMethods("47919e8f-7103-48a3-9514-3f2d9d49ac61")).WillOnce(testing::Return(v2));
-	EXPECT_CALL(database, authorToMethods("41ab7373-8f24-4a03-83dc-621036d99f34")).WillOnce(testing::Return(v));
+	EXPECT_CALL(database, authorToMethods(Hash("47919e8f-7103-48a3-9514-3f2d9d49ac61"))).WillOnce(testing::Return(v2));
+	EXPECT_CALL(database, authorToMethods(Hash("41ab7373-8f24-4a03-83dc-621036d99f34"))).WillOnce(testing::Return(v));
 
 	// Check if the output is correct.
 	std::vector<char> inputFunctionChars = {};
@@ -358,7 +362,7 @@ TEST(GetMethodByAuthorTests, OneIDMultipleMatches)
 					  FIELD_DELIMITER_CHAR, ENTRY_DELIMITER_CHAR);
 	std::string output2(outputChars2.begin(), outputChars2.end());
 
-	EXPECT_CALL(database, authorToMethods("47919e8f-7103-48a3-9514-3f2d9d49ac61")).WillOnce(testing::Return(v));
+	EXPECT_CALL(database, authorToMethods(Hash("47919e8f-7103-48a3-9514-3f2d9d49ac61"))).WillOnce(testing::Return(v));
 
 	// Check if the output is correct.
 	std::string result = handler.handleRequest("aume", "", "47919e8f-7103-48a3-9514-3f2d9d49ac61", nullptr);
@@ -398,8 +402,8 @@ TEST(GetMethodByAuthorTests, MultipleIDsMultipleMatches)
 	v2.push_back(method3);
 
 	// We expect the following calls towards the database (mock).
-	EXPECT_CALL(database, authorToMethods("47919e8f-7103-48a3-9514-3f2d9d49ac61")).WillOnce(testing::Return(v1));
-	EXPECT_CALL(database, authorToMethods("41ab7373-8f24-4a03-83dc-621036d99f34")).WillOnce(testing::Return(v2));
+	EXPECT_CALL(database, authorToMethods(Hash("47919e8f-7103-48a3-9514-3f2d9d49ac61"))).WillOnce(testing::Return(v1));
+	EXPECT_CALL(database, authorToMethods(Hash("41ab7373-8f24-4a03-83dc-621036d99f34"))).WillOnce(testing::Return(v2));
 
 	std::vector<char> inputFunctionChars = {};
 	Utility::appendBy(inputFunctionChars,
@@ -450,3 +454,131 @@ TEST(GetMethodByAuthorTests, IncorrectInput)
 	std::string result = handler.handleRequest("aume", "", "41ab73738f244a0383dc621036d99f34", nullptr);
 	EXPECT_EQ(result, HTTPStatusCodes::clientError(output));
 }
+
+// Tests if program retrieves the first page of the methods of an author, and returns the paging state of the driver
+// with its checksum as continuation token.
+TEST(GetMethodByAuthorPageTests, FirstPage)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockDatabase database;
+	RequestHandler handler;
+	MockRaftConsensus raftConsensus;
+	MockJDDatabase jddatabase;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	MethodID method;
+	method.hash = "2c7f46d4f57cf9e66b03213358c7ddb5";
+	method.projectID = 42;
+	method.startVersion = 69;
+
+	std::vector<char> outputChars = {};
+	Utility::appendBy(outputChars,
+					  {"41ab7373-8f24-4a03-83dc-621036d99f34", "2c7f46d4f57cf9e66b03213358c7ddb5", "42", "69"},
+					  FIELD_DELIMITER_CHAR, ENTRY_DELIMITER_CHAR);
+	std::string output = "01ab3f" + pageChecksum + "\n" + std::string(outputChars.begin(), outputChars.end());
+
+	EXPECT_CALL(database, authorToMethodsPage(Hash("41ab7373-8f24-4a03-83dc-621036d99f34"), METHODS_PAGE_SIZE,
+											  testing::Eq(std::string(""))))
+		.WillOnce(testing::DoAll(testing::SetArgReferee<2>(std::string("\x01\xab?")),
+								 testing::Return(std::vector<MethodID>{method})));
+
+	// Check if the output is correct.
+	std::string result = handler.handleRequest("aump", "", "41ab7373-8f24-4a03-83dc-621036d99f34", nullptr);
+	EXPECT_EQ(result, HTTPStatusCodes::success(output));
+}
+
+// Tests if program continues at the given continuation token with the given page size, and returns an empty token
+// after the last page.
+TEST(GetMethodByAuthorPageTests, LastPage)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockDatabase database;
+	RequestHandler handler;
+	MockRaftConsensus raftConsensus;
+	MockJDDatabase jddatabase;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	MethodID method1;
+	method1.hash = "2c7f46d4f57cf9e66b03213358c7ddb5";
+	method1.projectID = 42;
+	method1.startVersion = 69;
+
+	MethodID method2;
+	method2.hash = "06f73d7ab46184c55bf4742b9428a4c0";
+	method2.projectID = 42;
+	method2.startVersion = 420;
+
+	// The methods are returned in the order of the page.
+	std::vector<char> outputChars = {};
+	Utility::appendBy(outputChars,
+					  {"41ab7373-8f24-4a03-83dc-621036d99f34", "2c7f46d4f57cf9e66b03213358c7ddb5", "42", "69"},
+					  FIELD_DELIMITER_CHAR, ENTRY_DELIMITER_CHAR);
+	Utility::appendBy(outputChars,
+					  {"41ab7373-8f24-4a03-83dc-621036d99f34", "06f73d7ab46184c55bf4742b9428a4c0", "42", "420"},
+					  FIELD_DELIMITER_CHAR, ENTRY_DELIMITER_CHAR);
+	std::string output = "\n" + std::string(outputChars.begin(), outputChars.end());
+
+	EXPECT_CALL(database, authorToMethodsPage(Hash("41ab7373-8f24-4a03-83dc-621036d99f34"), 2,
+											  testing::Eq(std::string("\x01\xab?"))))
+		.WillOnce(testing::DoAll(testing::SetArgReferee<2>(std::string("")),
+								 testing::Return(std::vector<MethodID>{method1, method2})));
+
+	// Check if the output is correct.
+	std::string result =
+		handler.handleRequest("aump", "", "41ab7373-8f24-4a03-83dc-621036d99f34?2?01AB3f" + pageChecksum, nullptr);
+	EXPECT_EQ(result, HTTPStatusCodes::success(output));
+}
+
+// Tests if program returns an error message when the page size or continuation token is incorrect.
+TEST(GetMethodByAuthorPageTests, IncorrectInput)
+{
+	// Set up the test.
+	MockDatabase database;
+	RequestHandler handler;
+	MockRaftConsensus raftConsensus;
+	MockJDDatabase jddatabase;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	EXPECT_CALL(database, authorToMethodsPage(testing::_, testing::_, testing::_)).Times(0);
+
+	// Test if the output is correct.
+	std::string pageSizeError = HTTPStatusCodes::clientError("The page size should be an integer between 1 and " +
+															 std::to_string(METHODS_PAGE_SIZE_MAX) + ".");
+	EXPECT_EQ(handler.handleRequest("aump", "", "41ab7373-8f24-4a03-83dc-621036d99f34?0", nullptr), pageSizeError);
+	EXPECT_EQ(handler.handleRequest("aump", "", "41ab7373-8f24-4a03-83dc-621036d99f34?size", nullptr), pageSizeError);
+	EXPECT_EQ(handler.handleRequest("aump", "", "41ab7373-8f24-4a03-83dc-621036d99f34??0x1", nullptr),
+			  HTTPStatusCodes::clientError("Error parsing continuation token: 0x1"));
+
+	// Tokens which are valid hex, but were not given out for the author, are rejected as well.
+	EXPECT_EQ(handler.handleRequest("aump", "", "41ab7373-8f24-4a03-83dc-621036d99f34??01ab3f", nullptr),
+			  HTTPStatusCodes::clientError("Error parsing continuation token: 01ab3f"));
+	EXPECT_EQ(handler.handleRequest("aump", "", "41ab7373-8f24-4a03-83dc-621036d99f34??01ab3f00000000", nullptr),
+			  HTTPStatusCodes::clientError("Error parsing continuation token: 01ab3f00000000"));
+	EXPECT_EQ(handler.handleRequest("aump", "", "47919e8f-7103-48a3-9514-3f2d9d49ac61??01ab3f" + pageChecksum, nullptr),
+			  HTTPStatusCodes::clientError("Error parsing continuation token: 01ab3f" + pageChecksum));
+}
+
+// Tests if an empty last page still starts with the empty continuation token.
+TEST(GetMethodByAuthorPageTests, EmptyLastPage)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockDatabase database;
+	RequestHandler handler;
+	MockRaftConsensus raftConsensus;
+	MockJDDatabase jddatabase;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	EXPECT_CALL(database, authorToMethodsPage(Hash("41ab7373-8f24-4a03-83dc-621036d99f34"), METHODS_PAGE_SIZE,
+											  testing::Eq(std::string(""))))
+		.WillOnce(testing::Return(std::vector<MethodID>()));
+
+	// Check if the output is correct.
+	std::string result = handler.handleRequest("aump", "", "41ab7373-8f24-4a03-83dc-621036d99f34", nullptr);
+	EXPECT_EQ(result, HTTPStatusCodes::success("\n"));
+}
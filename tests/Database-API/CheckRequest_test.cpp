@@ -95,7 +95,7 @@ TEST(CheckRequestTests, SingleHashRequest)
 					  FIELD_DELIMITER_CHAR, ENTRY_DELIMITER_CHAR);
 	std::string output1(outputChars1.begin(), outputChars1.end());
 
-	EXPECT_CALL(database,hashToMethods("2c7f46d4f57cf9e66b03213358c7ddb5")).WillOnce(testing::Return(v));
+	EXPECT_CALL(database,hashToMethods(Hash("2c7f46d4f57cf9e66b03213358c7ddb5"))).WillOnce(testing::Return(v));
 
 	// Check if the output is correct.
 	std::string result = handler.handleRequest("chck", "", "2c7f46d4f57cf9e66b03213358c7ddb5", nullptr);
@@ -121,9 +121,9 @@ TEST(CheckRequestTests, MultipleHashRequest)
 	v3.push_back(testMethod3);
 
 	// We expect some calls towards the database.
-	EXPECT_CALL(database, hashToMethods("2c7f46d4f57cf9e66b03213358c7ddb5")).WillOnce(testing::Return(v1));
-	EXPECT_CALL(database, hashToMethods("06f73d7ab46184c55bf4742b9428a4c0")).WillOnce(testing::Return(v2));
-	EXPECT_CALL(database, hashToMethods("137fed017b6159acc0af30d2c6b403a5")).WillOnce(testing::Return(v3));
+	EXPECT_CALL(database, hashToMethods(Hash("2c7f46d4f57cf9e66b03213358c7ddb5"))).WillOnce(testing::Return(v1));
+	EXPECT_CALL(database, hashToMethods(Hash("06f73d7ab46184c55bf4742b9428a4c0"))).WillOnce(testing::Return(v2));
+	EXPECT_CALL(database, hashToMethods(Hash("137fed017b6159acc0af30d2c6b403a5"))).WillOnce(testing::Return(v3));
 
 	std::vector<char> inputFunctionChars = {};
 	Utility::appendBy(
@@ -175,7 +175,7 @@ TEST(CheckRequestTests, SingleHashNoMatch)
 	handler.initialize(&database, &jddatabase, nullptr, nullptr);
 	std::vector<MethodOut> v;
 
-	EXPECT_CALL(database,hashToMethods("2c7f46d4f57cf9e66b03213358c7ddb5")).WillOnce(testing::Return(v));
+	EXPECT_CALL(database,hashToMethods(Hash("2c7f46d4f57cf9e66b03213358c7ddb5"))).WillOnce(testing::Return(v));
 
 	// Check if the output is correct.
 	std::string result = handler.handleRequest("chck", "", "2c7f46d4f57cf9e66b03213358c7ddb5", nullptr);
@@ -194,9 +194,9 @@ TEST(CheckRequestTests, MultipleHashOneMatch)
 	std::vector<MethodOut> v2;
 	v.push_back(testMethod2);
 
-	EXPECT_CALL(database, hashToMethods("2c7f46d4f57cf9e66b03213358c7ddb5")).WillOnce(testing::Return(v2));
-	EXPECT_CALL(database, hashToMethods("06f73d7ab46184c55bf4742b9428a4c0")).WillOnce(testing::Return(v));
-	EXPECT_CALL(database, hashToMethods("137fed017b6159acc0af30d2c6b403a5")).WillOnce(testing::Return(v2));
+	EXPECT_CALL(database, hashToMethods(Hash("2c7f46d4f57cf9e66b03213358c7ddb5"))).WillOnce(testing::Return(v2));
+	EXPECT_CALL(database, hashToMethods(Hash("06f73d7ab46184c55bf4742b9428a4c0"))).WillOnce(testing::Return(v));
+	EXPECT_CALL(database, hashToMethods(Hash("137fed017b6159acc0af30d2c6b403a5"))).WillOnce(testing::Return(v2));
 
 	std::vector<char> inputFunctionChars = {};
 	Utility::appendBy(
@@ -250,7 +250,7 @@ TEST(CheckRequestTests, OneHashMultipleMatches)
 	v.push_back(testMethod1);
 	v.push_back(testMethod4);
 
-	EXPECT_CALL(database, hashToMethods("2c7f46d4f57cf9e66b03213358c7ddb5")).WillOnce(testing::Return(v));
+	EXPECT_CALL(database, hashToMethods(Hash("2c7f46d4f57cf9e66b03213358c7ddb5"))).WillOnce(testing::Return(v));
 	std::string result = handler.handleRequest("chck", "", "2c7f46d4f57cf9e66b03213358c7ddb5", nullptr);
 
 	std::vector<char> outputChars1 = {};
@@ -294,9 +294,9 @@ TEST(CheckRequestTests, MultipleHashesMultipleMatches)
 	v3.push_back(testMethod3);
 
 	// We expect some calls towards the database.
-	EXPECT_CALL(database, hashToMethods("2c7f46d4f57cf9e66b03213358c7ddb5")).WillOnce(testing::Return(v1));
-	EXPECT_CALL(database, hashToMethods("06f73d7ab46184c55bf4742b9428a4c0")).WillOnce(testing::Return(v2));
-	EXPECT_CALL(database, hashToMethods("137fed017b6159acc0af30d2c6b403a5")).WillOnce(testing::Return(v3));
+	EXPECT_CALL(database, hashToMethods(Hash("2c7f46d4f57cf9e66b03213358c7ddb5"))).WillOnce(testing::Return(v1));
+	EXPECT_CALL(database, hashToMethods(Hash("06f73d7ab46184c55bf4742b9428a4c0"))).WillOnce(testing::Return(v2));
+	EXPECT_CALL(database, hashToMethods(Hash("137fed017b6159acc0af30d2c6b403a5"))).WillOnce(testing::Return(v3));
 
 	std::vector<char> inputFunctionChars = {};
 	Utility::appendBy(
@@ -19,18 +19,23 @@ class MockDatabase : public DatabaseHandler
 {
 public:
 	MOCK_METHOD(void, connect, (std::string ip, int port), ());
-	MOCK_METHOD(bool, addProject, (ProjectIn project), ());
-	MOCK_METHOD(void, addHashToProject, (ProjectIn project, int index), ());
+	MOCK_METHOD(bool, addProject, (const ProjectIn &project), ());
+	MOCK_METHOD(void, addHashToProject, (const ProjectIn &project, int index), ());
+	MOCK_METHOD(void, addAuthors, (const std::vector<Author> &authors), ());
 	MOCK_METHOD(void, addMethod,
-				(MethodIn method, ProjectIn project, long long prevVersion, long long parserVersion, bool newProject),
+				(const MethodIn &method, const ProjectIn &project, long long prevVersion, long long parserVersion,
+				 bool newProject),
 				());
-	MOCK_METHOD(ProjectOut, searchForProject, (ProjectID projectID, Version version), ());
-	MOCK_METHOD(ProjectOut, prevProject, (ProjectID projectID), ());
+	MOCK_METHOD(ProjectOut, searchForProject, (ProjectID projectID, Version version, bool withHashes), ());
+	MOCK_METHOD(ProjectOut, prevProject, (ProjectID projectID, bool withHashes), ());
 	MOCK_METHOD(std::vector<Hash>, updateUnchangedFiles,
-				(std::vector<Hash> hashes, std::vector<std::string> files, ProjectIn project, long long prevVersion),
+				(const std::vector<Hash> &hashes, const std::vector<std::string> &files, const ProjectIn &project,
+				 long long prevVersion),
 				());
-	MOCK_METHOD(std::vector<MethodOut>, hashToMethods, (std::string hash), ());
+	MOCK_METHOD(std::vector<MethodOut>, hashToMethods, (Hash hash), ());
 	MOCK_METHOD(std::string, authorToID, (Author author), ());
-	MOCK_METHOD(Author, idToAuthor, (std::string id), ());
-	MOCK_METHOD(std::vector<MethodID>, authorToMethods, (std::string authorID));
+	MOCK_METHOD(Author, idToAuthor, (const Hash &id), ());
+	MOCK_METHOD(std::vector<MethodID>, authorToMethods, (const Hash &authorID));
+	MOCK_METHOD(std::vector<MethodID>, authorToMethodsPage,
+				(const Hash &authorID, int pageSize, std::string &pagingState), ());
 };
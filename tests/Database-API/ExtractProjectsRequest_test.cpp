@@ -68,7 +68,7 @@ TEST(ExtractProjectsRequestTests, SingleExistingProject)
 					  FIELD_DELIMITER_CHAR, ENTRY_DELIMITER_CHAR);
 	std::string expected2(expectedChars.begin(), expectedChars.end());
 
-	EXPECT_CALL(database, searchForProject(projectID2, version2)).WillOnce(testing::Return(p2));
+	EXPECT_CALL(database, searchForProject(projectID2, version2, false)).WillOnce(testing::Return(p2));
 
 	// Check if the output is correct.
 	std::string output2 = handler.handleRequest("extp", "", input2, nullptr);
@@ -97,7 +97,8 @@ TEST(ExtractProjectsRequestTests, SingleNonExistingProject)
 	ProjectOut p3;
 	std::string expected3 = "No results found.";
 
-	EXPECT_CALL(database, searchForProject(projectID3, version3)).WillOnce(testing::SetErrnoAndReturn(ERANGE, p3));
+	EXPECT_CALL(database, searchForProject(projectID3, version3, false))
+		.WillOnce(testing::SetErrnoAndReturn(ERANGE, p3));
 
 	// Check if the output is correct.
 	std::string output3 = handler.handleRequest("extp", "", input3, nullptr);
@@ -185,11 +186,11 @@ TEST(ExtractProjectsRequestTests, MultipleProjects)
 	std::string expected4_3(expectedChars3.begin(), expectedChars3.end());
 
 	std::vector<std::string> expected4 = {expected4_1, expected4_2, expected4_3};
-	EXPECT_CALL(database, searchForProject(projectID4_1, version4_1)).WillOnce(testing::Return(project4_1));
-	EXPECT_CALL(database, searchForProject(projectID4_2, version4_2))
+	EXPECT_CALL(database, searchForProject(projectID4_1, version4_1, false)).WillOnce(testing::Return(project4_1));
+	EXPECT_CALL(database, searchForProject(projectID4_2, version4_2, false))
 		.WillOnce(testing::SetErrnoAndReturn(ERANGE, project4_2));
-	EXPECT_CALL(database, searchForProject(projectID4_3, version4_3)).WillOnce(testing::Return(project4_3));
-	EXPECT_CALL(database, searchForProject(projectID4_4, version4_4)).WillOnce(testing::Return(project4_4));
+	EXPECT_CALL(database, searchForProject(projectID4_3, version4_3, false)).WillOnce(testing::Return(project4_3));
+	EXPECT_CALL(database, searchForProject(projectID4_4, version4_4, false)).WillOnce(testing::Return(project4_4));
 	std::string output4 = handler.handleRequest("extp", "", input4, nullptr);
 	std::vector<std::string> entries4 =
 		Utility::splitStringOn(HTTPStatusCodes::getMessage(output4), ENTRY_DELIMITER_CHAR);
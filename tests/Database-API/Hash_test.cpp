@@ -0,0 +1,85 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "DatabaseUtility.h"
+#include "Types.h"
+
+#include <gtest/gtest.h>
+
+using namespace types;
+
+// Test if a hash is converted back to the hex characters it was parsed from.
+TEST(HashTests, RoundTrip)
+{
+	std::string hex = "2c7f46d4f57cf9e66b03213358c7ddb5";
+	Hash hash;
+	ASSERT_TRUE(Hash::parse(hex, hash));
+	EXPECT_EQ(hash.bytes[0], 0x2c);
+	EXPECT_EQ(hash.bytes[15], 0xb5);
+	EXPECT_EQ(hash.toString(), hex);
+	EXPECT_EQ(hash, Hash("2c7f46d4f57cf9e66b03213358c7ddb5"));
+	EXPECT_NE(hash, Hash("06f73d7ab46184c55bf4742b9428a4c0"));
+}
+
+// Test if strings which are not 32 lowercase hex characters are rejected.
+TEST(HashTests, Invalid)
+{
+	Hash hash;
+	EXPECT_FALSE(Hash::parse("2C7F46D4F57CF9E66B03213358C7DDB5", hash));
+	EXPECT_FALSE(Hash::parse("2c7f46d4f57cf9e66b03213358c7ddb", hash));
+	EXPECT_FALSE(Hash::parse("2c7f46d4f57cf9e66b03213358c7ddb55", hash));
+	EXPECT_FALSE(Hash::parse("2c7f46d4f57cf9e66b03213358c7ddbg", hash));
+	EXPECT_FALSE(Hash::parse("2c7f46d4f57cf9e66b03213358c7dd/5", hash));
+	EXPECT_FALSE(Hash::parse("2c7f46d4f57cf9e66b03213358c7dd:5", hash));
+	EXPECT_EQ(hash, Hash());
+}
+
+// Test if a hash is stored as the UUID with the same bytes.
+TEST(HashTests, Uuid)
+{
+	Hash hash("00112233445566778899aabbccddeeff");
+	CassUuid uuid = DatabaseUtility::hashToUuid(hash);
+	EXPECT_EQ(uuid.time_and_version, 0x6677445500112233);
+	EXPECT_EQ(uuid.clock_seq_and_node, 0x8899aabbccddeeff);
+	EXPECT_EQ(DatabaseUtility::uuidToHash(uuid), hash);
+}
+
+// Test if UUIDs of either case are parsed to the hash with the same hex characters, and others are rejected.
+TEST(HashTests, ParseUuid)
+{
+	Hash hash;
+	ASSERT_TRUE(Hash::parseUuid("47919e8f-7103-48a3-9514-3f2d9d49ac61", hash));
+	EXPECT_EQ(hash, Hash("47919e8f710348a395143f2d9d49ac61"));
+	EXPECT_EQ(hash.toUuidString(), "47919e8f-7103-48a3-9514-3f2d9d49ac61");
+	ASSERT_TRUE(Hash::parseUuid("47919E8F-7103-48A3-9514-3F2D9D49AC61", hash));
+	EXPECT_EQ(hash, Hash("47919e8f710348a395143f2d9d49ac61"));
+
+	Hash unchanged;
+	EXPECT_FALSE(Hash::parseUuid("47919e8f710348a395143f2d9d49ac61", unchanged));
+	EXPECT_FALSE(Hash::parseUuid("47919e8f-7103-48a3-9514-3f2d9d49ac6", unchanged));
+	EXPECT_FALSE(Hash::parseUuid("47919e8f-710348a3-9514-3f2d9d49ac61-", unchanged));
+	EXPECT_FALSE(Hash::parseUuid("47919e8f-7103-48a3-9514-3f2d9d49ac6g", unchanged));
+	EXPECT_FALSE(Hash::parseUuid("47919e8f-7103-48a3-9514-3f2d9d49ac6\x11", unchanged));
+	EXPECT_EQ(unchanged, Hash());
+}
+
+// Checks if bytes survive being encoded as hex and decoded again,
+// and if malformed hex is rejected without changing the output.
+TEST(HashTests, BytesToHexRoundTrip)
+{
+	std::string input("\x00\x7f\x80\xff?\n", 6);
+
+	std::string hex = Hash::bytesToHex(input);
+	ASSERT_EQ(hex, "007f80ff3f0a");
+
+	std::string output;
+	ASSERT_TRUE(Hash::hexToBytes("007F80FF3f0a", output));
+	ASSERT_EQ(output, input);
+
+	ASSERT_FALSE(Hash::hexToBytes("007", output));
+	ASSERT_FALSE(Hash::hexToBytes("0g", output));
+	ASSERT_EQ(output, input);
+}
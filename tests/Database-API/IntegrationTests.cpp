@@ -911,7 +911,7 @@ TEST(DatabaseIntegrationTest, UploadRequestUpdateProjectWithoutUnchangedFiles)
 
 	// There should be a new project with projectID 1 and version
 	// 5000000002000, with only the new method with the correct start- and endVersion).
-	ProjectOut project = database.searchForProject(1, 5000000002000);
+	ProjectOut project = database.searchForProject(1, 5000000002000, true);
 	ASSERT_EQ(project.hashes.size(), 1);
 
 	std::string methodData = handler.handleRequest("chck", "", input2, nullptr);
@@ -960,7 +960,7 @@ TEST(DatabaseIntegrationTest, UploadRequestUpdateProjectWithUnchangedFile)
 	// There should be a new project with projectID 1 and version
 	// 5000000010000, with both the unchanged method and the added 
 	// method with the correct start- and endVersion.
-	ProjectOut project = database.searchForProject(1, 5000000010000);
+	ProjectOut project = database.searchForProject(1, 5000000010000, true);
 	ASSERT_EQ(project.hashes.size(), 2);
 
 	// First check if the added method contains the correct start- and endVersion.
@@ -1028,7 +1028,7 @@ TEST(DatabaseIntegrationTest, UploadRequestUpdateProjectWithBothChangedAndUnchan
 	// There should be a new project with projectID 1 and version
 	// 5000000020000, with both the unchanged method and the added 
 	// methods with the correct start- and endVersion.
-	ProjectOut project = database.searchForProject(3, 5000000020000);
+	ProjectOut project = database.searchForProject(3, 5000000020000, true);
 	ASSERT_EQ(project.hashes.size(), 3);
 
 	// First check if the added method contains the correct start- and endVersion.
@@ -1119,7 +1119,7 @@ TEST(DatabaseIntegrationTest, UploadRequestWithMethodInChangedFile)
 	// There should be a new project with projectID 5 and version
 	// 5000000010000, with both the unchanged method and the added
 	// method with the correct start- and endVersion.
-	ProjectOut project = database.searchForProject(5, 5000000010000);
+	ProjectOut project = database.searchForProject(5, 5000000010000, true);
 	ASSERT_EQ(project.hashes.size(), 3);
 
 	// Check if the unchanged method in changed file is updated correctly.
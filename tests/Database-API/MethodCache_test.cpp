@@ -0,0 +1,98 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "MethodCache.h"
+#include "Utility.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+MATCHER_P(cachedMethodEqual, method, "")
+{
+	return arg.hash == method.hash && arg.projectID == method.projectID && arg.fileLocation == method.fileLocation &&
+		   arg.startVersion == method.startVersion && arg.startVersionHash == method.startVersionHash &&
+		   arg.endVersion == method.endVersion && arg.endVersionHash == method.endVersionHash &&
+		   arg.methodName == method.methodName && arg.lineNumber == method.lineNumber &&
+		   arg.vulnCode == method.vulnCode && arg.authorIDs == method.authorIDs &&
+		   arg.parserVersion == method.parserVersion && arg.license == method.license;
+}
+
+MethodOut cachedMethod(Hash hash, int lineNumber)
+{
+	MethodOut method;
+	method.hash = hash;
+	method.projectID = 5000000000000;
+	method.fileLocation = "src/main.cpp";
+	method.startVersion = 1;
+	method.startVersionHash = "a";
+	method.endVersion = 2;
+	method.endVersionHash = "b";
+	method.methodName = "main";
+	method.lineNumber = lineNumber;
+	method.vulnCode = "";
+	method.authorIDs = {"68bd2db6-fe91-47d2-a134-cf07b7ee6f16", "47919e8f-7103-48a3-9514-3f2d9d49ac61"};
+	method.parserVersion = 3;
+	method.license = "MIT";
+	return method;
+}
+
+// Test if the methods of a hash are returned as they were added.
+TEST(MethodCacheTests, RoundTrip)
+{
+	MethodCache cache;
+	std::vector<MethodOut> methods = {cachedMethod("2c7f46d4f57cf9e66b03213358c7ddb5", 1),
+									  cachedMethod("2c7f46d4f57cf9e66b03213358c7ddb5", 20)};
+
+	std::vector<MethodOut> result;
+	EXPECT_FALSE(cache.get(methods[0].hash, result));
+	cache.put(methods[0].hash, methods, Utility::getCurrentTimeMilliSeconds());
+	ASSERT_TRUE(cache.get(methods[0].hash, result));
+	EXPECT_THAT(result, testing::ElementsAre(cachedMethodEqual(methods[0]), cachedMethodEqual(methods[1])));
+}
+
+// Test if an invalidated hash is removed, and results of lookups from before the invalidation are not added.
+TEST(MethodCacheTests, Invalidate)
+{
+	MethodCache cache;
+	Hash hash = "2c7f46d4f57cf9e66b03213358c7ddb5";
+	std::vector<MethodOut> methods = {cachedMethod(hash, 1)};
+	std::vector<MethodOut> result;
+
+	long long lookupStart = Utility::getCurrentTimeMilliSeconds();
+	cache.put(hash, methods, lookupStart);
+	cache.invalidate(hash);
+	EXPECT_FALSE(cache.get(hash, result));
+
+	cache.put(hash, methods, lookupStart);
+	EXPECT_FALSE(cache.get(hash, result));
+}
+
+// Test if a hash which is requested rarely does not push out a hash which is requested often.
+TEST(MethodCacheTests, Admission)
+{
+	Hash popular = "2c7f46d4f57cf9e66b03213358c7ddb5";
+	Hash rare = "06f73d7ab46184c55bf4742b9428a4c0";
+	std::vector<MethodOut> methods = {cachedMethod(popular, 1)};
+	size_t size = MethodCache::serialize(methods).size() + sizeof(Hash) + METHOD_CACHE_ENTRY_OVERHEAD;
+	MethodCache cache(8 * size);
+
+	std::vector<MethodOut> result;
+	for (int i = 0; i < 10; i++)
+	{
+		cache.get(popular, result);
+	}
+	cache.put(popular, methods, Utility::getCurrentTimeMilliSeconds());
+
+	// Fill the cache, the popular hash is now the least recently used one.
+	for (int i = 1; i < 8; i++)
+	{
+		cache.put(Hash(md5(std::to_string(i))), {cachedMethod(popular, i)}, Utility::getCurrentTimeMilliSeconds());
+	}
+	EXPECT_FALSE(cache.get(rare, result));
+	cache.put(rare, methods, Utility::getCurrentTimeMilliSeconds());
+	EXPECT_FALSE(cache.get(rare, result));
+	EXPECT_TRUE(cache.get(popular, result));
+}
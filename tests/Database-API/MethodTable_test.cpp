@@ -0,0 +1,66 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "MethodTable.h"
+
+#include <gtest/gtest.h>
+
+MethodOut tableMethod(Hash hash, std::string name, std::vector<AuthorID> authorIDs)
+{
+	MethodOut method;
+	method.hash = hash;
+	method.projectID = 5000000000000;
+	method.fileLocation = "src/main.cpp";
+	method.startVersion = 1;
+	method.startVersionHash = "a";
+	method.endVersion = 2;
+	method.endVersionHash = "b";
+	method.methodName = name;
+	method.lineNumber = 10;
+	method.vulnCode = "";
+	method.authorIDs = authorIDs;
+	method.parserVersion = 3;
+	method.license = "MIT";
+	return method;
+}
+
+// Test if methods are converted to a string from the last to the first.
+TEST(MethodTableTests, ToString)
+{
+	MethodTable table;
+	EXPECT_EQ(table.toString('?', '\n'), "");
+
+	table.append(tableMethod("2c7f46d4f57cf9e66b03213358c7ddb5", "main", {"68bd2db6-fe91-47d2-a134-cf07b7ee6f16"}));
+	table.append(tableMethod("06f73d7ab46184c55bf4742b9428a4c0", "init", {}));
+	EXPECT_EQ(table.toString('?', '\n'),
+			  "06f73d7ab46184c55bf4742b9428a4c0?5000000000000?1?a?2?b?init?src/main.cpp?10?3??MIT?0\n"
+			  "2c7f46d4f57cf9e66b03213358c7ddb5?5000000000000?1?a?2?b?main?src/main.cpp?10?3??MIT?1?"
+			  "68bd2db6-fe91-47d2-a134-cf07b7ee6f16\n");
+}
+
+// Test if the methods of appended tables keep their strings and authors.
+TEST(MethodTableTests, AppendTable)
+{
+	MethodTable first;
+	first.append(tableMethod("2c7f46d4f57cf9e66b03213358c7ddb5", "main", {"68bd2db6-fe91-47d2-a134-cf07b7ee6f16"}));
+	MethodTable second;
+	second.append(tableMethod("06f73d7ab46184c55bf4742b9428a4c0", "init",
+							  {"47919e8f-7103-48a3-9514-3f2d9d49ac61", "68bd2db6-fe91-47d2-a134-cf07b7ee6f16"}));
+
+	size_t textSize = first.textSize() + second.textSize();
+	first.reserve(2, textSize);
+	first.append(second);
+	ASSERT_EQ(first.size(), 2);
+	EXPECT_EQ(first.textSize(), textSize);
+	MethodOut method = first.get(1);
+	EXPECT_EQ(method.hash, Hash("06f73d7ab46184c55bf4742b9428a4c0"));
+	EXPECT_EQ(method.methodName, "init");
+	EXPECT_EQ(method.fileLocation, "src/main.cpp");
+	EXPECT_EQ(method.license, "MIT");
+	EXPECT_EQ(method.authorIDs, std::vector<AuthorID>({"47919e8f-7103-48a3-9514-3f2d9d49ac61",
+													   "68bd2db6-fe91-47d2-a134-cf07b7ee6f16"}));
+	EXPECT_EQ(first.get(0).methodName, "main");
+}
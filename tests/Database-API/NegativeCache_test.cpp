@@ -0,0 +1,48 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "NegativeCache.h"
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+// Test if hashes without methods are remembered, and forgotten once methods are added for them.
+TEST(NegativeCacheTests, PutAndInvalidate)
+{
+	NegativeCache cache(16);
+	Hash hash = "2c7f46d4f57cf9e66b03213358c7ddb5";
+	Hash other = "06f73d7ab46184c55bf4742b9428a4c0";
+
+	long long lookupStart = Utility::getCurrentTimeMilliSeconds();
+	EXPECT_FALSE(cache.contains(hash));
+	cache.put(hash, lookupStart);
+	cache.put(other, lookupStart);
+	EXPECT_TRUE(cache.contains(hash));
+	EXPECT_EQ(cache.size(), 2);
+
+	cache.invalidate(hash);
+	EXPECT_FALSE(cache.contains(hash));
+	EXPECT_TRUE(cache.contains(other));
+	EXPECT_EQ(cache.size(), 1);
+
+	// The lookup started before the methods were added, so its result is outdated.
+	cache.put(hash, lookupStart);
+	EXPECT_FALSE(cache.contains(hash));
+}
+
+// Test if the oldest generation is dropped when the cache fills up.
+TEST(NegativeCacheTests, Generations)
+{
+	NegativeCache cache(16);
+	long long lookupStart = Utility::getCurrentTimeMilliSeconds();
+	for (int i = 0; i < 24; i++)
+	{
+		cache.put(Hash(md5(std::to_string(i))), lookupStart);
+	}
+	EXPECT_FALSE(cache.contains(Hash(md5("0"))));
+	EXPECT_TRUE(cache.contains(Hash(md5("23"))));
+	EXPECT_EQ(cache.bytes(), 2 * 16 * sizeof(uint64_t));
+}
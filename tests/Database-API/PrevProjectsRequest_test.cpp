@@ -64,7 +64,7 @@ TEST(ExtractPrevProjectsRequestTests, SingleExistingProject)
 					  FIELD_DELIMITER_CHAR, ENTRY_DELIMITER_CHAR);
 	std::string expected2(expectedChars.begin(), expectedChars.end());
 
-	EXPECT_CALL(database, prevProject(projectID2)).WillOnce(testing::Return(project2));
+	EXPECT_CALL(database, prevProject(projectID2, false)).WillOnce(testing::Return(project2));
 
 	// Check if the output is as expected.
 	std::string output2 = handler.handleRequest("gppr", "", input2, nullptr);
@@ -93,7 +93,7 @@ TEST(ExtractPrevProjectsRequestTests, SingleNonExistingProject)
 	project.projectID = -1;
 	std::string expected3 = "No results found.";
 
-	EXPECT_CALL(database, prevProject(projectID3)).WillOnce(testing::SetErrnoAndReturn(ERANGE, project));
+	EXPECT_CALL(database, prevProject(projectID3, false)).WillOnce(testing::SetErrnoAndReturn(ERANGE, project));
 
 	// Check if the output is as expected.
 	std::string output3 = handler.handleRequest("gppr", "", input3, nullptr);
@@ -174,10 +174,10 @@ TEST(ExtractPrevProjectsRequestTests, MultipleProjects)
 	std::string expected4_3(expectedChars3.begin(), expectedChars3.end());
 
 	std::vector<std::string> expected4 = {expected4_1, expected4_2, expected4_3};
-	EXPECT_CALL(database, prevProject(projectID4_1)).WillOnce(testing::Return(project4_1));
-	EXPECT_CALL(database, prevProject(projectID4_2)).WillOnce(testing::Return(project4_2));
-	EXPECT_CALL(database, prevProject(projectID4_3)).WillOnce(testing::SetErrnoAndReturn(ERANGE, project4_3));
-	EXPECT_CALL(database, prevProject(projectID4_4)).WillOnce(testing::Return(project4_4));
+	EXPECT_CALL(database, prevProject(projectID4_1, false)).WillOnce(testing::Return(project4_1));
+	EXPECT_CALL(database, prevProject(projectID4_2, false)).WillOnce(testing::Return(project4_2));
+	EXPECT_CALL(database, prevProject(projectID4_3, false)).WillOnce(testing::SetErrnoAndReturn(ERANGE, project4_3));
+	EXPECT_CALL(database, prevProject(projectID4_4, false)).WillOnce(testing::Return(project4_4));
 	std::string output4 = handler.handleRequest("gppr", "", input4, nullptr);
 	std::vector<std::string> entries4 =
 		Utility::splitStringOn(HTTPStatusCodes::getMessage(output4), ENTRY_DELIMITER_CHAR);
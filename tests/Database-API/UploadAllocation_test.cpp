@@ -0,0 +1,99 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "Definitions.h"
+#include "RequestHandler.h"
+#include "DatabaseMock.cpp"
+#include "StatisticsMock.cpp"
+#include "JDDatabaseMock.cpp"
+#include "HTTPStatus.h"
+#include "md5/md5.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <gtest/gtest.h>
+
+// The bytes allocated with new while counting is turned on, by the threads which count their allocations: the test
+// thread and the upload threads. Allocations by other threads, like those of earlier tests still running, are ignored.
+static std::atomic<bool> countAllocations(false);
+static thread_local bool countThreadAllocations = false;
+static std::atomic<long long> allocatedBytes(0);
+
+void *operator new(size_t size)
+{
+	if (countThreadAllocations && countAllocations)
+	{
+		allocatedBytes += size;
+	}
+	void *pointer = std::malloc(size == 0 ? 1 : size);
+	if (pointer == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void operator delete(void *pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t size) noexcept
+{
+	std::free(pointer);
+}
+
+/// <summary>
+/// Creates an upload request of a new project with the given amount of methods, each with their own author.
+/// </summary>
+std::string uploadRequest(int methods)
+{
+	std::string request = "1?1?42ea965b1f326f878bebcda51c7fb4b2?MyLicense?MyProject?MyUrl?Owner?owner@mail.com?1\n\n";
+	for (int i = 0; i < methods; i++)
+	{
+		std::string number = std::to_string(i);
+		request += "\n" + md5(number) + "?Method" + number + "?MyProject/File" + number + ".cpp?" + number +
+				   "?1?Author " + number + "?author" + number + "@mail.com";
+	}
+	return request;
+}
+
+/// <summary>
+/// Returns the amount of bytes allocated while handling the upload request.
+/// </summary>
+long long uploadBytes(const std::string &request)
+{
+	MockJDDatabase jddatabase;
+	MockStatistics stats;
+	testing::NiceMock<MockDatabase> database;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, nullptr, &stats);
+	ON_CALL(database, addProject(testing::_)).WillByDefault(testing::Return(true));
+
+	// The upload threads count their allocations from the first method they upload on.
+	ON_CALL(database, addMethod(testing::_, testing::_, testing::_, testing::_, testing::_))
+		.WillByDefault(testing::InvokeWithoutArgs([]() { countThreadAllocations = true; }));
+
+	errno = 0;
+	allocatedBytes = 0;
+	countThreadAllocations = true;
+	countAllocations = true;
+	std::string result = handler.handleRequest("upld", "", request, nullptr);
+	countAllocations = false;
+	countThreadAllocations = false;
+	EXPECT_EQ(result, HTTPStatusCodes::success("Your project has been successfully added to the database."));
+	return allocatedBytes;
+}
+
+// Test if the project, which holds the hashes of all methods, is not copied for each method it is uploaded with.
+// Such copies would make the bytes allocated grow quadratically with the amount of methods.
+TEST(UploadAllocationTests, NoProjectCopyPerMethod)
+{
+	long long smallUpload = uploadBytes(uploadRequest(1000));
+	long long largeUpload = uploadBytes(uploadRequest(2000));
+	EXPECT_LT(largeUpload, 2.5 * smallUpload);
+}
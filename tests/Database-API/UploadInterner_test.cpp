@@ -0,0 +1,44 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "UploadInterner.h"
+
+#include <gtest/gtest.h>
+
+// Test if an author occurring multiple times is only kept once, and gets the same ID as from the Author constructor.
+TEST(UploadInternerTests, Authors)
+{
+	std::string request = "Alice?alice@mail.com?Bob?bob@mail.com?Alice?alice@mail.com";
+	std::string_view view = request;
+	UploadInterner interner;
+
+	std::vector<MethodIn> methods(2);
+	methods[0].authors.push_back(interner.addAuthor(view.substr(0, 5), view.substr(6, 14)));
+	methods[0].authors.push_back(interner.addAuthor(view.substr(21, 3), view.substr(25, 12)));
+	methods[1].authors.push_back(interner.addAuthor(view.substr(38, 5), view.substr(44, 14)));
+	EXPECT_EQ(methods[1].authors[0].id, "");
+
+	interner.hashAuthors();
+	interner.setAuthorIDs(methods);
+	ASSERT_EQ(interner.getAuthors().size(), 2);
+	EXPECT_EQ(interner.getAuthors()[1].name, "Bob");
+	EXPECT_EQ(methods[0].authors[0].id, Author("Alice", "alice@mail.com").id);
+	EXPECT_EQ(methods[0].authors[1].id, Author("Bob", "bob@mail.com").id);
+	EXPECT_EQ(methods[1].authors[0].id, Author("Alice", "alice@mail.com").id);
+}
+
+// Test if the occurrences of each file are counted.
+TEST(UploadInternerTests, Files)
+{
+	UploadInterner interner;
+	interner.countFile("src/main.cpp");
+	interner.countFile("src/util.cpp");
+	interner.countFile("src/main.cpp");
+
+	ASSERT_EQ(interner.getFiles().size(), 2);
+	EXPECT_EQ(interner.getFiles().at("src/main.cpp"), 2);
+	EXPECT_EQ(interner.getFiles().at("src/util.cpp"), 1);
+}
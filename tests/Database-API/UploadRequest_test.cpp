@@ -13,10 +13,12 @@ Utrecht University within the Software Project course.
 #include "Utility.h"
 
 #include <gtest/gtest.h>
+#include <set>
 #include <vector>
 
 // Test input part 1:
 Author owner("Owner", "owner@mail.com");
+std::string ownerID = "d7e13955b03558d79aa2f3add11f8fd5";
 std::vector<Hash> hashes = {"a6aa62503e2ca3310e3a837502b80df5", "f3a258ba6cd26c1b7d553a493c614104",
 							"59bf62494932580165af0451f76be3e9"};
 ProjectIn projectT1 = {.projectID = 0,
@@ -48,6 +50,8 @@ MethodIn methodT1_3 = {.hash = "59bf62494932580165af0451f76be3e9",
 Author author1("Author 1", "author1@mail.com");
 Author author2("Author 2", "author2@mail.com");
 Author author3("Author 3", "author3@mail.com");
+std::vector<std::string> authorIDsT2 = {ownerID, "d4394dae094c5dde45990f908f05cc44", "8d7ff3c232dede7d70cf03cc0746b3dc",
+										"a5e9b86db128f9b263a0d8c22a16eae3"};
 ProjectIn projectT2 = {.projectID = 398798723,
 					   .version = 1618222334,
 					   .versionHash = "05a647eeb4954187fa5ac00942054cdc",
@@ -86,6 +90,17 @@ MATCHER_P(projectEqual, project, "")
 		&& arg.parserVersion == project.parserVersion;
 }
 
+// Checks if the authors have the given ids, in any order and ignoring duplicates.
+MATCHER_P(authorIDsEqual, ids, "")
+{
+	std::set<std::string> argIDs;
+	for (const Author &author : arg)
+	{
+		argIDs.insert(author.id);
+	}
+	return argIDs == std::set<std::string>(ids.begin(), ids.end());
+}
+
 // Checks if two methods are equal. I.e., they have the same contents.
 MATCHER_P(methodEqual, method, "")
 {
@@ -124,6 +139,7 @@ TEST(UploadRequest, SingleMethodSingleAuthor)
 	std::string request(requestChars.begin(), requestChars.end());
 
 	EXPECT_CALL(database, addProject(projectEqual(projectT1))).WillOnce(testing::Return(true));
+	EXPECT_CALL(database, addAuthors(authorIDsEqual(std::vector<std::string>({ownerID})))).Times(1);
 	EXPECT_CALL(database, addMethod(methodEqual(methodT1_1), projectEqual(projectT1), -1, 1, true)).Times(1);
 
 	// Check if the output is as expected.
@@ -168,6 +184,7 @@ TEST(UploadRequest, MultipleMethodsSingleAuthor)
 	std::string request(requestChars.begin(), requestChars.end());
 
 	EXPECT_CALL(database, addProject(projectEqual(projectT1))).WillOnce(testing::Return(true));
+	EXPECT_CALL(database, addAuthors(authorIDsEqual(std::vector<std::string>({ownerID})))).Times(1);
 	EXPECT_CALL(database, addMethod(methodEqual(methodT1_1), projectEqual(projectT1), -1, 1, true)).Times(1);
 	EXPECT_CALL(database, addMethod(methodEqual(methodT1_2), projectEqual(projectT1), -1, 1, true)).Times(1);
 	EXPECT_CALL(database, addMethod(methodEqual(methodT1_3), projectEqual(projectT1), -1, 1, true)).Times(1);
@@ -214,6 +231,7 @@ TEST(UploadRequest, MultipleMethodsMultipleAuthors)
 	std::string request(requestChars.begin(), requestChars.end());
 
 	EXPECT_CALL(database, addProject(projectEqual(projectT2))).WillOnce(testing::Return(true));
+	EXPECT_CALL(database, addAuthors(authorIDsEqual(authorIDsT2))).Times(1);
 	EXPECT_CALL(database, addMethod(methodEqual(methodT2_1), projectEqual(projectT2), -1, 1, true)).Times(1);
 	EXPECT_CALL(database, addMethod(methodEqual(methodT2_2), projectEqual(projectT2), -1, 1, true)).Times(1);
 	EXPECT_CALL(database, addMethod(methodEqual(methodT2_3), projectEqual(projectT2), -1, 1, true)).Times(1);
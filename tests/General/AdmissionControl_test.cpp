@@ -0,0 +1,129 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "AdmissionControl.h"
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#define ADMISSION_TEST_FILE "admissionTestfile.txt"
+
+// Tests if a client is rejected after using up its burst, without affecting other clients or request types.
+TEST(AdmissionControl, Burst)
+{
+	std::ofstream file(ADMISSION_TEST_FILE);
+	file << "RATE_LIMIT=chck,1,3" << std::endl;
+	file.close();
+	AdmissionControl admission(ADMISSION_TEST_FILE);
+	std::remove(ADMISSION_TEST_FILE);
+
+	long long retryAfter = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		EXPECT_EQ(admission.admit("scanner", "chck", retryAfter), eAdmitted);
+		admission.release();
+	}
+	EXPECT_EQ(admission.admit("scanner", "chck", retryAfter), eRateLimited);
+	EXPECT_GT(retryAfter, 0);
+	EXPECT_LE(retryAfter, 1000);
+
+	EXPECT_EQ(admission.admit("spider", "chck", retryAfter), eAdmitted);
+	admission.release();
+	EXPECT_EQ(admission.admit("scanner", "upld", retryAfter), eAdmitted);
+	admission.release();
+}
+
+// Tests if requests are rejected when too many are handled at the same time.
+TEST(AdmissionControl, MaxInFlight)
+{
+	std::ofstream file(ADMISSION_TEST_FILE);
+	file << "MAX_IN_FLIGHT=2" << std::endl;
+	file.close();
+	AdmissionControl admission(ADMISSION_TEST_FILE);
+	std::remove(ADMISSION_TEST_FILE);
+
+	long long retryAfter = 0;
+	EXPECT_EQ(admission.admit("a", "gtjb", retryAfter), eAdmitted);
+	EXPECT_EQ(admission.admit("b", "gtjb", retryAfter), eAdmitted);
+	EXPECT_EQ(admission.admit("c", "gtjb", retryAfter), eOverloaded);
+	EXPECT_EQ(retryAfter, OVERLOAD_RETRY_AFTER);
+
+	admission.release();
+	EXPECT_EQ(admission.admit("c", "gtjb", retryAfter), eAdmitted);
+}
+
+// Tests if the longest idle bucket is forgotten once there are too many, while a recently used one is kept.
+TEST(AdmissionControl, ForgetsIdleBuckets)
+{
+	std::ofstream file(ADMISSION_TEST_FILE);
+	file << "RATE_LIMIT=chck,0,1" << std::endl;
+	file.close();
+	AdmissionControl admission(ADMISSION_TEST_FILE);
+	std::remove(ADMISSION_TEST_FILE);
+
+	long long retryAfter = 0;
+	EXPECT_EQ(admission.admit("idle", "chck", retryAfter), eAdmitted);
+	admission.release();
+	EXPECT_EQ(admission.admit("busy", "chck", retryAfter), eAdmitted);
+	admission.release();
+	for (int i = 0; i < ADMISSION_MAX_BUCKETS - 2; i++)
+	{
+		EXPECT_EQ(admission.admit(std::to_string(i), "chck", retryAfter), eAdmitted);
+		admission.release();
+	}
+
+	// Using the bucket of busy again makes idle the longest idle one, which is forgotten for the next new bucket.
+	EXPECT_EQ(admission.admit("busy", "chck", retryAfter), eRateLimited);
+	EXPECT_EQ(admission.admit("new", "chck", retryAfter), eAdmitted);
+	admission.release();
+	EXPECT_EQ(admission.admit("idle", "chck", retryAfter), eAdmitted);
+	admission.release();
+	EXPECT_EQ(admission.admit("new", "chck", retryAfter), eRateLimited);
+}
+
+// Tests if an admitted request is released when handling it throws.
+TEST(AdmissionControl, ReleaseOnThrow)
+{
+	std::ofstream file(ADMISSION_TEST_FILE);
+	file << "MAX_IN_FLIGHT=1" << std::endl;
+	file.close();
+	AdmissionControl admission(ADMISSION_TEST_FILE);
+	std::remove(ADMISSION_TEST_FILE);
+
+	long long retryAfter = 0;
+	EXPECT_EQ(admission.admit("a", "gtjb", retryAfter), eAdmitted);
+	try
+	{
+		AdmittedRequest admitted(admission);
+		throw std::runtime_error("Handling failed.");
+	}
+	catch (const std::runtime_error &)
+	{
+	}
+	EXPECT_EQ(admission.admit("a", "gtjb", retryAfter), eAdmitted);
+}
+
+// Tests if a request which was already charged by another node is not charged again, but still counts as in flight.
+TEST(AdmissionControl, Uncharged)
+{
+	std::ofstream file(ADMISSION_TEST_FILE);
+	file << "RATE_LIMIT=chck,1,1" << std::endl;
+	file << "MAX_IN_FLIGHT=2" << std::endl;
+	file.close();
+	AdmissionControl admission(ADMISSION_TEST_FILE);
+	std::remove(ADMISSION_TEST_FILE);
+
+	long long retryAfter = 0;
+	EXPECT_EQ(admission.admit("a", "chck", retryAfter, false), eAdmitted);
+	EXPECT_EQ(admission.admit("a", "chck", retryAfter), eAdmitted);
+	EXPECT_EQ(admission.admit("a", "chck", retryAfter, false), eOverloaded);
+
+	admission.release();
+	admission.release();
+	EXPECT_EQ(admission.admit("a", "chck", retryAfter), eRateLimited);
+}
@@ -0,0 +1,121 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "ConnectionHandler.h"
+#include "HTTPStatus.h"
+#include "Networking.h"
+#include "StatisticsMock.cpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+/// <summary>
+/// Accepts a single connection on a free local port and lets a TcpConnection handle it.
+/// </summary>
+class SingleConnectionServer
+{
+public:
+	SingleConnectionServer() : acceptor(ioContext, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0))
+	{
+		port = std::to_string(acceptor.local_endpoint().port());
+		thread = std::thread(
+			[this]()
+			{
+				TcpConnection::pointer connection = TcpConnection::create(ioContext);
+				acceptor.accept(connection->socket());
+				connection->start(&handler, connection, &stats);
+				finished = true;
+			});
+	}
+
+	~SingleConnectionServer()
+	{
+		thread.join();
+	}
+
+	std::string port;
+	std::atomic<bool> finished{false};
+
+private:
+	boost::asio::io_context ioContext;
+	tcp::acceptor acceptor;
+	RequestHandler handler;
+	MockStatistics stats;
+	std::thread thread;
+};
+
+// Test if a connection without keep-alive is closed after the response.
+TEST(ConnectionHandlerTests, SingleRequest)
+{
+	SingleConnectionServer server;
+
+	NetworkHandler *handler = NetworkHandler::createHandler();
+	handler->openConnection("127.0.0.1", server.port);
+	handler->sendData("kill?client?0\n");
+
+	EXPECT_EQ(handler->receiveData(false), HTTPStatusCodes::clientError("Unknown request type."));
+	delete handler;
+}
+
+// Test if pipelined requests on a kept open connection get their responses in order.
+TEST(ConnectionHandlerTests, KeepAlive)
+{
+	SingleConnectionServer server;
+	std::string response = HTTPStatusCodes::clientError("Unknown request type.");
+
+	NetworkHandler *handler = NetworkHandler::createHandler();
+	handler->openConnection("127.0.0.1", server.port);
+	handler->sendData("kill?client?0?keep-alive\nkill?client?3?keep-alive\nabc");
+	for (int i = 0; i < 2; i++)
+	{
+		EXPECT_EQ(handler->receiveData(), std::to_string(response.size()));
+		EXPECT_EQ(handler->receiveExpectedData(response.size()), response);
+	}
+
+	// The connection stays open for the next request.
+	handler->sendData("kill?client?0?keep-alive\n");
+	EXPECT_EQ(handler->receiveData(), std::to_string(response.size()));
+	EXPECT_EQ(handler->receiveExpectedData(response.size()), response);
+	delete handler;
+}
+
+// Test if the response to a malformed request comes after the responses to the pipelined requests before it.
+TEST(ConnectionHandlerTests, MalformedAfterPipelined)
+{
+	SingleConnectionServer server;
+	std::string response = HTTPStatusCodes::clientError("Unknown request type.");
+	std::string error = HTTPStatusCodes::clientError("Header too short.");
+
+	NetworkHandler *handler = NetworkHandler::createHandler();
+	handler->openConnection("127.0.0.1", server.port);
+	handler->sendData("kill?client?0?keep-alive\nkill?client\n");
+	EXPECT_EQ(handler->receiveData(), std::to_string(response.size()));
+	EXPECT_EQ(handler->receiveExpectedData(response.size()), response);
+	EXPECT_EQ(handler->receiveData(), std::to_string(error.size()));
+	EXPECT_EQ(handler->receiveExpectedData(error.size()), error);
+	delete handler;
+}
+
+// Test if the connection is given up when the client stops sending in the middle of a request.
+TEST(ConnectionHandlerTests, IdleDuringRequest)
+{
+	SingleConnectionServer server;
+
+	NetworkHandler *handler = NetworkHandler::createHandler();
+	handler->openConnection("127.0.0.1", server.port);
+	handler->sendData("kill?client?3\nab");
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(2 * CONNECTION_TIMEOUT);
+	while (!server.finished && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+	EXPECT_TRUE(server.finished);
+	delete handler;
+}
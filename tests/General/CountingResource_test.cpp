@@ -0,0 +1,28 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "CountingResource.h"
+
+#include <gtest/gtest.h>
+#include <string_view>
+#include <vector>
+
+// Test if the allocations below an arena are counted, and if the arena takes few of them.
+TEST(CountingResourceTests, Arena)
+{
+	CountingResource heap;
+	{
+		std::pmr::monotonic_buffer_resource arena(&heap);
+		std::pmr::vector<std::pmr::vector<std::string_view>> lines(&arena);
+		for (int i = 0; i < 1000; i++)
+		{
+			lines.emplace_back(4, std::string_view("field"));
+		}
+	}
+	EXPECT_GT(heap.getAllocations(), 0);
+	EXPECT_LT(heap.getAllocations(), 50);
+	EXPECT_GE(heap.getBytes(), 1000 * 4 * sizeof(std::string_view));
+}
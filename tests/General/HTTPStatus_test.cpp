@@ -124,4 +124,14 @@ TEST(HTTPgetMessage, noCode)
 	std::string request = std::string("200") + ENTRY_DELIMITER_CHAR + message;
 
 	EXPECT_EQ(HTTPStatusCodes::getMessage(request), message);
-}
\ No newline at end of file
+}
+
+// Check if too many requests status codes put the time to wait in front of the message.
+TEST(HTTPtooManyRequestsMessage, regularString)
+{
+	std::string message = "This is a normal message.";
+	std::string expected = std::string("429") + ENTRY_DELIMITER_CHAR + "1000" + FIELD_DELIMITER_CHAR + message;
+
+	EXPECT_EQ(HTTPStatusCodes::tooManyRequests(message, 1000), expected);
+	EXPECT_EQ(HTTPStatusCodes::getCode(expected), "429");
+}
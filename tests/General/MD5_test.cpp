@@ -0,0 +1,30 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "md5/md5.h"
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+// Test if hashing in a batch gives the same digests as hashing one by one, also around the block boundaries.
+TEST(MD5Tests, Batch)
+{
+	std::vector<std::string> inputs = {"", "Alice alice@mail.com", std::string(55, 'a'), std::string(56, 'a'),
+									   std::string(64, 'a'), std::string(119, 'a'), std::string(120, 'a'),
+									   std::string(300, 'b'), "Bob bob@mail.com"};
+	std::vector<std::string_view> views(inputs.begin(), inputs.end());
+	unsigned char digests[9][16];
+	md5Batch(views.data(), views.size(), digests);
+
+	for (int i = 0; i < inputs.size(); i++)
+	{
+		unsigned char expected[16];
+		MD5(inputs[i]).copyDigest(expected);
+		EXPECT_EQ(std::memcmp(digests[i], expected, 16), 0) << "Input " << i;
+	}
+	EXPECT_EQ(md5(""), "d41d8cd98f00b204e9800998ecf8427e");
+}
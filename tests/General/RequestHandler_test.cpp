@@ -8,9 +8,12 @@ Utrecht University within the Software Project course.
 #include "DatabaseMock.cpp"
 #include "HTTPStatus.h"
 #include "JDDatabaseMock.cpp"
+#include "RaftConsensusMock.cpp"
 #include "RAFTConsensus.h"
 #include "DatabaseConnection.h"
 
+#include <atomic>
+#include <thread>
 #include <gtest/gtest.h>
 
 // Tests if the RequestHandler requests to connect to the database when initialized.
@@ -37,3 +40,124 @@ TEST(GeneralTest, UnknownRequest)
 
 	EXPECT_EQ(handler.handleRequest("kill", "", "", nullptr), HTTPStatusCodes::clientError("Unknown request type."));
 }
+
+// Tests if a full lane only holds back requests of that lane.
+TEST(GeneralTest, FullLane)
+{
+	// Set up the test.
+	errno = 0;
+
+	RequestHandler handler;
+	MockDatabase database;
+	MockJDDatabase jddatabase;
+	MockRaftConsensus raftConsensus;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	for (int i = 0; i < ANALYTICS_LANE_SLOTS; i++)
+	{
+		handler.enterLane(eAnalyticsLane);
+	}
+
+	// A job request is handled right away.
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+	std::vector<std::string> ip = {"127.0.0.1" + fieldDelimiter + "-1"};
+	EXPECT_CALL(raftConsensus, isLeader()).WillOnce(testing::Return(true));
+	EXPECT_CALL(raftConsensus, getCurrentIPs()).WillOnce(testing::Return(ip));
+	EXPECT_EQ(handler.handleRequest("gtip", "", "", nullptr),
+			  HTTPStatusCodes::success("127.0.0.1" + fieldDelimiter + "-1" + entryDelimiter));
+
+	// An analytics request waits until a place in its lane is given up.
+	std::atomic<bool> handled(false);
+	std::thread analytics([&handler, &handled]() {
+		handler.handleRequest("extp", "", "", nullptr);
+		handled = true;
+	});
+	usleep(100000);
+	EXPECT_FALSE(handled);
+
+	handler.leaveLane(eAnalyticsLane);
+	analytics.join();
+	EXPECT_TRUE(handled);
+}
+
+// Tests if the place in a lane is given up when handling a request throws.
+TEST(GeneralTest, ThrowingRequestLeavesLane)
+{
+	// Set up the test.
+	errno = 0;
+
+	RequestHandler handler;
+	MockDatabase database;
+	MockJDDatabase jddatabase;
+	MockRaftConsensus raftConsensus;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	EXPECT_CALL(raftConsensus, isLeader())
+		.Times(JOB_LANE_SLOTS)
+		.WillRepeatedly(testing::Throw(std::runtime_error("Lost the leader.")));
+	for (int i = 0; i < JOB_LANE_SLOTS; i++)
+	{
+		EXPECT_THROW(handler.handleRequest("gtip", "", "", nullptr), std::runtime_error);
+	}
+
+	// All places are free again, so another request of the lane does not have to wait.
+	std::atomic<bool> handled(false);
+	std::thread job([&handler, &handled]() {
+		handler.enterLane(eJobLane);
+		handled = true;
+		handler.leaveLane(eJobLane);
+	});
+	usleep(100000);
+	EXPECT_TRUE(handled);
+	if (!handled)
+	{
+		handler.leaveLane(eJobLane);
+	}
+	job.join();
+}
+
+// Tests if a request is rejected right away when too many requests are waiting for its lane already.
+TEST(GeneralTest, FullLaneQueue)
+{
+	// Set up the test.
+	errno = 0;
+
+	RequestHandler handler;
+	MockDatabase database;
+	MockJDDatabase jddatabase;
+	MockRaftConsensus raftConsensus;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	for (int i = 0; i < ANALYTICS_LANE_SLOTS; i++)
+	{
+		ASSERT_TRUE(handler.enterLane(eAnalyticsLane));
+	}
+	std::atomic<int> entered(0);
+	std::vector<std::thread> waiting;
+	for (int i = 0; i < ANALYTICS_LANE_QUEUE; i++)
+	{
+		waiting.push_back(std::thread([&handler, &entered]() {
+			if (handler.enterLane(eAnalyticsLane))
+			{
+				entered++;
+				handler.leaveLane(eAnalyticsLane);
+			}
+		}));
+	}
+	usleep(100000);
+
+	EXPECT_EQ(handler.handleRequest("extp", "", "", nullptr),
+			  HTTPStatusCodes::tooManyRequests("Too many requests of this type waiting.", LANE_RETRY_AFTER));
+
+	// The waiting requests all get a place once the lane is given up.
+	for (int i = 0; i < ANALYTICS_LANE_SLOTS; i++)
+	{
+		handler.leaveLane(eAnalyticsLane);
+	}
+	for (std::thread &thread : waiting)
+	{
+		thread.join();
+	}
+	EXPECT_EQ(entered, ANALYTICS_LANE_QUEUE);
+}
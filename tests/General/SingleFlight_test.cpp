@@ -0,0 +1,85 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "SingleFlight.h"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+// Test if concurrent calls for the same key share one call, including its errno.
+TEST(SingleFlightTests, ConcurrentCalls)
+{
+	SingleFlight<std::string, int> singleFlight;
+	std::atomic<int> calls(0);
+	std::atomic<bool> release(false);
+	std::function<int()> function = [&calls, &release]()
+	{
+		calls++;
+		while (!release)
+		{
+			usleep(1000);
+		}
+		errno = ERANGE;
+		return 42;
+	};
+
+	bool firstShared;
+	int firstResult;
+	int firstErrno;
+	std::thread first([&]()
+	{
+		firstResult = singleFlight.call("hash", function, firstShared);
+		firstErrno = errno;
+	});
+	while (calls == 0)
+	{
+		usleep(1000);
+	}
+
+	bool secondShared;
+	int secondResult;
+	int secondErrno;
+	std::thread second([&]()
+	{
+		secondResult = singleFlight.call("hash", function, secondShared);
+		secondErrno = errno;
+	});
+	usleep(50000);
+	release = true;
+	first.join();
+	second.join();
+
+	EXPECT_EQ(calls, 1);
+	EXPECT_FALSE(firstShared);
+	EXPECT_TRUE(secondShared);
+	EXPECT_EQ(firstResult, 42);
+	EXPECT_EQ(secondResult, 42);
+	EXPECT_EQ(firstErrno, ERANGE);
+	EXPECT_EQ(secondErrno, ERANGE);
+}
+
+// Test if calls for the same key after the first one has finished, or for other keys, are done themselves.
+TEST(SingleFlightTests, SeparateCalls)
+{
+	SingleFlight<std::string, int> singleFlight;
+	int calls = 0;
+	std::function<int()> function = [&calls]()
+	{
+		errno = 0;
+		return ++calls;
+	};
+
+	bool shared;
+	EXPECT_EQ(singleFlight.call("a", function, shared), 1);
+	EXPECT_FALSE(shared);
+	EXPECT_EQ(singleFlight.call("a", function, shared), 2);
+	EXPECT_FALSE(shared);
+	EXPECT_EQ(singleFlight.call("b", function, shared), 3);
+	EXPECT_FALSE(shared);
+}
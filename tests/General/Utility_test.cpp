@@ -225,6 +225,19 @@ TEST(CheckStringSplit, EndSplit)
 	ASSERT_EQ(output[0], "line1");
 }
 
+// Checks if splitting without copying gives the same substrings as splitStringOn.
+TEST(CheckStringSplit, ViewSplit)
+{
+	std::vector<std::string> inputs = {"", "line1", "line1\n\nline2", "\nline2", "line1\n", "line1\n\n", "\n"};
+	for (std::string input : inputs)
+	{
+		std::pmr::vector<std::string_view> output;
+		Utility::splitStringOn(input, '\n', output);
+		std::vector<std::string> expected = Utility::splitStringOn(input, '\n');
+		ASSERT_EQ(std::vector<std::string>(output.begin(), output.end()), expected);
+	}
+}
+
 // Checks if hashToUUIDString correctly changes a hash to 
 // a UUID string when the input hash is correct.
 TEST(CheckStringConversion, correctHashToUUID)
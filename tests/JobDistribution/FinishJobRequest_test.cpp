@@ -61,8 +61,8 @@ TEST(FinishJobRequest, Success)
 	EXPECT_CALL(jddatabase, getCurrentJobTime(job.jobid)).WillOnce(testing::Return(job.time));
 	EXPECT_CALL(jddatabase, getCurrentJob(job.jobid)).WillOnce(testing::Return(job));
 	
-	EXPECT_CALL(jddatabase, addFailedJob(testing::_)).Times(0);
-	EXPECT_CALL(jddatabase, uploadJob(testing::_, testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, testing::_)).Times(0);
 
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
 
@@ -99,13 +99,69 @@ TEST(FinishJobRequest, Failure)
 
 	FailedJob failedJob = FailedJob(job, 11, "Error downloading project.");
 
-	EXPECT_CALL(jddatabase, addFailedJob(failedjobequal(failedJob))).Times(1);
-	job.retries++;
-	EXPECT_CALL(jddatabase, uploadJob(jobequal(job), false)).Times(1);
+	// The failed job is only written by the job writer.
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, testing::_)).Times(0);
 
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
 
 	ASSERT_EQ(result, HTTPStatusCodes::success("Job failed succesfully."));
+	testing::Mock::VerifyAndClearExpectations(&jddatabase);
+
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::ElementsAre(failedjobequal(failedJob))))
+		.WillOnce(testing::Return(std::vector<int>()));
+	job.retries++;
+	EXPECT_CALL(jddatabase, uploadJobs(testing::ElementsAre(jobequal(job)), false))
+		.WillOnce(testing::Return(std::vector<int>()));
+	EXPECT_CALL(jddatabase, deleteCurrentJobs(testing::_)).Times(0);
+
+	handler.getJobRequestHandler()->writeFinishedJobs();
+}
+
+TEST(FinishJobRequest, FinishInMemory)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockStatistics stats;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+
+	handler.initialize(&database, &jddatabase, &raftConsensus, &stats);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+
+	Job job;
+	job.jobid = "58451e62-1794-4f03-8ae4-21fb42670f73";
+	job.time = Utility::getCurrentTimeMilliSeconds();
+	job.timeout = 100000;
+	job.priority = 100;
+	job.retries = 0;
+	job.url = "https://github.com/zavg/linux-0.01";
+
+	// Hand out the job.
+	EXPECT_CALL(raftConsensus, isLeader()).WillRepeatedly(testing::Return(true));
+	EXPECT_CALL(jddatabase, getNumberOfJobs()).WillRepeatedly(testing::Return(550));
+	EXPECT_CALL(jddatabase, getTopJob()).WillOnce(testing::Return(job));
+	handler.handleRequest("gtjb", "", "", nullptr);
+
+	// Finish the job, without going to the database.
+	EXPECT_CALL(jddatabase, getCurrentJobTime(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, getCurrentJob(testing::_)).Times(0);
+	std::string result = handler.handleRequest(
+		"fnjb", "", job.jobid + fieldDelimiter + std::to_string(job.time) + fieldDelimiter + "0" + fieldDelimiter + "Success.",
+		nullptr);
+	ASSERT_EQ(result, HTTPStatusCodes::success("Job finished succesfully."));
+
+	// The job is removed from the currentjobs table by the job writer.
+	EXPECT_CALL(jddatabase, deleteCurrentJobs(testing::ElementsAre(job.jobid)))
+		.WillOnce(testing::Return(std::vector<int>()));
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, testing::_)).Times(0);
+	handler.getJobRequestHandler()->writeFinishedJobs();
+	handler.getJobRequestHandler()->writeFinishedJobs();
 }
 
 TEST(FinishJobRequest, DeficientArguments)
@@ -136,8 +192,8 @@ TEST(FinishJobRequest, DeficientArguments)
 	EXPECT_CALL(jddatabase, getCurrentJobTime(testing::_)).Times(0);
 	EXPECT_CALL(jddatabase, getCurrentJob(testing::_)).Times(0);
 
-	EXPECT_CALL(jddatabase, addFailedJob(testing::_)).Times(0);
-	EXPECT_CALL(jddatabase, uploadJob(testing::_, testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, testing::_)).Times(0);
 
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
 
@@ -172,8 +228,8 @@ TEST(FinishJobRequest, IncorrectJobTime)
 	EXPECT_CALL(jddatabase, getCurrentJobTime(testing::_)).Times(0);
 	EXPECT_CALL(jddatabase, getCurrentJob(testing::_)).Times(0);
 
-	EXPECT_CALL(jddatabase, addFailedJob(testing::_)).Times(0);
-	EXPECT_CALL(jddatabase, uploadJob(testing::_, testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, testing::_)).Times(0);
 
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
 
@@ -208,8 +264,8 @@ TEST(FinishJobRequest, IncorrectReasonID)
 	EXPECT_CALL(jddatabase, getCurrentJobTime(testing::_)).Times(0);
 	EXPECT_CALL(jddatabase, getCurrentJob(testing::_)).Times(0);
 
-	EXPECT_CALL(jddatabase, addFailedJob(testing::_)).Times(0);
-	EXPECT_CALL(jddatabase, uploadJob(testing::_, testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, testing::_)).Times(0);
 
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
 
@@ -236,8 +292,8 @@ TEST(FinishJobRequest, UnknownJob)
 	EXPECT_CALL(jddatabase, getCurrentJobTime("58451e62-1794-4f03-8ae4-21fb42670f73")).WillOnce(testing::Return(-1));
 	EXPECT_CALL(jddatabase, getCurrentJob(testing::_)).Times(0);
 	
-	EXPECT_CALL(jddatabase, addFailedJob(testing::_)).Times(0);
-	EXPECT_CALL(jddatabase, uploadJob(testing::_, testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, testing::_)).Times(0);
 
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
 
@@ -264,8 +320,8 @@ TEST(FinishJobRequest, EarlyJob)
 	EXPECT_CALL(jddatabase, getCurrentJobTime("58451e62-1794-4f03-8ae4-21fb42670f73")).WillOnce(testing::Return(0));
 	EXPECT_CALL(jddatabase, getCurrentJob(testing::_)).Times(0);
 	
-	EXPECT_CALL(jddatabase, addFailedJob(testing::_)).Times(0);
-	EXPECT_CALL(jddatabase, uploadJob(testing::_, testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, testing::_)).Times(0);
 
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
 
@@ -292,8 +348,8 @@ TEST(FinishJobRequest, LateJob)
 	EXPECT_CALL(jddatabase, getCurrentJobTime("58451e62-1794-4f03-8ae4-21fb42670f73")).WillOnce(testing::Return(2));
 	EXPECT_CALL(jddatabase, getCurrentJob(testing::_)).Times(0);
 	
-	EXPECT_CALL(jddatabase, addFailedJob(testing::_)).Times(0);
-	EXPECT_CALL(jddatabase, uploadJob(testing::_, testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, testing::_)).Times(0);
 
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
 
@@ -328,10 +384,17 @@ TEST(FinishJobRequest, FailedJobFailure)
 	EXPECT_CALL(jddatabase, getCurrentJobTime(job.jobid)).WillOnce(testing::Return(job.time));
 	EXPECT_CALL(jddatabase, getCurrentJob(job.jobid)).WillOnce(testing::Return(job));
 	
-	EXPECT_CALL(jddatabase, addFailedJob(failedjobequal(FailedJob(job, 10, "Project already known.")))).Times(MAX_RETRIES + 1).WillRepeatedly(setErrno(1));
-	EXPECT_CALL(jddatabase, uploadJob(testing::_, testing::_)).Times(0);
-
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
 
-	ASSERT_EQ(result, HTTPStatusCodes::serverError("Job could not be added to failed jobs list."));
+	ASSERT_EQ(result, HTTPStatusCodes::success("Job failed succesfully."));
+
+	// A failed write is tried again the next time, the job is not put back in the queue for this reason.
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::ElementsAre(failedjobequal(FailedJob(job, 10, "Project already known.")))))
+		.WillOnce(testing::Return(std::vector<int>({0})))
+		.WillOnce(testing::Return(std::vector<int>()));
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, testing::_)).Times(0);
+
+	handler.getJobRequestHandler()->writeFinishedJobs();
+	handler.getJobRequestHandler()->writeFinishedJobs();
+	handler.getJobRequestHandler()->writeFinishedJobs();
 }
\ No newline at end of file
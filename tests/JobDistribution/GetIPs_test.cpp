@@ -48,3 +48,30 @@ TEST(GetIPsRequest, SingleIP)
 	std::string input(inputChars.begin(), inputChars.end());
 	ASSERT_EQ(result, HTTPStatusCodes::success("127.0.0.1" + fieldDelimiter + "-1" + entryDelimiter));
 }
+
+// Test if a follower which recently heard from the leader returns the ips it knows of itself.
+TEST(GetIPsRequest, UpToDateFollower)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+
+	std::vector<std::string> ips = {"127.0.0.2" + fieldDelimiter + "8003", "127.0.0.1" + fieldDelimiter + "8003"};
+
+	EXPECT_CALL(raftConsensus, isLeader()).WillOnce(testing::Return(false));
+	EXPECT_CALL(raftConsensus, isUpToDate()).WillOnce(testing::Return(true));
+	EXPECT_CALL(raftConsensus, getCurrentIPs()).WillOnce(testing::Return(ips));
+	std::string result = handler.handleRequest("gtip", "", "", nullptr);
+
+	// Check if the output is correct.
+	ASSERT_EQ(result, HTTPStatusCodes::success(ips[0] + entryDelimiter + ips[1] + entryDelimiter));
+}
@@ -141,3 +141,27 @@ TEST(GetJobRequest, NoJobsTest)
 	// Check if the second output is correct.
 	ASSERT_EQ(result2, HTTPStatusCodes::success("NoJob"));
 }
+
+// Test if no job is returned when the queue turns out to be empty, while the amount of jobs said otherwise.
+TEST(GetJobRequest, OutdatedAmountTest)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+
+	EXPECT_CALL(jddatabase, getNumberOfJobs()).Times(2).WillRepeatedly(testing::Return(550));
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	EXPECT_CALL(jddatabase, getTopJob())
+		.WillOnce(testing::DoAll(testing::Assign(&errno, ERANGE), testing::Return(Job())));
+	EXPECT_CALL(raftConsensus, isLeader()).WillOnce(testing::Return(true));
+	std::string result = handler.handleRequest("gtjb", "", "", nullptr);
+
+	// Check if the output is correct.
+	ASSERT_EQ(result, HTTPStatusCodes::success("NoJob"));
+	EXPECT_EQ(jddatabase.getCachedNumberOfJobs(), 0);
+}
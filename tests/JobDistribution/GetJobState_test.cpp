@@ -0,0 +1,96 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "Definitions.h"
+#include "RequestHandler.h"
+#include "DatabaseMock.cpp"
+#include "JDDatabaseMock.cpp"
+#include "RaftConsensusMock.cpp"
+#include "HTTPStatus.h"
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+// Test if the leader returns the state of the job queue it knows of.
+TEST(GetJobStateRequest, Leader)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+	std::string time = std::to_string(Utility::getCurrentTimeMilliSeconds());
+
+	handler.getJobRequestHandler()->crawlID = 12;
+	jddatabase.setNumberOfJobs(42);
+	handler.getJobRequestHandler()->applyJobChanges(
+		{"J", "0", "-1", "H", "5d514d6e-2f23-fee7-b378-feda84ec123f", time, "100000"});
+
+	EXPECT_CALL(raftConsensus, isLeader()).WillOnce(testing::Return(true));
+	EXPECT_CALL(raftConsensus, passRequestToLeader(testing::_, testing::_, testing::_)).Times(0);
+	std::string result = handler.handleRequest("gtjs", "", "", nullptr);
+
+	ASSERT_EQ(result, HTTPStatusCodes::success("12" + fieldDelimiter + "42" + fieldDelimiter + "1" + entryDelimiter));
+}
+
+// Test if a follower which recently heard from the leader returns the job state received with the heartbeat.
+TEST(GetJobStateRequest, UpToDateFollower)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+	std::string time = std::to_string(Utility::getCurrentTimeMilliSeconds());
+
+	handler.getJobRequestHandler()->crawlID = 12;
+	handler.getJobRequestHandler()->applyJobChanges(
+		{"J", "42", "-1", "H", "5d514d6e-2f23-fee7-b378-feda84ec123f", time, "100000", "H",
+		 "6e514d6e-2f23-fee7-b378-feda84ec123f", time, "100000"});
+
+	EXPECT_CALL(raftConsensus, isLeader()).WillOnce(testing::Return(false));
+	EXPECT_CALL(raftConsensus, isUpToDate()).WillOnce(testing::Return(true));
+	EXPECT_CALL(raftConsensus, passRequestToLeader(testing::_, testing::_, testing::_)).Times(0);
+	std::string result = handler.handleRequest("gtjs", "", "", nullptr);
+
+	ASSERT_EQ(result, HTTPStatusCodes::success("12" + fieldDelimiter + "42" + fieldDelimiter + "2" + entryDelimiter));
+}
+
+// Test if a follower which did not receive the job state yet, or did not hear from the leader lately, passes the
+// request on to the leader.
+TEST(GetJobStateRequest, PassToLeader)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	EXPECT_CALL(raftConsensus, isLeader()).WillRepeatedly(testing::Return(false));
+	EXPECT_CALL(raftConsensus, isUpToDate()).WillOnce(testing::Return(true)).WillOnce(testing::Return(false));
+	EXPECT_CALL(raftConsensus, passRequestToLeader("gtjs", "", ""))
+		.Times(2)
+		.WillRepeatedly(testing::Return(HTTPStatusCodes::success("leader")));
+	EXPECT_EQ(handler.handleRequest("gtjs", "", "", nullptr), HTTPStatusCodes::success("leader"));
+
+	handler.getJobRequestHandler()->applyJobChanges({"J", "42", "-1"});
+	EXPECT_EQ(handler.handleRequest("gtjs", "", "", nullptr), HTTPStatusCodes::success("leader"));
+}
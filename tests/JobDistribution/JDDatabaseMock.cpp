@@ -6,6 +6,7 @@ Utrecht University within the Software Project course.
 
 #include "JobTypes.h"
 #include "DatabaseConnection.h"
+#include <set>
 #include <string>
 #include <gmock/gmock.h>
 
@@ -19,13 +20,21 @@ class MockJDDatabase : public DatabaseConnection
 public:
 	MOCK_METHOD(void, connect, (std::string ip, int port), ());
 	MOCK_METHOD(void, uploadJob, (Job job, bool newJob), ());
+	MOCK_METHOD(void, prepareNewJobs, (std::vector<Job> &jobs), ());
+	MOCK_METHOD(std::vector<int>, uploadJobs, (std::vector<Job> jobs, bool newJobs), ());
 	MOCK_METHOD(Job, getTopJob, (), ());
 	MOCK_METHOD(Job, getCurrentJob, (std::string jobid), ());
 	MOCK_METHOD(long long, getCurrentJobTime, (std::string jobid), ());
 	MOCK_METHOD(long long, addCurrentJob, (Job job), ());
+	MOCK_METHOD(std::vector<int>, renewCurrentJobs, (std::vector<Job> jobs), ());
 	MOCK_METHOD(void, addFailedJob, (FailedJob job), ());
+	MOCK_METHOD(std::vector<int>, addFailedJobs, (std::vector<FailedJob> jobs), ());
+	MOCK_METHOD(std::vector<int>, deleteCurrentJobs, (std::vector<std::string> jobids), ());
 	MOCK_METHOD(int, getNumberOfJobs, (), ());
 	MOCK_METHOD(int, getCrawlID, (), ());
 	MOCK_METHOD(void, setCrawlID, (int id), ());
+	MOCK_METHOD(std::vector<Job>, getTimedOutJobs, (const std::set<std::string> &liveJobs), ());
+	MOCK_METHOD(void, loadQueueHeads, (), ());
+	MOCK_METHOD(std::vector<std::string>, getQueuedUrls, (bool currentJobs, std::string &pagingState), ());
 };
 
@@ -0,0 +1,115 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "Definitions.h"
+#include "Networking.h"
+
+#include <boost/asio.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+/// <summary>
+/// Starts a server on a free local port which sends the given data to the first client and closes the connection.
+/// </summary>
+class SendOnceServer
+{
+public:
+	SendOnceServer(std::string data) : acceptor(ioContext, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0))
+	{
+		port = std::to_string(acceptor.local_endpoint().port());
+		thread = std::thread(
+			[this, data]()
+			{
+				tcp::socket socket(ioContext);
+				acceptor.accept(socket);
+				boost::asio::write(socket, boost::asio::buffer(data));
+				socket.close();
+			});
+	}
+
+	~SendOnceServer()
+	{
+		thread.join();
+	}
+
+	std::string port;
+
+private:
+	boost::asio::io_context ioContext;
+	tcp::acceptor acceptor;
+	std::thread thread;
+};
+
+// Test if multiple messages received in one go are returned one by one.
+TEST(NetworkingTests, MultipleMessagesOneRead)
+{
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+	SendOnceServer server("first" + entryDelimiter + "second" + entryDelimiter + "third" + entryDelimiter);
+
+	NetworkHandler *handler = NetworkHandler::createHandler();
+	handler->openConnection("127.0.0.1", server.port);
+
+	EXPECT_EQ(handler->receiveData(), "first");
+	EXPECT_EQ(handler->receiveData(), "second");
+	EXPECT_EQ(handler->receiveData(), "third");
+	delete handler;
+}
+
+// Test if a message larger than a single read is received completely.
+TEST(NetworkingTests, LargeMessage)
+{
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+	std::string message(5 * RECEIVE_CHUNK_SIZE + 3, 'a');
+	SendOnceServer server(message + entryDelimiter + "rest");
+
+	NetworkHandler *handler = NetworkHandler::createHandler();
+	handler->openConnection("127.0.0.1", server.port);
+
+	EXPECT_EQ(handler->receiveData(), message);
+	EXPECT_EQ(handler->receiveData(false), "rest");
+	delete handler;
+}
+
+// Test if reading until the connection closes returns everything, including new lines.
+TEST(NetworkingTests, ReadUntilClosed)
+{
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+	std::string message = "200" + entryDelimiter + "a" + entryDelimiter + "b" + entryDelimiter;
+	SendOnceServer server(message);
+
+	NetworkHandler *handler = NetworkHandler::createHandler();
+	handler->openConnection("127.0.0.1", server.port);
+
+	EXPECT_EQ(handler->receiveData(false), message);
+	delete handler;
+}
+
+// Test if a known amount of data can be read, followed by a normal message.
+TEST(NetworkingTests, ExpectedData)
+{
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+	SendOnceServer server("abc" + entryDelimiter + "defghi" + entryDelimiter);
+
+	NetworkHandler *handler = NetworkHandler::createHandler();
+	handler->openConnection("127.0.0.1", server.port);
+
+	EXPECT_EQ(handler->receiveExpectedData(5), "abc" + entryDelimiter + "d");
+	EXPECT_EQ(handler->receiveData(), "efghi");
+	delete handler;
+}
+
+// Test if an exception is thrown when the other side drops out before the message is complete.
+TEST(NetworkingTests, ConnectionDropped)
+{
+	SendOnceServer server("incomplete");
+
+	NetworkHandler *handler = NetworkHandler::createHandler();
+	handler->openConnection("127.0.0.1", server.port);
+
+	EXPECT_THROW(handler->receiveData(), boost::system::system_error);
+	delete handler;
+}
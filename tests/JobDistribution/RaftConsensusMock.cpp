@@ -19,7 +19,8 @@ public:
 	{
 	}
 	MOCK_METHOD(bool, isLeader, (), ());
-	MOCK_METHOD(std::string, passRequestToLeader, (std::string requestType, std::string request), ());
+	MOCK_METHOD(bool, isUpToDate, (), ());
+	MOCK_METHOD(std::string, passRequestToLeader, (std::string requestType, std::string client, std::string request), ());
 	MOCK_METHOD(std::string, connectNewNode, (boost::shared_ptr<TcpConnection> connection, std::string request), ());
 	MOCK_METHOD(std::vector<std::string>, getCurrentIPs, (), ());
 };
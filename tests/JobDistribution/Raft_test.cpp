@@ -11,9 +11,11 @@ Utrecht University within the Software Project course.
 #include "RequestHandler.h"
 #include "RequestHandlerMock.cpp"
 #include "ConnectionHandler.h"
+#include "HTTPStatus.h"
 #include "ConnectionMock.cpp"
 #include "JDDatabaseMock.cpp"
 #include "DatabaseMock.cpp"
+#include "StatisticsMock.cpp"
 
 #include <gtest/gtest.h>
 
@@ -105,6 +107,228 @@ TEST(RaftTests, GetCurrentIPs)
 	delete connMock;
 }
 
+// Test if a node which is slow to receive heartbeats does not hold up the other nodes, and is dropped eventually.
+TEST(RaftTests, SlowNodeDoesNotBlockHeartbeats)
+{
+	// Set up the test.
+	errno = 0;
+
+	boost::asio::io_context ioCon;
+	MockDatabase database;
+	MockJDDatabase jddatabase;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, nullptr, nullptr);
+
+	// The mocks are shared with the heartbeat threads, which may still be sending when the test ends.
+	TcpConnectionMock *slowMock = new TcpConnectionMock(ioCon);
+	TcpConnectionMock *fastMock = new TcpConnectionMock(ioCon);
+	testing::Mock::AllowLeak(slowMock);
+	testing::Mock::AllowLeak(fastMock);
+	std::atomic<int> fastSends(0);
+	EXPECT_CALL(*slowMock, sendData(testing::_, testing::_))
+		.WillRepeatedly(testing::Invoke([](const std::string &data, boost::system::error_code &error)
+										{ usleep(5000000); }));
+	EXPECT_CALL(*fastMock, sendData(testing::_, testing::_))
+		.WillRepeatedly(testing::Invoke([&fastSends](const std::string &data, boost::system::error_code &error)
+										{ fastSends++; }));
+	{
+		RAFTConsensus raft(nullptr);
+		raft.start(&handler, {}, true);
+
+		raft.connectNewNode(TcpConnection::pointer(slowMock), "127.0.0.2" + fieldDelimiter + "-1" + entryDelimiter);
+		raft.connectNewNode(TcpConnection::pointer(fastMock), "127.0.0.3" + fieldDelimiter + "-1" + entryDelimiter);
+
+		usleep(3 * HEARTBEAT_TIME + HEARTBEAT_TIME / 2);
+		EXPECT_GE(fastSends, 3);
+
+		// Connecting a new node should not have to wait for the slow node.
+		long long before = Utility::getCurrentTimeMilliSeconds();
+		TcpConnectionMock *newMock = new TcpConnectionMock(ioCon);
+		testing::Mock::AllowLeak(newMock);
+		raft.connectNewNode(TcpConnection::pointer(newMock), "127.0.0.4" + fieldDelimiter + "-1" + entryDelimiter);
+		EXPECT_LT(Utility::getCurrentTimeMilliSeconds() - before, HEARTBEAT_TIME / 1000);
+
+		// The slow node passes its send deadline in the next heartbeat.
+		usleep(HEARTBEAT_TIME);
+		std::vector<std::string> ips = raft.getCurrentIPs();
+		std::sort(ips.begin(), ips.end());
+		std::vector<std::string> expectedOutput = {"127.0.0.3" + fieldDelimiter + "-1",
+												   "127.0.0.4" + fieldDelimiter + "-1", "?"};
+		EXPECT_EQ(ips, expectedOutput);
+	}
+}
+
+// Test if a node which does not acknowledge heartbeats is dropped.
+TEST(RaftTests, DropNodeWithoutAcks)
+{
+	// Set up the test.
+	errno = 0;
+
+	boost::asio::io_context ioCon;
+	MockDatabase database;
+	MockJDDatabase jddatabase;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, nullptr, nullptr);
+
+	TcpConnectionMock *connMock = new TcpConnectionMock(ioCon);
+	testing::Mock::AllowLeak(connMock);
+	EXPECT_CALL(*connMock, sendData(testing::_, testing::_)).Times(testing::AtLeast(1));
+	{
+		RAFTConsensus raft(nullptr);
+		raft.start(&handler, {}, true);
+
+		raft.connectNewNode(TcpConnection::pointer(connMock), "127.0.0.2" + fieldDelimiter + "-1" + entryDelimiter);
+		ASSERT_EQ(raft.getCurrentIPs().size(), 2);
+
+		usleep(HEARTBEAT_ACK_TIMEOUT + 2 * HEARTBEAT_TIME);
+
+		std::vector<std::string> expectedOutput = {"?"};
+		EXPECT_EQ(raft.getCurrentIPs(), expectedOutput);
+	}
+}
+
+// Test if votes are only granted to one candidate per term.
+TEST(RaftTests, HandleVoteRequest)
+{
+	// Set up the test.
+	errno = 0;
+
+	RAFTConsensus raft(nullptr);
+	std::string candidateA = "127.0.0.1" + fieldDelimiter + "5000" + entryDelimiter;
+	std::string candidateB = "127.0.0.1" + fieldDelimiter + "5001" + entryDelimiter;
+
+	EXPECT_EQ(raft.handleVoteRequest("1" + fieldDelimiter + candidateA), "ok" + fieldDelimiter + "1" + entryDelimiter);
+	EXPECT_EQ(raft.handleVoteRequest("1" + fieldDelimiter + candidateB), "no" + fieldDelimiter + "1" + entryDelimiter);
+	EXPECT_EQ(raft.handleVoteRequest("1" + fieldDelimiter + candidateA), "ok" + fieldDelimiter + "1" + entryDelimiter);
+	EXPECT_EQ(raft.handleVoteRequest("0" + fieldDelimiter + candidateB), "no" + fieldDelimiter + "1" + entryDelimiter);
+	EXPECT_EQ(raft.handleVoteRequest("2" + fieldDelimiter + candidateB), "ok" + fieldDelimiter + "2" + entryDelimiter);
+	EXPECT_EQ(raft.handleVoteRequest("abc" + entryDelimiter), "no" + fieldDelimiter + "2" + entryDelimiter);
+	EXPECT_EQ(raft.getTerm(), 2);
+}
+
+/// <summary>
+/// A node of a network running inside the test, listening on its own local port.
+/// </summary>
+class TestNode
+{
+public:
+	TestNode(int port) : port(port), raft(&stats), server(ioContext, &database, &jddatabase, &raft, &handler, port, &stats)
+	{
+		thread = std::thread([this]() { ioContext.run(); });
+	}
+
+	~TestNode()
+	{
+		ioContext.stop();
+		thread.join();
+	}
+
+	int port;
+	MockDatabase database;
+	MockJDDatabase jddatabase;
+	MockStatistics stats;
+	RequestHandler handler;
+	RAFTConsensus raft;
+	boost::asio::io_context ioContext;
+	TcpServer server;
+	std::thread thread;
+};
+
+// Test if the remaining nodes elect a new leader when the leader drops out.
+TEST(RaftTests, ElectNewLeader)
+{
+	// Set up the test.
+	errno = 0;
+
+	std::vector<std::unique_ptr<TestNode>> nodes;
+	for (int port : {28103, 28104, 28105})
+	{
+		nodes.push_back(std::make_unique<TestNode>(port));
+	}
+	nodes[0]->raft.start(&nodes[0]->handler, {}, true, nodes[0]->port);
+	nodes[1]->raft.start(&nodes[1]->handler, {{TEST_IP, "28103"}}, false, nodes[1]->port);
+	nodes[2]->raft.start(&nodes[2]->handler, {{TEST_IP, "28103"}}, false, nodes[2]->port);
+
+	ASSERT_TRUE(nodes[0]->raft.isLeader());
+	ASSERT_FALSE(nodes[1]->raft.isLeader());
+	ASSERT_FALSE(nodes[2]->raft.isLeader());
+
+	// Let the followers learn about each other through the heartbeat, then let the leader drop out.
+	usleep(3 * HEARTBEAT_TIME);
+	nodes.erase(nodes.begin());
+
+	long long deadline = Utility::getCurrentTimeMilliSeconds() + 5000;
+	while (Utility::getCurrentTimeMilliSeconds() < deadline &&
+		   (nodes[0]->raft.isLeader() == nodes[1]->raft.isLeader() ||
+			nodes[0]->raft.getTerm() != nodes[1]->raft.getTerm() ||
+			(nodes[0]->raft.isLeader() ? nodes[0] : nodes[1])->raft.getCurrentIPs().size() != 2))
+	{
+		usleep(HEARTBEAT_TIME / 2);
+	}
+
+	TestNode *leader = nodes[0]->raft.isLeader() ? nodes[0].get() : nodes[1].get();
+	TestNode *follower = nodes[0]->raft.isLeader() ? nodes[1].get() : nodes[0].get();
+	ASSERT_TRUE(leader->raft.isLeader());
+	ASSERT_FALSE(follower->raft.isLeader());
+	EXPECT_GE(leader->raft.getTerm(), 1);
+	EXPECT_EQ(follower->raft.getTerm(), leader->raft.getTerm());
+
+	std::vector<std::string> ips = leader->raft.getCurrentIPs();
+	EXPECT_EQ(ips[0], TEST_IP + fieldDelimiter + std::to_string(follower->port));
+
+	double failover = leader->stats.failoverDuration->Add({{"Node", ""}}).Value();
+	EXPECT_GT(failover, 0);
+	EXPECT_LT(failover, 3000);
+
+	// Stop the follower first, so it does not start looking for a new leader.
+	nodes.erase(nodes.begin() + (follower == nodes[0].get() ? 0 : 1));
+}
+
+// Test if a leader keeps its role in its own term, but steps down for a candidate in a newer term.
+TEST(RaftTests, LeaderStepsDownOnNewerTerm)
+{
+	// Set up the test.
+	errno = 0;
+
+	TestNode leader(28108);
+	leader.raft.start(&leader.handler, {}, true, leader.port);
+	ASSERT_TRUE(leader.raft.isLeader());
+
+	std::string candidate = "127.0.0.1" + fieldDelimiter + "28109" + entryDelimiter;
+	EXPECT_EQ(leader.raft.handleVoteRequest("0" + fieldDelimiter + candidate),
+			  "no" + fieldDelimiter + "0" + fieldDelimiter + fieldDelimiter + entryDelimiter);
+	EXPECT_TRUE(leader.raft.isLeader());
+
+	EXPECT_EQ(leader.raft.handleVoteRequest("5" + fieldDelimiter + candidate), "ok" + fieldDelimiter + "5" + entryDelimiter);
+	EXPECT_FALSE(leader.raft.isLeader());
+	EXPECT_GE(leader.raft.getTerm(), 5);
+}
+
+// Test if a follower which recently heard from the leader answers a gtip request itself.
+TEST(RaftTests, FollowerServesIPs)
+{
+	// Set up the test.
+	errno = 0;
+
+	TestNode leader(28106);
+	TestNode follower(28107);
+	leader.raft.start(&leader.handler, {}, true, leader.port);
+	follower.raft.start(&follower.handler, {{TEST_IP, "28106"}}, false, follower.port);
+	ASSERT_FALSE(follower.raft.isLeader());
+
+	usleep(3 * HEARTBEAT_TIME);
+	EXPECT_FALSE(leader.raft.isUpToDate());
+	EXPECT_TRUE(follower.raft.isUpToDate());
+
+	std::vector<std::string> ips = follower.raft.getCurrentIPs();
+	ASSERT_EQ(ips.size(), 2);
+	EXPECT_EQ(ips[0], TEST_IP + fieldDelimiter + "28107");
+	EXPECT_EQ(ips[1], TEST_IP + fieldDelimiter + "28106");
+
+	std::string result = follower.handler.handleRequest("gtip", "", "", nullptr);
+	EXPECT_EQ(result, HTTPStatusCodes::success(ips[0] + entryDelimiter + ips[1] + entryDelimiter));
+}
+
 // Test if we can read the ips from a file.
 TEST(RaftTests, ReadIpsFromFile) 
 {
@@ -104,4 +104,245 @@ TEST(UpdateJobRequest, IncorrectJob)
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
 
 	ASSERT_EQ(result, HTTPStatusCodes::clientError("Job not currently expected."));
-}
\ No newline at end of file
+}
+// Test if a job received from the old leader can be updated without asking the database for its time.
+TEST(UpdateJobRequest, ReplicatedJob)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+
+	Job job;
+	job.jobid = "5d514d6e-2f23-fee7-b378-feda84ec123f";
+	job.time = Utility::getCurrentTimeMilliSeconds();
+	job.timeout = 100000;
+	job.priority = 100;
+	job.retries = 0;
+	job.url = "https://github.com/zavg/linux-0.01";
+
+	// Receive the state of the job queue from the old leader and take over.
+	handler.getJobRequestHandler()->applyJobChanges(
+		{"J", "42", "-1", "H", job.jobid, std::to_string(job.time), std::to_string(job.timeout)});
+	handler.getJobRequestHandler()->takeOverJobs();
+	EXPECT_EQ(jddatabase.getCachedNumberOfJobs(), 42);
+
+	std::string requestType = "udjb";
+	std::string request = job.jobid + fieldDelimiter + std::to_string(job.time);
+
+	EXPECT_CALL(jddatabase, getCurrentJobTime(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, getCurrentJob(job.jobid)).WillOnce(testing::Return(job));
+	EXPECT_CALL(raftConsensus, isLeader()).WillOnce(testing::Return(true));
+	EXPECT_CALL(jddatabase, addCurrentJob(jobEqual(job))).WillOnce(testing::Return(job.time + 5));
+
+	std::string result = handler.handleRequest(requestType, "", request, nullptr);
+
+	ASSERT_EQ(result, HTTPStatusCodes::success(std::to_string(job.time + 5)));
+
+	// The new time should be passed on to the other nodes.
+	EXPECT_EQ(handler.getJobRequestHandler()->takeJobChanges(),
+			  "J" + fieldDelimiter + "42" + fieldDelimiter + "-1" + fieldDelimiter + "H" + fieldDelimiter + job.jobid +
+				  fieldDelimiter + std::to_string(job.time + 5) + fieldDelimiter + std::to_string(job.timeout));
+}
+
+// Test if a node which joins late gets the full job state, replacing what it knew before.
+TEST(UpdateJobRequest, ReplicateSnapshot)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler leader;
+	RequestHandler follower;
+	leader.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+	follower.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::string time = std::to_string(Utility::getCurrentTimeMilliSeconds());
+	std::string jobA = "5d514d6e-2f23-fee7-b378-feda84ec123f";
+	std::string jobB = "6e514d6e-2f23-fee7-b378-feda84ec123f";
+
+	leader.getJobRequestHandler()->applyJobChanges({"J", "0", "-1", "H", jobA, time, "100000"});
+	follower.getJobRequestHandler()->applyJobChanges({"J", "0", "-1", "H", jobB, time, "100000"});
+
+	std::string snapshot;
+	std::string changes = leader.getJobRequestHandler()->takeJobChanges(&snapshot);
+	EXPECT_EQ(changes, "J" + fieldDelimiter + "0" + fieldDelimiter + "-1");
+	std::string expected = "J" + fieldDelimiter + "0" + fieldDelimiter + "-1" + fieldDelimiter + "S" + fieldDelimiter +
+						   "H" + fieldDelimiter + jobA + fieldDelimiter + time + fieldDelimiter + "100000";
+	EXPECT_EQ(snapshot, expected);
+
+	// The job the follower knew of has been finished in the meantime.
+	follower.getJobRequestHandler()->applyJobChanges(Utility::splitStringOn(snapshot, FIELD_DELIMITER_CHAR));
+	std::string replicated;
+	follower.getJobRequestHandler()->takeJobChanges(&replicated);
+	EXPECT_EQ(replicated, expected);
+}
+
+// Test if a job handed out by this node is renewed in memory and written to the database later.
+TEST(UpdateJobRequest, RenewInMemory)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+
+	Job job;
+	job.jobid = "5d514d6e-2f23-fee7-b378-feda84ec123f";
+	job.time = Utility::getCurrentTimeMilliSeconds();
+	job.timeout = 100000;
+	job.priority = 100;
+	job.retries = 0;
+	job.url = "https://github.com/zavg/linux-0.01";
+
+	// Hand out the job.
+	EXPECT_CALL(raftConsensus, isLeader()).WillRepeatedly(testing::Return(true));
+	EXPECT_CALL(jddatabase, getNumberOfJobs()).WillRepeatedly(testing::Return(550));
+	EXPECT_CALL(jddatabase, getTopJob()).WillOnce(testing::Return(job));
+	handler.handleRequest("gtjb", "", "", nullptr);
+
+	// Renew the job, without going to the database.
+	EXPECT_CALL(jddatabase, getCurrentJobTime(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, getCurrentJob(testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, addCurrentJob(testing::_)).Times(0);
+	std::string result =
+		handler.handleRequest("udjb", "", job.jobid + fieldDelimiter + std::to_string(job.time), nullptr);
+	long long newTime = Utility::safeStoll(result.substr(result.find(ENTRY_DELIMITER_CHAR) + 1));
+	ASSERT_EQ(result, HTTPStatusCodes::success(std::to_string(newTime)));
+	EXPECT_GE(newTime, job.time);
+
+	// The new time is written once, failed writes are tried again.
+	Job renewed = job;
+	renewed.time = newTime;
+	EXPECT_CALL(jddatabase, renewCurrentJobs(testing::ElementsAre(jobEqual(renewed))))
+		.WillOnce(testing::Return(std::vector<int>({0})))
+		.WillOnce(testing::Return(std::vector<int>()));
+	handler.getJobRequestHandler()->writeCurrentJobs();
+	handler.getJobRequestHandler()->writeCurrentJobs();
+	handler.getJobRequestHandler()->writeCurrentJobs();
+}
+
+// Test if a job renewed in memory is written before the timeouts are checked, and never timed out by the check.
+TEST(UpdateJobRequest, RenewThenSweep)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+
+	Job job;
+	job.jobid = "5d514d6e-2f23-fee7-b378-feda84ec123f";
+	job.time = Utility::getCurrentTimeMilliSeconds();
+	job.timeout = 100000;
+	job.priority = 100;
+	job.retries = 0;
+	job.url = "https://github.com/zavg/linux-0.01";
+
+	// Hand out the job and renew it in memory.
+	EXPECT_CALL(raftConsensus, isLeader()).WillRepeatedly(testing::Return(true));
+	EXPECT_CALL(jddatabase, getNumberOfJobs()).WillRepeatedly(testing::Return(550));
+	EXPECT_CALL(jddatabase, getTopJob()).WillOnce(testing::Return(job));
+	handler.handleRequest("gtjb", "", "", nullptr);
+	handler.handleRequest("udjb", "", job.jobid + fieldDelimiter + std::to_string(job.time), nullptr);
+
+	// The renewal can not be written, so the check has to leave the job alone.
+	testing::InSequence sequence;
+	EXPECT_CALL(jddatabase, renewCurrentJobs(testing::_)).WillOnce(testing::Return(std::vector<int>({0})));
+	EXPECT_CALL(jddatabase, getTimedOutJobs(testing::ElementsAre(job.jobid))).WillOnce(testing::Return(std::vector<Job>()));
+	handler.getJobRequestHandler()->updateCurrentJobs();
+}
+
+// Test if a job which timed out is removed from the other nodes as well.
+TEST(UpdateJobRequest, ReplicateTimeout)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler leader;
+	RequestHandler follower;
+	leader.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+	follower.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::string time = std::to_string(Utility::getCurrentTimeMilliSeconds() - 1000);
+	std::string jobid = "5d514d6e-2f23-fee7-b378-feda84ec123f";
+
+	leader.getJobRequestHandler()->applyJobChanges({"J", "0", "-1", "H", jobid, time, "1"});
+	follower.getJobRequestHandler()->applyJobChanges({"J", "0", "-1", "H", jobid, time, "1"});
+
+	std::string changes = leader.getJobRequestHandler()->takeJobChanges();
+	EXPECT_EQ(changes, "J" + fieldDelimiter + "0" + fieldDelimiter + "-1" + fieldDelimiter + "D" + fieldDelimiter + jobid);
+
+	// The follower forgets the job when it receives the changes.
+	follower.getJobRequestHandler()->applyJobChanges(Utility::splitStringOn(changes, FIELD_DELIMITER_CHAR));
+	std::string snapshot;
+	follower.getJobRequestHandler()->takeJobChanges(&snapshot);
+	EXPECT_EQ(snapshot, "J" + fieldDelimiter + "0" + fieldDelimiter + "-1" + fieldDelimiter + "S");
+}
+
+// Test if the jobs which timed out are moved to the failed jobs, trying again for the writes which fail.
+TEST(UpdateJobRequest, TimeoutWritesRetried)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	Job retried("5d514d6e-2f23-fee7-b378-feda84ec123f", 100000, 100, "https://github.com/zavg/linux-0.01", 0);
+	Job dropped("6e514d6e-2f23-fee7-b378-feda84ec123f", 100000, 100, "https://github.com/nlohmann/json",
+				MAX_JOB_RETRIES);
+	retried.time = 0;
+	dropped.time = 0;
+	jddatabase.getUrlIndex()->insert(retried.url);
+	jddatabase.getUrlIndex()->insert(dropped.url);
+	Job requeued = retried;
+	requeued.retries++;
+
+	EXPECT_CALL(jddatabase, getTimedOutJobs(testing::IsEmpty()))
+		.WillOnce(testing::Return(std::vector<Job>({retried, dropped})));
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::SizeIs(2)))
+		.WillOnce(testing::Return(std::vector<int>({1})));
+	EXPECT_CALL(jddatabase, deleteCurrentJobs(testing::ElementsAre(retried.jobid, dropped.jobid)))
+		.WillOnce(testing::Return(std::vector<int>({0})));
+	EXPECT_CALL(jddatabase, uploadJobs(testing::ElementsAre(jobEqual(requeued)), false))
+		.WillOnce(testing::Return(std::vector<int>()));
+	handler.getJobRequestHandler()->updateCurrentJobs();
+
+	// The url of the job which is not tried again is forgotten.
+	EXPECT_TRUE(jddatabase.getUrlIndex()->contains(retried.url));
+	EXPECT_FALSE(jddatabase.getUrlIndex()->contains(dropped.url));
+
+	// Only the writes which failed are done again.
+	EXPECT_CALL(jddatabase, addFailedJobs(testing::SizeIs(1))).WillOnce(testing::Return(std::vector<int>()));
+	EXPECT_CALL(jddatabase, deleteCurrentJobs(testing::ElementsAre(retried.jobid)))
+		.WillOnce(testing::Return(std::vector<int>()));
+	handler.getJobRequestHandler()->writeFinishedJobs();
+	handler.getJobRequestHandler()->writeFinishedJobs();
+}
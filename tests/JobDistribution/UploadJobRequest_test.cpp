@@ -38,7 +38,7 @@ TEST(UploadJobRequest, SingleJob)
 
 	Job job("", 69, 1, "https://github.com/zavg/linux-0.01", 0);
 
-	EXPECT_CALL(jddatabase, uploadJob(jobequal(job), true)).Times(1);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::ElementsAre(jobequal(job)), false)).Times(1);
 	EXPECT_CALL(raftConsensus, isLeader()).WillOnce(testing::Return(true));
 
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
@@ -68,9 +68,8 @@ TEST(UploadJobRequest, MultipleJobs)
 	Job job1("", 69, 1, "https://github.com/zavg/linux-0.01", 0);
 	Job job2("", 42, 2, "https://github.com/nlohmann/json/issues/1573", 0);
 
-	EXPECT_CALL(jddatabase, uploadJob(jobequal(job1), true)).Times(1);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::ElementsAre(jobequal(job1), jobequal(job2)), false)).Times(1);
 	EXPECT_CALL(raftConsensus, isLeader()).WillOnce(testing::Return(true));
-	EXPECT_CALL(jddatabase, uploadJob(jobequal(job2), true)).Times(1);
 
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
 	ASSERT_EQ(result, HTTPStatusCodes::success("Your job(s) has been succesfully added to the queue."));
@@ -94,7 +93,7 @@ TEST(UploadJobRequest, OneJobInvalidPriority)
 	std::string requestType = "upjb";
 	std::string request = "https://github.com/zavg/linux-0.01" + fieldDelimiter + "aaaaa" + fieldDelimiter + "69";
 
-	EXPECT_CALL(jddatabase, uploadJob(testing::_, testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, testing::_)).Times(0);
 	EXPECT_CALL(raftConsensus, isLeader()).WillOnce(testing::Return(true));
 
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
@@ -121,10 +120,197 @@ TEST(UploadJobRequest, MultipleJobsInvalidPriority)
 	std::string request = "https://github.com/zavg/linux-0.01" + fieldDelimiter + "1" + fieldDelimiter + "69" + entryDelimiter +
 						  "https://github.com/nlohmann/json/issues/1573" + fieldDelimiter + "aaaa" + fieldDelimiter + "42";
 
-	EXPECT_CALL(jddatabase, uploadJob(testing::_, testing::_)).Times(0);
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, testing::_)).Times(0);
 	EXPECT_CALL(raftConsensus, isLeader()).WillOnce(testing::Return(true));
 
 	std::string result = handler.handleRequest(requestType, "", request, nullptr);
 	ASSERT_EQ(result,
 			  HTTPStatusCodes::clientError("A job has an invalid priority, no jobs have been added to the queue."));
 }
+
+// Test if only the jobs which could not be added are retried, and reported when they keep failing.
+TEST(UploadJobRequest, JobFailure)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+
+	std::string requestType = "upjb";
+	std::string request = "https://github.com/zavg/linux-0.01" + fieldDelimiter + "1" + fieldDelimiter + "69" + entryDelimiter +
+						  "https://github.com/nlohmann/json/issues/1573" + fieldDelimiter + "2" + fieldDelimiter + "42";
+
+	Job job1("5d514d6e-2f23-fee7-b378-feda84ec123f", 69, 1, "https://github.com/zavg/linux-0.01", 0);
+	Job job2("6e514d6e-2f23-fee7-b378-feda84ec123f", 42, 2, "https://github.com/nlohmann/json/issues/1573", 0);
+
+	// The jobids are given out once, so the retries write the same jobs.
+	EXPECT_CALL(raftConsensus, isLeader()).WillOnce(testing::Return(true));
+	EXPECT_CALL(jddatabase, prepareNewJobs(testing::_))
+		.WillOnce(testing::SetArgReferee<0>(std::vector<Job>({job1, job2})));
+	EXPECT_CALL(jddatabase, uploadJobs(testing::ElementsAre(jobequal(job1), jobequal(job2)), false))
+		.WillOnce(testing::DoAll(testing::Assign(&errno, ENETUNREACH), testing::Return(std::vector<int>({1}))));
+	EXPECT_CALL(jddatabase, uploadJobs(testing::ElementsAre(jobequal(job2)), false))
+		.Times(MAX_RETRIES)
+		.WillRepeatedly(testing::DoAll(testing::Assign(&errno, ENETUNREACH), testing::Return(std::vector<int>({0}))));
+
+	std::string result = handler.handleRequest(requestType, "", request, nullptr);
+	ASSERT_EQ(result, HTTPStatusCodes::serverError("Unable to add job(s) 1 to database."));
+}
+
+// Test if jobs with a url which is already in the queue are skipped.
+TEST(UploadJobRequest, DuplicateJobs)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+
+	std::string requestType = "upjb";
+	std::string job1Line = "https://github.com/zavg/linux-0.01" + fieldDelimiter + "1" + fieldDelimiter + "69";
+	std::string job2Line = "https://github.com/nlohmann/json/issues/1573" + fieldDelimiter + "2" + fieldDelimiter + "42";
+
+	Job job1("", 69, 1, "https://github.com/zavg/linux-0.01", 0);
+	Job job2("", 42, 2, "https://github.com/nlohmann/json/issues/1573", 0);
+
+	// The same url twice in a single request is only added once.
+	EXPECT_CALL(raftConsensus, isLeader()).WillRepeatedly(testing::Return(true));
+	EXPECT_CALL(jddatabase, uploadJobs(testing::ElementsAre(jobequal(job1)), false)).Times(1);
+	std::string result = handler.handleRequest(requestType, "", job1Line + entryDelimiter + job1Line, nullptr);
+	ASSERT_EQ(result, HTTPStatusCodes::success("Your job(s) has been succesfully added to the queue."));
+
+	// A url which is already in the queue is not added again.
+	EXPECT_CALL(jddatabase, uploadJobs(testing::ElementsAre(jobequal(job2)), false)).Times(1);
+	result = handler.handleRequest(requestType, "", job2Line + entryDelimiter + job1Line, nullptr);
+	ASSERT_EQ(result, HTTPStatusCodes::success("Your job(s) has been succesfully added to the queue."));
+	EXPECT_TRUE(jddatabase.getUrlIndex()->contains(job1.url));
+	EXPECT_TRUE(jddatabase.getUrlIndex()->contains(job2.url));
+}
+
+// Test if the urls in the queue are added to the index page by page after becoming the leader.
+TEST(UploadJobRequest, LoadQueuedUrls)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	std::vector<std::string> firstPage = {"https://github.com/zavg/linux-0.01"};
+	std::vector<std::string> lastPage = {"https://github.com/nlohmann/json"};
+	std::vector<std::string> currentJobs = {"https://github.com/torvalds/linux"};
+
+	testing::InSequence sequence;
+	EXPECT_CALL(jddatabase, loadQueueHeads()).Times(1);
+	EXPECT_CALL(jddatabase, getQueuedUrls(false, testing::Eq("")))
+		.WillOnce(testing::DoAll(testing::SetArgReferee<1>("next"), testing::Return(firstPage)));
+	EXPECT_CALL(jddatabase, getQueuedUrls(false, testing::Eq("next")))
+		.WillOnce(testing::DoAll(testing::SetArgReferee<1>(""), testing::Return(lastPage)));
+	EXPECT_CALL(jddatabase, getQueuedUrls(true, testing::Eq(""))).WillOnce(testing::Return(currentJobs));
+
+	handler.getJobRequestHandler()->loadQueueState();
+
+	EXPECT_EQ(jddatabase.getUrlIndex()->size(), 3);
+	EXPECT_TRUE(jddatabase.getUrlIndex()->contains(firstPage[0]));
+	EXPECT_TRUE(jddatabase.getUrlIndex()->contains(lastPage[0]));
+	EXPECT_TRUE(jddatabase.getUrlIndex()->contains(currentJobs[0]));
+}
+
+// Test if the urls of the leader are passed on to a follower, which keeps them when it becomes the leader.
+TEST(UploadJobRequest, ReplicateUrls)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase leaderDatabase;
+	MockJDDatabase followerDatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler leader;
+	RequestHandler follower;
+	leader.initialize(&database, &leaderDatabase, &raftConsensus, nullptr);
+	follower.initialize(&database, &followerDatabase, &raftConsensus, nullptr);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::string entryDelimiter(1, ENTRY_DELIMITER_CHAR);
+
+	std::string requestType = "upjb";
+	std::string url1 = "https://github.com/zavg/linux-0.01";
+	std::string url2 = "https://github.com/nlohmann/json";
+	Job job2("", 69, 1, url2, 0);
+
+	EXPECT_CALL(raftConsensus, isLeader()).WillRepeatedly(testing::Return(true));
+	EXPECT_CALL(leaderDatabase, uploadJobs(testing::_, false)).Times(2);
+	leader.handleRequest(requestType, "", url1 + fieldDelimiter + "1" + fieldDelimiter + "69", nullptr);
+	leader.handleRequest(requestType, "", url2 + fieldDelimiter + "1" + fieldDelimiter + "69", nullptr);
+	leaderDatabase.getUrlIndex()->remove(url2);
+
+	std::string changes = leader.getJobRequestHandler()->takeJobChanges();
+	EXPECT_EQ(changes, "J" + fieldDelimiter + "0" + fieldDelimiter + "-1" + fieldDelimiter + "U" + fieldDelimiter +
+						   url1 + fieldDelimiter + "U" + fieldDelimiter + url2 + fieldDelimiter + "F" +
+						   fieldDelimiter + url2);
+	follower.getJobRequestHandler()->applyJobChanges(Utility::splitStringOn(changes, FIELD_DELIMITER_CHAR));
+
+	// The urls are not retrieved from the database again after taking over.
+	EXPECT_CALL(followerDatabase, getQueuedUrls(testing::_, testing::_)).Times(0);
+	follower.getJobRequestHandler()->takeOverJobs();
+	EXPECT_TRUE(followerDatabase.getUrlIndex()->contains(url1));
+	EXPECT_FALSE(followerDatabase.getUrlIndex()->contains(url2));
+
+	// Only the url which was not known yet is added, the changes received are not passed on again.
+	EXPECT_CALL(followerDatabase, uploadJobs(testing::ElementsAre(jobequal(job2)), false)).Times(1);
+	follower.handleRequest(requestType, "",
+						   url1 + fieldDelimiter + "1" + fieldDelimiter + "69" + entryDelimiter + url2 +
+							   fieldDelimiter + "1" + fieldDelimiter + "69",
+						   nullptr);
+	EXPECT_EQ(follower.getJobRequestHandler()->takeJobChanges(),
+			  "J" + fieldDelimiter + "0" + fieldDelimiter + "-1" + fieldDelimiter + "U" + fieldDelimiter + url2);
+}
+
+// Test if jobs are refused while the urls in the queue are retrieved, as duplicates could not be recognised yet.
+TEST(UploadJobRequest, RefuseWhileLoading)
+{
+	// Set up the test.
+	errno = 0;
+
+	MockJDDatabase jddatabase;
+	MockDatabase database;
+	MockRaftConsensus raftConsensus;
+	RequestHandler handler;
+	handler.initialize(&database, &jddatabase, &raftConsensus, nullptr);
+
+	std::string fieldDelimiter(1, FIELD_DELIMITER_CHAR);
+	std::string requestType = "upjb";
+	std::string url = "https://github.com/zavg/linux-0.01";
+	std::string request = url + fieldDelimiter + "1" + fieldDelimiter + "69";
+
+	EXPECT_CALL(raftConsensus, isLeader()).WillRepeatedly(testing::Return(true));
+	ASSERT_TRUE(jddatabase.getUrlIndex()->startLoading());
+	EXPECT_CALL(jddatabase, uploadJobs(testing::_, false)).Times(0);
+	std::string result = handler.handleRequest(requestType, "", request, nullptr);
+	ASSERT_EQ(result, HTTPStatusCodes::tooManyRequests("The jobs in the queue are being retrieved, try again later.",
+													   URL_LOADING_RETRY_AFTER));
+	EXPECT_FALSE(jddatabase.getUrlIndex()->contains(url));
+
+	// Once the urls in the queue are known, the jobs are accepted.
+	jddatabase.getUrlIndex()->finishLoading();
+	EXPECT_CALL(jddatabase, uploadJobs(testing::SizeIs(1), false)).Times(1);
+	result = handler.handleRequest(requestType, "", request, nullptr);
+	ASSERT_EQ(result, HTTPStatusCodes::success("Your job(s) has been succesfully added to the queue."));
+}
@@ -0,0 +1,99 @@
+/*
+This program has been developed by students from the bachelor Computer Science at
+Utrecht University within the Software Project course.
+© Copyright Utrecht University (Department of Information and Computing Sciences)
+*/
+
+#include "UrlIndex.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+// Test if a url can only be added once, and again after it was removed.
+TEST(UrlIndexTests, InsertAndRemove)
+{
+	UrlIndex index;
+	std::string url = "https://github.com/zavg/linux-0.01";
+
+	EXPECT_FALSE(index.contains(url));
+	EXPECT_TRUE(index.insert(url));
+	EXPECT_TRUE(index.contains(url));
+	EXPECT_FALSE(index.insert(url));
+	EXPECT_EQ(index.size(), 1);
+
+	index.remove(url);
+	EXPECT_FALSE(index.contains(url));
+	EXPECT_TRUE(index.insert(url));
+}
+
+// Test if no url is lost when many urls are added and removed.
+TEST(UrlIndexTests, ManyUrls)
+{
+	UrlIndex index;
+	int amount = 200000;
+	for (int i = 0; i < amount; i++)
+	{
+		ASSERT_TRUE(index.insert("https://github.com/user/repo" + std::to_string(i)));
+	}
+	for (int i = 0; i < amount; i += 2)
+	{
+		index.remove("https://github.com/user/repo" + std::to_string(i));
+	}
+	index.addAll({"https://github.com/user/repo0", "https://github.com/user/other"});
+
+	EXPECT_EQ(index.size(), amount / 2 + 2);
+	for (int i = 0; i < amount; i++)
+	{
+		ASSERT_EQ(index.contains("https://github.com/user/repo" + std::to_string(i)), i % 2 == 1 || i == 0);
+	}
+	EXPECT_TRUE(index.contains("https://github.com/user/other"));
+
+	index.clear();
+	EXPECT_EQ(index.size(), 0);
+	EXPECT_FALSE(index.contains("https://github.com/user/other"));
+}
+
+// Test if a url removed while the urls are retrieved from the database is not added again by an older page.
+TEST(UrlIndexTests, RemoveWhileLoading)
+{
+	UrlIndex index;
+	std::string url = "https://github.com/zavg/linux-0.01";
+
+	EXPECT_TRUE(index.startLoading());
+	EXPECT_TRUE(index.isLoading());
+	index.remove(url, false);
+	index.addAll({url, "https://github.com/user/other"});
+	EXPECT_FALSE(index.contains(url));
+	EXPECT_TRUE(index.contains("https://github.com/user/other"));
+
+	// A url added again after being removed is kept.
+	index.insert(url, false);
+	index.addAll({url});
+	EXPECT_TRUE(index.contains(url));
+
+	index.finishLoading();
+	EXPECT_FALSE(index.isLoading());
+	EXPECT_FALSE(index.startLoading());
+	EXPECT_EQ(index.takeChanges(), "");
+}
+
+// Test if urls can be added and removed many times over, reusing the slots of removed urls.
+TEST(UrlIndexTests, ReuseRemovedSlots)
+{
+	UrlIndex index;
+	for (int round = 0; round < 100; round++)
+	{
+		for (int i = 0; i < 1000; i++)
+		{
+			ASSERT_TRUE(index.insert("https://github.com/user/repo" + std::to_string(round * 1000 + i), false));
+		}
+		for (int i = 0; i < 1000; i++)
+		{
+			index.remove("https://github.com/user/repo" + std::to_string(round * 1000 + i), false);
+		}
+		ASSERT_EQ(index.size(), 0);
+	}
+	EXPECT_FALSE(index.contains("https://github.com/user/repo0"));
+	EXPECT_TRUE(index.insert("https://github.com/user/repo0"));
+	EXPECT_TRUE(index.contains("https://github.com/user/repo0"));
+}